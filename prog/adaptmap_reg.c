@@ -0,0 +1,125 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -  This software is distributed in the hope that it will be
+ -  useful, but with NO WARRANTY OF ANY KIND.
+ -  No author or distributor accepts responsibility to anyone for the
+ -  consequences of using this software, or for whether it serves any
+ -  particular purpose or works at all, unless he or she says so in
+ -  writing.  Everyone is granted permission to copy, modify and
+ -  redistribute this source code, for commercial or non-commercial
+ -  purposes, with the following restrictions: (1) the origin of this
+ -  source code must not be misrepresented; (2) modified versions must
+ -  be plainly marked as such; and (3) this notice may not be removed
+ -  or altered from any source or modified source distribution.
+ *====================================================================*/
+
+/*
+ *  adaptmap_reg.c
+ *
+ *    Tests application of the inverse background maps, both with
+ *    a constant value over each tile and with the map values
+ *    interpolated between tile centers.
+ */
+
+#include "allheaders.h"
+
+static const l_int32  SX = 10;
+static const l_int32  SY = 15;
+
+
+main(int    argc,
+     char **argv)
+{
+l_int32       w, h, wm, hm;
+PIX          *pixs, *pixt, *pixm, *pixmi, *pixd1, *pixd2;
+PIX          *pixmr, *pixmg, *pixmb, *pixmri, *pixmgi, *pixmbi;
+PIXA         *pixa;
+L_REGPARAMS  *rp;
+
+    if (regTestSetup(argc, argv, &rp))
+        return 1;
+
+        /* With a constant map, interpolation has no effect */
+    pixs = pixRead("w91frag.jpg");
+    pixGetDimensions(pixs, &w, &h, NULL);
+    wm = (w + SX - 1) / SX;
+    hm = (h + SY - 1) / SY;
+    pixm = pixCreate(wm, hm, 16);
+    pixSetAllArbitrary(pixm, 300);
+    pixd1 = pixApplyInvBackgroundGrayMap(pixs, pixm, SX, SY);
+    pixd2 = pixApplyInvBackgroundGrayMapInterp(pixs, pixm, SX, SY);
+    regTestComparePix(rp, pixd1, pixd2);  /* 0 */
+    pixDestroy(&pixm);
+    pixDestroy(&pixd1);
+    pixDestroy(&pixd2);
+
+        /* Normalize with a map made from the image */
+    pixa = pixaCreate(0);
+    pixSaveTiled(pixs, pixa, 1, 1, 20, 32);
+    pixGetBackgroundGrayMap(pixs, NULL, SX, SY, 60, 40, &pixm);
+    pixmi = pixGetInvBackgroundMap(pixm, 200, 2, 1);
+    pixd1 = pixApplyInvBackgroundGrayMap(pixs, pixmi, SX, SY);
+    pixd2 = pixApplyInvBackgroundGrayMapInterp(pixs, pixmi, SX, SY);
+    regTestWritePixAndCheck(rp, pixd2, IFF_PNG);  /* 1 */
+    pixSaveTiled(pixd1, pixa, 1, 0, 20, 32);
+    pixSaveTiled(pixd2, pixa, 1, 0, 20, 32);
+    pixDestroy(&pixs);
+    pixDestroy(&pixm);
+    pixDestroy(&pixmi);
+    pixDestroy(&pixd1);
+    pixDestroy(&pixd2);
+
+        /* Same two tests in color */
+    pixt = pixRead("wet-day.jpg");
+    pixs = pixScale(pixt, 0.5, 0.5);
+    pixDestroy(&pixt);
+    pixGetDimensions(pixs, &w, &h, NULL);
+    wm = (w + SX - 1) / SX;
+    hm = (h + SY - 1) / SY;
+    pixmr = pixCreate(wm, hm, 16);
+    pixmg = pixCreate(wm, hm, 16);
+    pixmb = pixCreate(wm, hm, 16);
+    pixSetAllArbitrary(pixmr, 280);
+    pixSetAllArbitrary(pixmg, 300);
+    pixSetAllArbitrary(pixmb, 320);
+    pixd1 = pixApplyInvBackgroundRGBMap(pixs, pixmr, pixmg, pixmb, SX, SY);
+    pixd2 = pixApplyInvBackgroundRGBMapInterp(pixs, pixmr, pixmg, pixmb,
+                                              SX, SY);
+    regTestComparePix(rp, pixd1, pixd2);  /* 2 */
+    pixDestroy(&pixmr);
+    pixDestroy(&pixmg);
+    pixDestroy(&pixmb);
+    pixDestroy(&pixd1);
+    pixDestroy(&pixd2);
+
+    pixSaveTiled(pixs, pixa, 1, 1, 20, 32);
+    pixGetBackgroundRGBMap(pixs, NULL, NULL, SX, SY, 60, 40,
+                           &pixmr, &pixmg, &pixmb);
+    pixmri = pixGetInvBackgroundMap(pixmr, 200, 2, 1);
+    pixmgi = pixGetInvBackgroundMap(pixmg, 200, 2, 1);
+    pixmbi = pixGetInvBackgroundMap(pixmb, 200, 2, 1);
+    pixd1 = pixApplyInvBackgroundRGBMap(pixs, pixmri, pixmgi, pixmbi, SX, SY);
+    pixd2 = pixApplyInvBackgroundRGBMapInterp(pixs, pixmri, pixmgi, pixmbi,
+                                              SX, SY);
+    regTestWritePixAndCheck(rp, pixd2, IFF_JFIF_JPEG);  /* 3 */
+    pixSaveTiled(pixd1, pixa, 1, 0, 20, 32);
+    pixSaveTiled(pixd2, pixa, 1, 0, 20, 32);
+    pixDestroy(&pixs);
+    pixDestroy(&pixmr);
+    pixDestroy(&pixmg);
+    pixDestroy(&pixmb);
+    pixDestroy(&pixmri);
+    pixDestroy(&pixmgi);
+    pixDestroy(&pixmbi);
+    pixDestroy(&pixd1);
+    pixDestroy(&pixd2);
+
+    pixt = pixaDisplay(pixa, 0, 0);
+    pixDisplayWithTitle(pixt, 100, 100, NULL, rp->display);
+    pixDestroy(&pixt);
+    pixaDestroy(&pixa);
+
+    regTestCleanup(rp);
+    return 0;
+}
+
@@ -16,6 +16,9 @@
 /*
  * affine_reg.c
  *
+ *    Tests the affine transforms.  The transform by a composed matrix,
+ *    pixTransformByMatrix(), is compared with pixAffinePta() on gray
+ *    and color images.
  */
 
 #include "allheaders.h"
@@ -67,13 +70,13 @@ PIX         *pix, *pixs, *pixb, *pixg, *pixc, *pixcs;
 PIX         *pixd, *pixt1, *pixt2, *pixt3;
 PIXA        *pixa;
 PTA         *ptas, *ptad;
-static char  mainName[] = "affine_reg";
+L_REGPARAMS  *rp;
 
-    if (argc != 1)
-	exit(ERROR_INT(" Syntax:  affine_reg", mainName, 1));
+    if (regTestSetup(argc, argv, &rp))
+        return 1;
 
     if ((pixs = pixRead("feyn.tif")) == NULL)
-	exit(ERROR_INT("pixs not made", mainName, 1));
+	exit(ERROR_INT("pixs not made", rp->testname, 1));
 
 #if ALL
         /* Test invertability of sequential. */
@@ -339,6 +342,34 @@ static char  mainName[] = "affine_reg";
     lept_free(mat3i);
 #endif
 
+        /* Compare the transform by matrix with pixAffinePta(),
+         * on gray and color */
+    pixc = pixRead("test24.jpg");
+    pixg = pixConvertRGBToLuminance(pixc);
+    MakePtas(4, &ptas, &ptad);
+    getAffineXformCoeffs(ptas, ptad, &vc);
+    mat1 = createMatrix2dAffine(vc);
+    for (i = 0; i < 2; i++) {
+        pix = (i == 0) ? pixg : pixc;
+        pixt1 = pixAffinePta(pix, ptad, ptas, L_BRING_IN_WHITE);
+        regTestWritePixAndCheck(rp, pixt1, IFF_PNG);  /* 0, 3 */
+        pixt2 = pixTransformByMatrix(pix, mat1, 0, 0, L_INTERPOLATED,
+                                     L_BRING_IN_WHITE);
+        regTestWritePixAndCheck(rp, pixt2, IFF_PNG);  /* 1, 4 */
+        regTestCompareSimilarPix(rp, pixt1, pixt2, 15, 0.001, 0);  /* 2, 5 */
+        pixDisplayWithTitle(pixt2, 100, 100 + 300 * i, "transform by matrix",
+                            rp->display);
+        pixDestroy(&pixt1);
+        pixDestroy(&pixt2);
+    }
+    pixDestroy(&pixg);
+    pixDestroy(&pixc);
+    ptaDestroy(&ptas);
+    ptaDestroy(&ptad);
+    lept_free(vc);
+    lept_free(mat1);
+
+    regTestCleanup(rp);
     return 0;
 }
 
@@ -34,6 +34,7 @@
 #include "allheaders.h"
 
 static const char *tests[] = {
+                              "adaptmap_reg",
                               "alphaxform_reg",
                               "binarize_reg",
                               "colormask_reg",
@@ -48,12 +49,16 @@ static const char *tests[] = {
                               "gifio_reg",
                               "graymorph2_reg",
                               "hardlight_reg",
+                              "indexedfile_reg",
                               "ioformats_reg",
                               "kernel_reg",
                               "maze_reg",
+                              "multitiff_reg",
                               "overlap_reg",
                               "pdfseg_reg",
+                              "pdfwriter_reg",
                               "pixa2_reg",
+                              "pixacache_reg",
                               "pixserial_reg",
                               "pngio_reg",
                               "projection_reg",
@@ -58,6 +58,21 @@ L_REGPARAMS  *rp;
     pixDisplayWithTitle(pixt1, 100, 500, NULL, rp->display);
     pixDisplayWithTitle(pixt2, 700, 500, NULL, rp->display);
     pixDestroy(&pixt1);
+    pixDestroy(&pixt2);
+
+        /* Same, with the TRCs of the tiles interpolated; also
+         * check that it gives the same result in-place */
+    pixt1 = pixContrastNormInterp(NULL, pixs, 100, 100, 55, 1, 1);
+    pixSauvolaBinarizeTiled(pixt1, 8, 0.34, 1, 1, NULL, &pixt2);
+    regTestWritePixAndCheck(rp, pixt1, IFF_PNG);
+    regTestWritePixAndCheck(rp, pixt2, IFF_PNG);
+    pixDisplayWithTitle(pixt1, 100, 900, NULL, rp->display);
+    pixDisplayWithTitle(pixt2, 700, 900, NULL, rp->display);
+    pixDestroy(&pixt2);
+    pixt2 = pixCopy(NULL, pixs);
+    pixContrastNormInterp(pixt2, pixt2, 100, 100, 55, 1, 1);
+    regTestComparePix(rp, pixt1, pixt2);
+    pixDestroy(&pixt1);
     pixDestroy(&pixt2);
 
     regTestCleanup(rp);
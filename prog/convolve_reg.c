@@ -31,9 +31,11 @@ static const char  *kdatastr = " 20    50   80  50   20 "
 main(int    argc,
      char **argv)
 {
-l_int32       i, j, sizex, sizey;
+l_int32       i, j, w, h, sizex, sizey, same;
+l_float32     val, valx, valy;
+BOX          *box;
 FPIX         *fpixv, *fpixrv;
-L_KERNEL     *kel1, *kel2;
+L_KERNEL     *kel1, *kel2, *kelx, *kely;
 PIX          *pixs, *pixacc, *pixg, *pixt, *pixd;
 PIX          *pixb, *pixm, *pixms, *pixrv, *pix1, *pix2, *pix3, *pix4;
 L_REGPARAMS  *rp;
@@ -161,6 +163,93 @@ L_REGPARAMS  *rp;
     fpixDestroy(&fpixrv);
 #endif
 
+        /* Test factoring of a separable kernel.  The outer product
+         * of the parts must give the kernel, and kel1 from kdatastr
+         * is not separable. */
+    kel1 = makeGaussianKernel(5, 5, 2.0, 1.0);
+    kernelGetSeparableParts(kel1, &kelx, &kely);
+    kernelWrite("/tmp/kelx.16.kel", kelx);
+    regTestCheckFile(rp, "/tmp/kelx.16.kel");  /* 16 */
+    kernelWrite("/tmp/kely.17.kel", kely);
+    regTestCheckFile(rp, "/tmp/kely.17.kel");  /* 17 */
+    same = TRUE;
+    for (i = 0; i < 11; i++) {
+        for (j = 0; j < 11; j++) {
+            kernelGetElement(kel1, i, j, &val);
+            kernelGetElement(kelx, 0, j, &valx);
+            kernelGetElement(kely, i, 0, &valy);
+            if (L_ABS(valx * valy - val) > 0.00001)
+                same = FALSE;
+        }
+    }
+    kel2 = kernelCreateFromString(5, 5, 2, 2, kdatastr);
+    kernelDestroy(&kelx);
+    kernelDestroy(&kely);
+    kernelGetSeparableParts(kel2, &kelx, &kely);
+    if (kelx || kely)
+        same = FALSE;
+    if (!same) {
+        if (rp->fp)
+            fprintf(rp->fp, "Failure: kernel separable parts\n");
+        fprintf(stderr, "Failure: kernel separable parts\n");
+        rp->success = FALSE;
+    }
+    kernelDestroy(&kel2);
+
+        /* pixConvolve() with the gaussian is done in two 1D passes.
+         * Changing one element makes a kernel that isn't separable,
+         * and is done in one 2D pass; the results must be nearly the
+         * same.  They must also be nearly the same as pixConvolveSep()
+         * with the parts of the kernel. */
+    pixs = pixRead("test8.jpg");
+    pix1 = pixConvolve(pixs, kel1, 8, 1);
+    regTestWritePixAndCheck(rp, pix1, IFF_JFIF_JPEG);  /* 18 */
+    pixDisplayWithTitle(pix1, 400, 500, NULL, rp->display);
+    kel2 = kernelCopy(kel1);
+    kernelGetElement(kel2, 0, 0, &val);
+    kernelSetElement(kel2, 0, 0, val + 0.001);
+    pix2 = pixConvolve(pixs, kel2, 8, 1);
+    regTestCompareSimilarPix(rp, pix1, pix2, 2, 0.0, 0);  /* 19 */
+    pixDestroy(&pix2);
+    makeGaussianKernelSep(5, 5, 2.0, 1.0, &kelx, &kely);
+    pix2 = pixConvolveSep(pixs, kelx, kely, 8, 1);
+    regTestCompareSimilarPix(rp, pix1, pix2, 2, 0.0, 0);  /* 20 */
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    kernelDestroy(&kel1);
+    kernelDestroy(&kel2);
+    kernelDestroy(&kelx);
+    kernelDestroy(&kely);
+    pixDestroy(&pixs);
+
+        /* Test the recursive gaussian, which must be close to
+         * convolution with a gaussian kernel of the same stdev.
+         * The boundary pixels are handled differently, so only
+         * the interior is compared. */
+    kel1 = makeGaussianKernel(12, 12, 3.0, 1.0);
+    for (i = 0; i < 2; i++) {
+        pixs = pixRead((i == 0) ? "test8.jpg" : "test24.jpg");
+        pix1 = pixRecursiveGaussian(pixs, 3.0);
+        if (i == 0)
+            pix2 = pixConvolve(pixs, kel1, 8, 1);
+        else
+            pix2 = pixConvolveRGB(pixs, kel1);
+        regTestWritePixAndCheck(rp, pix1, IFF_JFIF_JPEG);  /* 21, 23 */
+        pixDisplayWithTitle(pix1, 600 + 200 * i, 500, NULL, rp->display);
+        pixGetDimensions(pixs, &w, &h, NULL);
+        box = boxCreate(12, 12, w - 24, h - 24);
+        pix3 = pixClipRectangle(pix1, box, NULL);
+        pix4 = pixClipRectangle(pix2, box, NULL);
+        regTestCompareSimilarPix(rp, pix3, pix4, 4, 0.03, 0);  /* 22, 24 */
+        boxDestroy(&box);
+        pixDestroy(&pixs);
+        pixDestroy(&pix1);
+        pixDestroy(&pix2);
+        pixDestroy(&pix3);
+        pixDestroy(&pix4);
+    }
+    kernelDestroy(&kel1);
+
     regTestCleanup(rp);
     return 0;
 }
@@ -20,16 +20,27 @@
  *
  *     We also test some of the fpix and dpix functions (scaling,
  *     serialization, interconversion)
+ *
+ *     Finally, we store a model in a dewarpa, serialize it, and apply
+ *     it to its own page and to a page of the same parity.
+ *
+ *     A freshly built model, applied in one pass, must give the same
+ *     result as its full res disparity arrays applied in two passes.
  */
 
+#include <string.h>
 #include "allheaders.h"
 
 l_int32 main(int    argc,
              char **argv)
 {
+char         *str1, *str2;
+l_uint8      *data;
 l_int32       i, n;
 l_float32     a, b, c;
-L_DEWARP     *dew, *dew2;
+size_t        nbytes;
+L_DEWARP     *dew, *dew2, *dew3;
+L_DEWARPA    *dewa, *dewa2;
 DPIX         *dpix1, *dpix2, *dpix3;
 FPIX         *fpix1, *fpix2, *fpix3;
 NUMA         *nax, *nafit;
@@ -179,6 +190,71 @@ L_REGPARAMS  *rp;
     fpixDestroy(&fpix3);
     pixDestroy(&pixt1);
 
+        /* Store the model for page 7 in a dewarpa.  Inserting the same
+         * model a second time must leave it in place. */
+    dew3 = dewarpRead("/tmp/dewarp.7.dew");
+    dewa = dewarpaCreate(0, -1);
+    dewarpaInsertDewarp(dewa, dew3);
+    dewarpaInsertDewarp(dewa, dew3);
+
+        /* Write and read back the dewarpa */
+    dewarpaWrite("/tmp/dewarpa.22.dewa", dewa);
+    regTestCheckFile(rp, "/tmp/dewarpa.22.dewa");  /* 22 */
+    dewa2 = dewarpaRead("/tmp/dewarpa.22.dewa");
+    dewarpaWrite("/tmp/dewarpa.23.dewa", dewa2);
+    regTestCheckFile(rp, "/tmp/dewarpa.23.dewa");  /* 23 */
+    regTestCompareFiles(rp, 22, 23);  /* 24 */
+
+        /* Apply the model to its own page, and to page 9 */
+    dewarpaApplyDisparity(dewa2, 7, pixb2, &pixt1);
+    regTestWritePixAndCheck(rp, pixt1, IFF_PNG);  /* 25 */
+    pixDisplayWithTitle(pixt1, 800, 800, "fixed with dewarpa", rp->display);
+    pixDestroy(&pixt1);
+    dewarpaApplyDisparity(dewa2, 9, pixb2, &pixt1);
+    regTestWritePixAndCheck(rp, pixt1, IFF_PNG);  /* 26 */
+    regTestCompareFiles(rp, 25, 26);  /* 27 */
+    pixDestroy(&pixt1);
+    dewarpaDestroy(&dewa);
+    dewarpaDestroy(&dewa2);
+
+        /* Make and read a version 1 dewarp file, without the extraw line */
+    data = l_binaryRead("/tmp/dewarp.7.dew", &nbytes);
+    str1 = strstr((char *)data, "Dewarp Version 2");
+    str1[strlen("Dewarp Version ")] = '1';
+    str1 = strstr((char *)data, "extraw = ");
+    str2 = strchr(str1, '\n') + 1;
+    memmove(str1, str2, (char *)data + nbytes - str2);
+    nbytes -= str2 - str1;
+    l_binaryWrite("/tmp/dewarp.28.dew", "w", data, nbytes);
+    FREE(data);
+    regTestCheckFile(rp, "/tmp/dewarp.28.dew");  /* 28 */
+    dew3 = dewarpRead("/tmp/dewarp.28.dew");
+    dewarpWrite("/tmp/dewarp.29.dew", dew3);
+    regTestCheckFile(rp, "/tmp/dewarp.29.dew");  /* 29 */
+    dewarpDestroy(&dew3);
+
+        /* A freshly built model has its own full res disparity arrays.
+         * Applying it must give the same result as applying those
+         * arrays in two passes, at each depth. */
+    dew3 = dewarpCreate(pixb, 7, 17, 15, 1);
+    dewarpBuildModel(dew3, 0);
+    pixg = pixConvertRGBToGray(pixs, 0.5, 0.3, 0.2);
+    for (i = 0; i < 3; i++) {
+        pixt1 = (i == 0) ? pixb : ((i == 1) ? pixg : pixs);
+        dewarpApplyDisparity(dew3, pixt1, 0);
+        pixt2 = pixApplyVerticalDisparity(pixt1, dew3->fullvdispar);
+        pixt1 = pixApplyHorizontalDisparity(pixt2, dew3->fullhdispar,
+                                            dew3->extraw);
+        regTestComparePix(rp, dew3->pixd, pixt1);  /* 30, 32, 34 */
+        regTestWritePixAndCheck(rp, dew3->pixd,
+                                (i == 2) ? IFF_JFIF_JPEG : IFF_PNG);
+                                /* 31, 33, 35 */
+        pixDestroy(&pixt1);
+        pixDestroy(&pixt2);
+    }
+    pixDestroy(&pixg);
+    dewarpDestroy(&dew3);
+
     dewarpDestroy(&dew);
     dewarpDestroy(&dew2);
     pixDestroy(&pixs);
@@ -23,6 +23,7 @@
  *     * Sharpening
  *     * Color mapping to lighten background with constant hue
  *     * Linear color transform without mixing (diagonal)
+ *     * TRC mapping of rgb with a separate map for each component
  */
 
 #include "allheaders.h"
@@ -39,9 +40,9 @@ l_uint32      srcval, dstval;
 l_float32     scalefact, sat, fract;
 L_BMF        *bmf8;
 L_KERNEL     *kel;
-NUMA         *na;
-PIX          *pix, *pixs, *pixs1, *pixs2, *pixd;
-PIX          *pixt0, *pixt1, *pixt2, *pixt3, *pixt4;
+NUMA         *na, *nar, *nag, *nab;
+PIX          *pix, *pixs, *pixs1, *pixs2, *pixd, *pixm;
+PIX          *pixt0, *pixt1, *pixt2, *pixt3, *pixt4, *pixt5, *pixt6;
 PIXA         *pixa, *pixaf;
 L_REGPARAMS  *rp;
 
@@ -206,6 +207,49 @@ L_REGPARAMS  *rp;
     regTestComparePix(rp, pixt1, pixt3);  /* 12 */
     regTestWritePixAndCheck(rp, pixt1, IFF_JFIF_JPEG);  /* 13 */
 
+    /* -----------------------------------------------*
+     *         Test general TRC mapping of rgb        *
+     * -----------------------------------------------*/
+    nar = numaGammaTRC(0.7, 20, 240);
+    nag = numaGammaTRC(1.0, 0, 200);
+    nab = numaGammaTRC(1.6, 40, 255);
+    pixt0 = pixConvertRGBToLuminance(pixs2);
+    pixm = pixThresholdToBinary(pixt0, 120);
+    pixDestroy(&pixt0);
+
+        /* With the same map for each component, the result is the
+         * same as from pixTRCMap(), both with and without a mask */
+    pixt5 = pixCopy(NULL, pixs2);
+    pixt6 = pixCopy(NULL, pixs2);
+    pixTRCMap(pixt5, NULL, nar);
+    pixTRCMapGeneral(pixt6, NULL, nar, nar, nar);
+    regTestComparePix(rp, pixt5, pixt6);  /* 14 */
+    pixCopy(pixt5, pixs2);
+    pixCopy(pixt6, pixs2);
+    pixTRCMap(pixt5, pixm, nab);
+    pixTRCMapGeneral(pixt6, pixm, nab, nab, nab);
+    regTestComparePix(rp, pixt5, pixt6);  /* 15 */
+
+        /* With a different map for each component, each component
+         * is the same as when mapped by itself */
+    pixCopy(pixt6, pixs2);
+    pixTRCMapGeneral(pixt6, NULL, nar, nag, nab);
+    regTestWritePixAndCheck(rp, pixt6, IFF_PNG);  /* 16 */
+    for (i = 0; i < 3; i++) {
+        pixt0 = pixGetRGBComponent(pixs2, COLOR_RED + i);
+        pixTRCMap(pixt0, NULL, (i == 0) ? nar : ((i == 1) ? nag : nab));
+        pixDestroy(&pixt5);
+        pixt5 = pixGetRGBComponent(pixt6, COLOR_RED + i);
+        regTestComparePix(rp, pixt0, pixt5);  /* 17 - 19 */
+        pixDestroy(&pixt0);
+    }
+    numaDestroy(&nar);
+    numaDestroy(&nag);
+    numaDestroy(&nab);
+    pixDestroy(&pixm);
+    pixDestroy(&pixt5);
+    pixDestroy(&pixt6);
+
     regTestCleanup(rp);
     pixDestroy(&pix);
     pixDestroy(&pixs1);
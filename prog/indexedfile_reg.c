@@ -0,0 +1,164 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -  This software is distributed in the hope that it will be
+ -  useful, but with NO WARRANTY OF ANY KIND.
+ -  No author or distributor accepts responsibility to anyone for the
+ -  consequences of using this software, or for whether it serves any
+ -  particular purpose or works at all, unless he or she says so in
+ -  writing.  Everyone is granted permission to copy, modify and
+ -  redistribute this source code, for commercial or non-commercial
+ -  purposes, with the following restrictions: (1) the origin of this
+ -  source code must not be misrepresented; (2) modified versions must
+ -  be plainly marked as such; and (3) this notice may not be removed
+ -  or altered from any source or modified source distribution.
+ *====================================================================*/
+
+/*
+ * indexedfile_reg.c
+ *
+ *    Tests indexed ("spxi") files of images, written from a pixa and
+ *    from a pixacomp.  The images are read back all at once and one
+ *    at a time.  Reading an index out of range, a truncated file and
+ *    a file of another type must fail.
+ */
+
+#include "allheaders.h"
+
+static void CheckResult(L_REGPARAMS *rp, l_int32 ok, const char *msg);
+
+
+main(int    argc,
+     char **argv)
+{
+l_uint8      *data;
+l_int32       i, n, boxflag, ret, same, xres, yres;
+size_t        nbytes;
+BOX          *box1, *box2;
+PIX          *pixs, *pix, *pix1;
+PIXA         *pixas, *pixa;
+PIXAC        *pixac, *pixac2;
+L_REGPARAMS  *rp;
+
+    if (regTestSetup(argc, argv, &rp))
+        return 1;
+
+        /* Make a pixa with images of several depths, and boxes */
+    pixas = pixaCreate(4);
+    pixs = pixRead("karen8.jpg");
+    pixaAddPix(pixas, pixThresholdToBinary(pixs, 130), L_INSERT);
+    pixaAddPix(pixas, pixs, L_INSERT);
+    pixaAddPix(pixas, pixRead("dreyfus8.png"), L_INSERT);
+    pixaAddPix(pixas, pixRead("marge.jpg"), L_INSERT);
+    for (i = 0; i < 4; i++) {
+        pix = pixaGetPix(pixas, i, L_CLONE);
+        pixSetResolution(pix, 100 + i, 200 + i);
+        pixDestroy(&pix);
+        pixaAddBox(pixas, boxCreate(i, 2 * i, 10 + i, 20 + i), L_INSERT);
+    }
+
+        /* Write the pixa, and read it back all at once */
+    pixaWriteIndexedFile("/tmp/indexed1.spxi", pixas);
+    regTestCheckFile(rp, "/tmp/indexed1.spxi");  /* 0 */
+    ret = readHeaderIndexedFile("/tmp/indexed1.spxi", &n, &boxflag);
+    CheckResult(rp, ret == 0 && n == 4 && boxflag == 1, "pixa header");
+    pixa = pixaReadIndexedFile("/tmp/indexed1.spxi");
+    for (i = 0; i < 4; i++) {
+        pixs = pixaGetPix(pixas, i, L_CLONE);
+        pix = pixaGetPix(pixa, i, L_CLONE);
+        regTestComparePix(rp, pixs, pix);  /* 1 - 4 */
+        pixGetResolution(pix, &xres, &yres);
+        CheckResult(rp, xres == 100 + i && yres == 200 + i, "resolution");
+        box1 = pixaGetBox(pixas, i, L_CLONE);
+        box2 = pixaGetBox(pixa, i, L_CLONE);
+        boxEqual(box1, box2, &same);
+        CheckResult(rp, same, "box");
+        pixDestroy(&pixs);
+        pixDestroy(&pix);
+        boxDestroy(&box1);
+        boxDestroy(&box2);
+    }
+    pixaDestroy(&pixa);
+
+        /* Read the images one at a time, in reverse order */
+    for (i = 3; i >= 0; i--) {
+        pixs = pixaGetPix(pixas, i, L_CLONE);
+        pix = pixReadFromIndexedFile("/tmp/indexed1.spxi", i);
+        regTestComparePix(rp, pixs, pix);  /* 5 - 8 */
+        pixDestroy(&pixs);
+        pixDestroy(&pix);
+    }
+
+        /* Write a pixacomp, and read it back as a pixacomp and as pix */
+    pixac = pixacompCreateFromPixa(pixas, IFF_PNG, L_CLONE);
+    pixacompWriteIndexedFile("/tmp/indexed2.spxi", pixac);
+    pixac2 = pixacompReadIndexedFile("/tmp/indexed2.spxi");
+    CheckResult(rp, pixac2 && pixacompGetCount(pixac2) == 4, "pixacomp");
+    for (i = 0; i < 4; i++) {
+        pixs = pixaGetPix(pixas, i, L_CLONE);
+        pix = pixacompGetPix(pixac2, i);
+        pix1 = pixReadFromIndexedFile("/tmp/indexed2.spxi", i);
+        regTestComparePix(rp, pixs, pix);  /* 9, 11, 13, 15 */
+        regTestComparePix(rp, pixs, pix1);  /* 10, 12, 14, 16 */
+        pixDestroy(&pixs);
+        pixDestroy(&pix);
+        pixDestroy(&pix1);
+    }
+    pixacompDestroy(&pixac);
+    pixacompDestroy(&pixac2);
+
+        /* Indices out of range */
+    pix = pixReadFromIndexedFile("/tmp/indexed1.spxi", 4);
+    CheckResult(rp, pix == NULL, "index past the end");
+    pixDestroy(&pix);
+    pix = pixReadFromIndexedFile("/tmp/indexed1.spxi", -1);
+    CheckResult(rp, pix == NULL, "negative index");
+    pixDestroy(&pix);
+
+        /* A file truncated within the index is rejected */
+    data = l_binaryRead("/tmp/indexed1.spxi", &nbytes);
+    l_binaryWrite("/tmp/indexed3.spxi", "w", data, 16 + 32 * 2);
+    ret = readHeaderIndexedFile("/tmp/indexed3.spxi", &n, NULL);
+    CheckResult(rp, ret == 1 && n == 0, "truncated index");
+    pix = pixReadFromIndexedFile("/tmp/indexed3.spxi", 0);
+    CheckResult(rp, pix == NULL, "read from truncated index");
+    pixDestroy(&pix);
+
+        /* In a file truncated within the last image, only the other
+         * images can be read */
+    l_binaryWrite("/tmp/indexed4.spxi", "w", data, nbytes - 4);
+    FREE(data);
+    pix = pixReadFromIndexedFile("/tmp/indexed4.spxi", 3);
+    CheckResult(rp, pix == NULL, "truncated image");
+    pixDestroy(&pix);
+    pixa = pixaReadIndexedFile("/tmp/indexed4.spxi");
+    CheckResult(rp, pixa == NULL, "pixa with truncated image");
+    pixaDestroy(&pixa);
+    pixs = pixaGetPix(pixas, 2, L_CLONE);
+    pix = pixReadFromIndexedFile("/tmp/indexed4.spxi", 2);
+    regTestComparePix(rp, pixs, pix);  /* 17 */
+    pixDestroy(&pixs);
+    pixDestroy(&pix);
+
+        /* Another file type is rejected */
+    ret = readHeaderIndexedFile("dreyfus8.png", &n, NULL);
+    CheckResult(rp, ret == 1, "not an indexed file");
+
+    pixaDestroy(&pixas);
+    regTestCleanup(rp);
+    return 0;
+}
+
+
+static void
+CheckResult(L_REGPARAMS  *rp,
+            l_int32       ok,
+            const char   *msg)
+{
+    if (!ok) {
+        if (rp->fp)
+            fprintf(rp->fp, "Failure: %s\n", msg);
+        fprintf(stderr, "Failure: %s\n", msg);
+        rp->success = FALSE;
+    }
+    return;
+}
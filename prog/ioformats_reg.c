@@ -71,25 +71,38 @@ static l_int32 testcomp_mem(PIX *pixs, PIX **ppixt, l_int32 index,
                             l_int32 format);
 static l_int32 test_writemem(PIX *pixs, l_int32 format, char *psfile);
 static PIX *make_24_bpp_pix(PIX *pixs);
+static void test_reduced(L_REGPARAMS *rp, const char *filename,
+                         l_int32 reduction);
 static l_int32 get_header_data(const char *filename, l_int32 true_format);
 static void get_tiff_compression_name(char *buf, l_int32 format);
 
 LEPT_DLL extern const char *ImageFileFormatExtensions[];
 
+    /* A 2 x 2 bmp with 32 bits/pixel, which pixWriteBmp() doesn't make */
+static const l_uint8  bmp32[70] = {
+    'B', 'M', 70, 0, 0, 0, 0, 0, 0, 0, 54, 0, 0, 0,      /* file header */
+    40, 0, 0, 0, 2, 0, 0, 0, 2, 0, 0, 0, 1, 0, 32, 0,    /* info header */
+    0, 0, 0, 0, 16, 0, 0, 0, 0x13, 0x0b, 0, 0, 0x13, 0x0b, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 255, 0, 0, 255, 0, 0, 255, 0, 0, 0, 255, 255, 255, 0};
+
 main(int    argc,
      char **argv)
 {
 #if HAVE_FMEMOPEN
 char          psname[256];
 #endif  /* HAVE_FMEMOPEN */
-char         *tempname;
+char         *tempname, *fname;
 l_uint8      *data;
-l_int32       i, d, n, success, failure, same;
+l_int32       i, j, d, n, success, failure, same;
+l_int32       val1[6], val2[6];
 l_int32       w, h, bps, spp;
 size_t        size, nbytes;
 PIX          *pix1, *pix2, *pix4, *pix8, *pix16, *pix32;
 PIX          *pix, *pixt, *pixd;
 PIXA         *pixa;
+NUMA         *na[6];
+SARRAY       *sa;
 L_REGPARAMS  *rp;
 
 #if  !HAVE_LIBJPEG
@@ -435,6 +448,26 @@ part6:
     pixDestroy(&pix);
     lept_free(tempname);
 
+        /* A 32 bit bmp is read as rgb, and a bmp with an invalid
+         * data offset is rejected by both the reader and the header */
+    l_binaryWrite("/tmp/junk32.bmp", "w", (void *)bmp32, sizeof(bmp32));
+    if (get_header_data("/tmp/junk32.bmp", IFF_BMP)) success = FALSE;
+    pixReadHeader("/tmp/junk32.bmp", NULL, &w, &h, &bps, &spp, NULL);
+    pix = pixRead("/tmp/junk32.bmp");
+    if (!pix || pixGetDepth(pix) != 32 || w != 2 || h != 2 ||
+        bps != 8 || spp != 3)
+        success = FALSE;
+    pixDestroy(&pix);
+    data = l_binaryCopy((l_uint8 *)bmp32, sizeof(bmp32));
+    data[10] = 20;
+    l_binaryWrite("/tmp/junkbad.bmp", "w", data, sizeof(bmp32));
+    FREE(data);
+    pix = pixRead("/tmp/junkbad.bmp");
+    if (pix || !pixReadHeader("/tmp/junkbad.bmp", NULL, NULL, NULL, NULL,
+                              NULL, NULL))
+        success = FALSE;
+    pixDestroy(&pix);
+
     if (success)
         fprintf(stderr,
             "\n  ******* Success on reading headers *******\n\n");
@@ -443,6 +476,66 @@ part6:
             "\n  ******* Failure on reading headers *******\n\n");
     if (!success) failure = TRUE;
 
+    /* ------------- Part 8: Read at reduced resolution ------------- */
+        /* The png and tiff readers reduce a band of rows at a time as
+         * they decode, and must give the same result as reducing the
+         * full image.  The jpeg decoder reduces in the DCT domain, so
+         * it is only close to the reduced full image. */
+    test_reduced(rp, FILE_2BPP_C, 2);
+    test_reduced(rp, FILE_8BPP_1, 2);
+    test_reduced(rp, FILE_8BPP_1, 8);
+    test_reduced(rp, FILE_1BPP, 4);
+    test_reduced(rp, FILE_16BPP, 4);
+    pix = pixRead(FILE_32BPP);
+    pixt = pixScaleByIntReduction(pix, 4);
+    pixd = pixReadReduced(FILE_32BPP, 4);
+    regTestWritePixAndCheck(rp, pixd, IFF_PNG);
+    regTestCompareSimilarPix(rp, pixt, pixd, 20, 0.01, 0);
+    pixDestroy(&pix);
+    pixDestroy(&pixt);
+    pixDestroy(&pixd);
+
+    /* ------------ Part 9: Read headers of a list of files ------------ */
+        /* Each header must be the same as from pixReadHeader().  The
+         * last two files, a text file and a missing file, have no
+         * header and are returned as IFF_UNKNOWN. */
+    success = TRUE;
+    l_binaryWrite("/tmp/junknoimage.txt", "w", (void *)"not an image\n", 13);
+    sa = sarrayCreate(0);
+    sarrayAddString(sa, (char *)FILE_1BPP, L_COPY);
+    sarrayAddString(sa, (char *)FILE_2BPP_C, L_COPY);
+    sarrayAddString(sa, (char *)FILE_4BPP, L_COPY);
+    sarrayAddString(sa, (char *)FILE_8BPP_1, L_COPY);
+    sarrayAddString(sa, (char *)FILE_8BPP_3, L_COPY);
+    sarrayAddString(sa, (char *)FILE_16BPP, L_COPY);
+    sarrayAddString(sa, (char *)FILE_32BPP, L_COPY);
+    sarrayAddString(sa, (char *)"/tmp/junknoimage.txt", L_COPY);
+    sarrayAddString(sa, (char *)"/tmp/junknonexistent.png", L_COPY);
+    pixReadHeadersSA(sa, &na[0], &na[1], &na[2], &na[3], &na[4], &na[5]);
+    n = sarrayGetCount(sa);
+    for (i = 0; i < n; i++) {
+        fname = sarrayGetString(sa, i, L_NOCOPY);
+        pixReadHeader(fname, &val2[0], &val2[1], &val2[2], &val2[3],
+                      &val2[4], &val2[5]);
+        for (j = 0; j < 6; j++) {
+            numaGetIValue(na[j], i, &val1[j]);
+            if (val1[j] != val2[j]) success = FALSE;
+        }
+        if (i >= n - 2 && val1[0] != IFF_UNKNOWN) success = FALSE;
+    }
+    numaWrite("/tmp/junkformats.na", na[0]);
+    regTestCheckFile(rp, "/tmp/junkformats.na");
+    for (j = 0; j < 6; j++)
+        numaDestroy(&na[j]);
+    sarrayDestroy(&sa);
+    if (success)
+        fprintf(stderr,
+            "\n  ******* Success on reading list of headers *******\n\n");
+    else
+        fprintf(stderr,
+            "\n  ******* Failure on reading list of headers *******\n\n");
+    if (!success) failure = TRUE;
+
 #if  !HAVE_LIBPNG || !HAVE_LIBJPEG || !HAVE_LIBTIFF
 finish:
 #endif  /* !HAVE_LIBPNG || !HAVE_LIBJPEG || !HAVE_LIBTIFF */
@@ -595,6 +688,26 @@ PIX       *pixd;
 }
 
 
+    /* Compare a reduced read with reduction of the full image */
+static void
+test_reduced(L_REGPARAMS  *rp,
+             const char   *filename,
+             l_int32       reduction)
+{
+PIX  *pixs, *pix1, *pix2;
+
+    pixs = pixRead(filename);
+    pix1 = pixScaleByIntReduction(pixs, reduction);
+    pix2 = pixReadReduced(filename, reduction);
+    regTestWritePixAndCheck(rp, pix2, IFF_PNG);
+    regTestComparePix(rp, pix1, pix2);
+    pixDestroy(&pixs);
+    pixDestroy(&pix1);
+    pixDestroy(&pix2);
+    return;
+}
+
+
     /* Retrieve header data from file */
 static l_int32
 get_header_data(const char  *filename,
@@ -0,0 +1,107 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -  This software is distributed in the hope that it will be
+ -  useful, but with NO WARRANTY OF ANY KIND.
+ -  No author or distributor accepts responsibility to anyone for the
+ -  consequences of using this software, or for whether it serves any
+ -  particular purpose or works at all, unless he or she says so in
+ -  writing.  Everyone is granted permission to copy, modify and
+ -  redistribute this source code, for commercial or non-commercial
+ -  purposes, with the following restrictions: (1) the origin of this
+ -  source code must not be misrepresented; (2) modified versions must
+ -  be plainly marked as such; and (3) this notice may not be removed
+ -  or altered from any source or modified source distribution.
+ *====================================================================*/
+
+/*
+ * multitiff_reg.c
+ *
+ *    Tests reading of multipage tiff files, both all at once into
+ *    a pixa and page by page, using the offset of the next directory.
+ */
+
+#include "allheaders.h"
+
+    /* Pages of the multipage file */
+static const l_int32  npages = 6;
+static const char  *filename[] = {
+                         "feyn-fract.tif",   /* 1 bpp */
+                         "char.tif",         /* 1 bpp */
+                         "dreyfus8.png",     /* 8 bpp cmapped */
+                         "karen8.jpg",       /* 8 bpp */
+                         "test16.tif",       /* 16 bpp */
+                         "marge.jpg"         /* rgb */
+                            };
+
+main(int    argc,
+     char **argv)
+{
+l_int32       i, n;
+size_t        offset;
+PIX          *pixs, *pix;
+PIXA         *pixas, *pixa;
+L_REGPARAMS  *rp;
+
+    if (regTestSetup(argc, argv, &rp))
+        return 1;
+
+        /* Make a multipage tiff file */
+    pixas = pixaCreate(npages);
+    for (i = 0; i < npages; i++) {
+        pixs = pixRead(filename[i]);
+        if (pixGetDepth(pixs) == 1)
+            pixWriteTiff("/tmp/multipage.tif", pixs, IFF_TIFF_G4,
+                         (i == 0) ? "w" : "a");
+        else
+            pixWriteTiff("/tmp/multipage.tif", pixs, IFF_TIFF_ZIP,
+                         (i == 0) ? "w" : "a");
+        pixaAddPix(pixas, pixs, L_INSERT);
+    }
+
+        /* Read all pages at once */
+    pixa = pixaReadMultipageTiff("/tmp/multipage.tif");
+    n = pixaGetCount(pixa);
+    if (n != npages) {
+        if (rp->fp)
+            fprintf(rp->fp, "Failure: %d pages read; expected %d\n",
+                    n, npages);
+        fprintf(stderr, "Failure: %d pages read; expected %d\n", n, npages);
+        rp->success = FALSE;
+    }
+    for (i = 0; i < npages; i++) {
+        pixs = pixaGetPix(pixas, i, L_CLONE);
+        pix = pixaGetPix(pixa, i, L_CLONE);
+        regTestComparePix(rp, pixs, pix);  /* i */
+        pixDestroy(&pixs);
+        pixDestroy(&pix);
+    }
+    pixaDestroy(&pixa);
+
+        /* Read one page at a time, starting at each returned offset */
+    offset = 0;
+    n = 0;
+    do {
+        pix = pixReadFromMultipageTiff("/tmp/multipage.tif", &offset);
+        if (!pix)
+            break;
+        if (n < npages) {
+            pixs = pixaGetPix(pixas, n, L_CLONE);
+            regTestComparePix(rp, pixs, pix);  /* npages + n */
+            pixDestroy(&pixs);
+        }
+        pixDestroy(&pix);
+        n++;
+    } while (offset != 0);
+    if (n != npages || offset != 0) {
+        if (rp->fp)
+            fprintf(rp->fp, "Failure: %d pages read by offset; expected %d\n",
+                    n, npages);
+        fprintf(stderr, "Failure: %d pages read by offset; expected %d\n",
+                n, npages);
+        rp->success = FALSE;
+    }
+
+    pixaDestroy(&pixas);
+    regTestCleanup(rp);
+    return 0;
+}
@@ -0,0 +1,126 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -  This software is distributed in the hope that it will be
+ -  useful, but with NO WARRANTY OF ANY KIND.
+ -  No author or distributor accepts responsibility to anyone for the
+ -  consequences of using this software, or for whether it serves any
+ -  particular purpose or works at all, unless he or she says so in
+ -  writing.  Everyone is granted permission to copy, modify and
+ -  redistribute this source code, for commercial or non-commercial
+ -  purposes, with the following restrictions: (1) the origin of this
+ -  source code must not be misrepresented; (2) modified versions must
+ -  be plainly marked as such; and (3) this notice may not be removed
+ -  or altered from any source or modified source distribution.
+ *====================================================================*/
+
+/*
+ * pdfwriter_reg.c
+ *
+ *    Tests the streaming multi-page pdf writer.  A multipage pdf is
+ *    written from pix and from single page pdf data, and the two
+ *    files must be identical.  Closing a writer without pages must
+ *    fail and leave no file.
+ *
+ *    Also tests conversion of a list of image files to pdf.  The file
+ *    written by saConvertFilesToPdf() must be identical to the data
+ *    from saConvertFilesToPdfData().
+ */
+
+#include "allheaders.h"
+
+    /* Pages of the pdf file */
+static const l_int32  npages = 4;
+static const char  *filename[] = {
+                         "feyn-fract.tif",   /* 1 bpp; G4 */
+                         "dreyfus8.png",     /* 8 bpp cmapped; flate */
+                         "karen8.jpg",       /* 8 bpp; jpeg */
+                         "marge.jpg"         /* rgb; jpeg */
+                            };
+
+main(int    argc,
+     char **argv)
+{
+l_uint8       *data;
+l_int32        i, type, same, ret;
+size_t         nbytes;
+FILE          *fp;
+PIX           *pix;
+SARRAY        *sa;
+L_PDF_WRITER  *lpw;
+L_REGPARAMS   *rp;
+
+    if (regTestSetup(argc, argv, &rp))
+        return 1;
+
+    l_pdfSetDateAndVersion(0);  /* for reproducible output */
+
+        /* Write the pages from pix */
+    lpw = pdfWriterCreate("/tmp/pdfwriter1.pdf", "pdfwriter_reg");
+    for (i = 0; i < npages; i++) {
+        pix = pixRead(filename[i]);
+        selectDefaultPdfEncoding(pix, &type);
+        pdfWriterAddPix(lpw, pix, type, 0, 150);
+        pixDestroy(&pix);
+    }
+    pdfWriterClose(&lpw);
+    regTestCheckFile(rp, "/tmp/pdfwriter1.pdf");  /* 0 */
+
+        /* Write the same pages from single page pdf data */
+    lpw = pdfWriterCreate("/tmp/pdfwriter2.pdf", "pdfwriter_reg");
+    for (i = 0; i < npages; i++) {
+        pix = pixRead(filename[i]);
+        selectDefaultPdfEncoding(pix, &type);
+        pixConvertToPdfData(pix, type, 0, &data, &nbytes, 0, 0, 150,
+                            NULL, 0, "pdfwriter_reg");
+        pdfWriterAddPdfData(lpw, data, nbytes);
+        FREE(data);
+        pixDestroy(&pix);
+    }
+    pdfWriterClose(&lpw);
+    regTestCheckFile(rp, "/tmp/pdfwriter2.pdf");  /* 1 */
+    filesAreIdentical("/tmp/pdfwriter1.pdf", "/tmp/pdfwriter2.pdf", &same);
+    if (!same) {
+        if (rp->fp)
+            fprintf(rp->fp, "Failure: pdf from pix and from data differ\n");
+        fprintf(stderr, "Failure: pdf from pix and from data differ\n");
+        rp->success = FALSE;
+    }
+
+        /* A writer without pages fails on close and leaves no file */
+    lpw = pdfWriterCreate("/tmp/pdfwriter3.pdf", NULL);
+    ret = pdfWriterClose(&lpw);
+    fp = fopen("/tmp/pdfwriter3.pdf", "rb");
+    if (ret == 0 || fp) {
+        if (rp->fp)
+            fprintf(rp->fp, "Failure: empty pdf writer not handled\n");
+        fprintf(stderr, "Failure: empty pdf writer not handled\n");
+        rp->success = FALSE;
+    }
+    if (fp) fclose(fp);
+
+        /* Convert the image files, to a file and to memory */
+    sa = sarrayCreate(npages);
+    for (i = 0; i < npages; i++)
+        sarrayAddString(sa, (char *)filename[i], L_COPY);
+    saConvertFilesToPdf(sa, 150, 1.0, 0, "pdfwriter_reg",
+                        "/tmp/pdfwriter4.pdf");
+    regTestCheckFile(rp, "/tmp/pdfwriter4.pdf");  /* 2 */
+    saConvertFilesToPdfData(sa, 150, 1.0, 0, "pdfwriter_reg", &data, &nbytes);
+    l_binaryWrite("/tmp/pdfwriter5.pdf", "w", data, nbytes);
+    FREE(data);
+    filesAreIdentical("/tmp/pdfwriter4.pdf", "/tmp/pdfwriter5.pdf", &same);
+    if (!same) {
+        if (rp->fp)
+            fprintf(rp->fp, "Failure: pdf file and pdf data differ\n");
+        fprintf(stderr, "Failure: pdf file and pdf data differ\n");
+        rp->success = FALSE;
+    }
+    saConvertFilesToPdfStreaming(sa, 150, 1.0, 0, "pdfwriter_reg",
+                                 "/tmp/pdfwriter6.pdf");
+    regTestCheckFile(rp, "/tmp/pdfwriter6.pdf");  /* 3 */
+    sarrayDestroy(&sa);
+
+    l_pdfSetDateAndVersion(1);
+    regTestCleanup(rp);
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*====================================================================*
+ -  Copyright (C) 2001 Leptonica.  All rights reserved.
+ -  This software is distributed in the hope that it will be
+ -  useful, but with NO WARRANTY OF ANY KIND.
+ -  No author or distributor accepts responsibility to anyone for the
+ -  consequences of using this software, or for whether it serves any
+ -  particular purpose or works at all, unless he or she says so in
+ -  writing.  Everyone is granted permission to copy, modify and
+ -  redistribute this source code, for commercial or non-commercial
+ -  purposes, with the following restrictions: (1) the origin of this
+ -  source code must not be misrepresented; (2) modified versions must
+ -  be plainly marked as such; and (3) this notice may not be removed
+ -  or altered from any source or modified source distribution.
+ *====================================================================*/
+
+/*
+ * pixacache_reg.c
+ *
+ *    Tests the cache of decoded pix in a pixacomp: hits, misses,
+ *    eviction of the least recently used pix, and that altering
+ *    a returned pix does not change what is cached.
+ */
+
+#include "allheaders.h"
+
+static void CheckCached(L_REGPARAMS *rp, PIXAC *pixac, l_int32 index,
+                        l_int32 expected);
+
+
+main(int    argc,
+     char **argv)
+{
+l_int32       i;
+size_t        nbytes;
+PIX          *pixs, *pix, *pix1;
+PIXA         *pixas, *pixa;
+PIXAC        *pixac;
+L_REGPARAMS  *rp;
+
+    if (regTestSetup(argc, argv, &rp))
+        return 1;
+
+        /* Four different images of the same size, compressed losslessly */
+    pixs = pixRead("karen8.jpg");
+    pixas = pixaCreate(4);
+    pixaAddPix(pixas, pixs, L_COPY);
+    pixaAddPix(pixas, pixInvert(NULL, pixs), L_INSERT);
+    pixaAddPix(pixas, pixRotate180(NULL, pixs), L_INSERT);
+    pixaAddPix(pixas, pixFlipLR(NULL, pixs), L_INSERT);
+    pixac = pixacompCreateFromPixa(pixas, IFF_PNG, L_CLONE);
+    nbytes = 4 * pixGetWpl(pixs) * pixGetHeight(pixs);
+    pixDestroy(&pixs);
+
+        /* Room for two decoded pix */
+    pixacompSetCache(pixac, 2 * nbytes);
+
+        /* Misses on 0 and 1 fill the cache; a hit on 0 makes 1 the
+         * least recently used, so the miss on 2 evicts 1. */
+    for (i = 0; i < 2; i++) {
+        pix = pixacompGetPix(pixac, i);
+        pixDestroy(&pix);
+    }
+    CheckCached(rp, pixac, 0, TRUE);
+    CheckCached(rp, pixac, 1, TRUE);
+    pix = pixacompGetPix(pixac, 0);
+    pixs = pixaGetPix(pixas, 0, L_CLONE);
+    regTestComparePix(rp, pixs, pix);  /* 0 */
+    pixDestroy(&pixs);
+    pixDestroy(&pix);
+    pix = pixacompGetPix(pixac, 2);
+    pixDestroy(&pix);
+    CheckCached(rp, pixac, 0, TRUE);
+    CheckCached(rp, pixac, 1, FALSE);
+    CheckCached(rp, pixac, 2, TRUE);
+
+        /* Altering a pix returned on a hit or a miss must not
+         * change the cached pix */
+    for (i = 2; i < 4; i++) {
+        pix = pixacompGetPix(pixac, i);
+        pixSetAll(pix);
+        pixDestroy(&pix);
+        pix = pixacompGetPix(pixac, i);
+        pixs = pixaGetPix(pixas, i, L_CLONE);
+        regTestComparePix(rp, pixs, pix);  /* 1, 2 */
+        pixDestroy(&pixs);
+        pixDestroy(&pix);
+    }
+
+        /* Likewise for the pix in a pixa made from the pixacomp */
+    pixa = pixaCreateFromPixacomp(pixac, L_COPY);
+    for (i = 0; i < 4; i++) {
+        pix = pixaGetPix(pixa, i, L_CLONE);
+        pixSetAll(pix);
+        pixDestroy(&pix);
+    }
+    pixaDestroy(&pixa);
+    for (i = 0; i < 4; i++) {
+        pix = pixacompGetPix(pixac, i);
+        pixs = pixaGetPix(pixas, i, L_CLONE);
+        regTestComparePix(rp, pixs, pix);  /* 3 - 6 */
+        pixDestroy(&pixs);
+        pixDestroy(&pix);
+    }
+
+        /* Replacing a pixcomp drops its cached pix */
+    CheckCached(rp, pixac, 3, TRUE);
+    pix1 = pixaGetPix(pixas, 0, L_CLONE);
+    pixacompReplacePix(pixac, 3, pix1, IFF_PNG);
+    CheckCached(rp, pixac, 3, FALSE);
+    pix = pixacompGetPix(pixac, 3);
+    regTestComparePix(rp, pix1, pix);  /* 7 */
+    pixDestroy(&pix);
+    pixDestroy(&pix1);
+
+        /* Removing the cache */
+    pixacompSetCache(pixac, 0);
+    if (pixac->cache) {
+        if (rp->fp)
+            fprintf(rp->fp, "Failure: cache not removed\n");
+        fprintf(stderr, "Failure: cache not removed\n");
+        rp->success = FALSE;
+    }
+
+    pixacompDestroy(&pixac);
+    pixaDestroy(&pixas);
+    regTestCleanup(rp);
+    return 0;
+}
+
+
+static void
+CheckCached(L_REGPARAMS  *rp,
+            PIXAC        *pixac,
+            l_int32       index,
+            l_int32       expected)
+{
+l_int32         cached;
+L_PIXAC_CACHE  *cache;
+
+    cache = pixac->cache;
+    cached = (index < cache->nalloc && cache->pix[index] != NULL);
+    if (cached != expected) {
+        if (rp->fp)
+            fprintf(rp->fp, "Failure: pix %d is %scached\n", index,
+                    (cached) ? "" : "not ");
+        fprintf(stderr, "Failure: pix %d is %scached\n", index,
+                (cached) ? "" : "not ");
+        rp->success = FALSE;
+    }
+    return;
+}
@@ -17,7 +17,8 @@
  * scale_reg.c
  *
  *      This tests a number of scaling operations, through the pixScale()
- *      interface.
+ *      interface.  It also tests scaling with the bicubic and lanczos
+ *      filters, through pixScaleWithFilter().
  */
 
 #include "allheaders.h"
@@ -46,7 +47,7 @@ static void PixaSaveDisplay(PIXA *pixa, L_REGPARAMS *rp);
 main(int    argc,
      char **argv)
 {
-l_int32       i;
+l_int32       i, type;
 PIX          *pixs, *pixc, *pixd;
 PIXA         *pixa;
 L_REGPARAMS  *rp;
@@ -228,6 +229,43 @@ L_REGPARAMS  *rp;
     PixaSaveDisplay(pixa, rp);
     pixDestroy(&pixs);
 
+        /* Test bicubic and lanczos scaling, up and down */
+    fprintf(stderr, "\n-------------- Testing filtered scaling --------\n");
+    pixa = pixaCreate(0);
+    for (i = 0; i < 2; i++) {
+        pixs = pixRead((i == 0) ? image[5] : image[8]);  /* 8 and 32 bpp */
+        pixSaveTiled(pixs, pixa, 1, 1, SPACE, 32);
+        for (type = L_BICUBIC_FILTER; type <= L_LANCZOS3_FILTER; type++) {
+            pixc = pixScaleWithFilter(pixs, 1.6, 1.6, type, 0.0, 0);
+            regTestWritePixAndCheck(rp, pixc,
+                                    (i == 0) ? IFF_PNG : IFF_JFIF_JPEG);
+            PixSave32(pixa, pixc);
+            pixc = pixScaleWithFilter(pixs, 0.45, 0.45, type, 0.0, 0);
+            regTestWritePixAndCheck(rp, pixc,
+                                    (i == 0) ? IFF_PNG : IFF_JFIF_JPEG);
+            PixSave32(pixa, pixc);
+        }
+        pixDestroy(&pixs);
+    }
+    PixaSaveDisplay(pixa, rp);
+
+        /* The linear filter is the same as pixScaleGeneral(), and
+         * binary images are always scaled by sampling */
+    pixs = pixRead(image[8]);
+    pixc = pixScaleWithFilter(pixs, 0.65, 0.65, L_LINEAR_FILTER, 0.2, 1);
+    pixd = pixScaleGeneral(pixs, 0.65, 0.65, 0.2, 1);
+    regTestComparePix(rp, pixc, pixd);
+    pixDestroy(&pixs);
+    pixDestroy(&pixc);
+    pixDestroy(&pixd);
+    pixs = pixRead(image[0]);
+    pixc = pixScaleWithFilter(pixs, 0.35, 0.35, L_LANCZOS3_FILTER, 0.0, 0);
+    pixd = pixScaleBinary(pixs, 0.35, 0.35);
+    regTestComparePix(rp, pixc, pixd);
+    pixDestroy(&pixs);
+    pixDestroy(&pixc);
+    pixDestroy(&pixd);
+
     regTestCleanup(rp);
     return 0;
 }
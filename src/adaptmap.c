@@ -53,6 +53,9 @@
  *      Apply inverse background map to image
  *          PIX       *pixApplyInvBackgroundGrayMap()   8 bpp
  *          PIX       *pixApplyInvBackgroundRGBMap()    32 bpp
+ *          PIX       *pixApplyInvBackgroundGrayMapInterp()   8 bpp
+ *          PIX       *pixApplyInvBackgroundRGBMapInterp()    32 bpp
+ *          static l_int32  *makeMapInterpTable()
  *
  *      Apply variable map
  *          PIX       *pixApplyVariableGrayMap()        8 bpp
@@ -69,9 +72,12 @@
  *
  *      Adaptive contrast normalization
  *          PIX             *pixContrastNorm()          8 bpp
+ *          PIX             *pixContrastNormInterp()    8 bpp
  *          l_int32          pixMinMaxTiles()
+ *          static l_int32   pixGetTileMinMax()
  *          l_int32          pixSetLowContrast()
  *          PIX             *pixLinearTRCTiled()
+ *          PIX             *pixLinearTRCTiledInterp()
  *          static l_int32  *iaaGetLinearTRC()
  *
  *  Background normalization is done by generating a reduced map (or set
@@ -137,7 +143,10 @@ static const l_int32  DEFAULT_BG_VAL = 200;
 static const l_int32  DEFAULT_X_SMOOTH_SIZE = 2;
 static const l_int32  DEFAULT_Y_SMOOTH_SIZE = 1;
 
+static l_int32 pixGetTileMinMax(PIX *pixs, l_int32 sx, l_int32 sy,
+                                PIX **ppixmin, PIX **ppixmax);
 static l_int32 *iaaGetLinearTRC(l_int32 **iaa, l_int32 diff);
+static l_int32 *makeMapInterpTable(l_int32 n, l_int32 size, l_int32 nm);
 
 #ifndef  NO_CONSOLE_IO
 #define  DEBUG_GLOBAL    0
@@ -1916,6 +1925,271 @@ PIX       *pixd;
 }
 
 
+/*!
+ *  pixApplyInvBackgroundGrayMapInterp()
+ *
+ *      Input:  pixs (8 bpp grayscale; no colormap)
+ *              pixm (16 bpp, inverse background map)
+ *              sx (tile width in pixels)
+ *              sy (tile height in pixels)
+ *      Return: pixd (8 bpp), or null on error
+ *
+ *  Notes:
+ *      (1) This is a smooth version of pixApplyInvBackgroundGrayMap().
+ *          Instead of using the same map value for every pixel in a
+ *          tile, the map is bilinearly interpolated between tile centers,
+ *          which removes the steps in the normalized background at
+ *          tile boundaries.
+ *      (2) The map is never expanded to full resolution.  For each
+ *          row of pixd, one row of map values is interpolated between
+ *          the two nearest map rows, and each pixel is interpolated
+ *          from that row, all in 8 bit fixed point.
+ *      (3) The rows of pixd are independent, so the image can be
+ *          done in bands of rows in any order.
+ */
+PIX *
+pixApplyInvBackgroundGrayMapInterp(PIX     *pixs,
+                                   PIX     *pixm,
+                                   l_int32  sx,
+                                   l_int32  sy)
+{
+l_int32    w, h, wm, hm, wpls, wpld, wplm, i, j, jm, fx, fy, im0, im1;
+l_int32    vals, vald, val16;
+l_int32   *xtab, *ytab, *rowm;
+l_uint32  *datas, *datad, *datam, *lines, *lined, *linem0, *linem1;
+PIX       *pixd;
+
+    PROCNAME("pixApplyInvBackgroundGrayMapInterp");
+
+    if (!pixs || pixGetDepth(pixs) != 8)
+        return (PIX *)ERROR_PTR("pixs undefined or not 8 bpp", procName, NULL);
+    if (pixGetColormap(pixs))
+        return (PIX *)ERROR_PTR("pixs has colormap", procName, NULL);
+    if (!pixm || pixGetDepth(pixm) != 16)
+        return (PIX *)ERROR_PTR("pixm undefined or not 16 bpp", procName, NULL);
+    if (sx <= 0 || sy <= 0)
+        return (PIX *)ERROR_PTR("invalid sx and/or sy", procName, NULL);
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    pixGetDimensions(pixm, &wm, &hm, NULL);
+    xtab = makeMapInterpTable(w, sx, wm);
+    ytab = makeMapInterpTable(h, sy, hm);
+    rowm = (l_int32 *)CALLOC(wm + 1, sizeof(l_int32));
+    pixd = pixCreateTemplate(pixs);
+    if (!xtab || !ytab || !rowm || !pixd) {
+        FREE(xtab);
+        FREE(ytab);
+        FREE(rowm);
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("tables or pixd not made", procName, NULL);
+    }
+
+    datas = pixGetData(pixs);
+    wpls = pixGetWpl(pixs);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    datam = pixGetData(pixm);
+    wplm = pixGetWpl(pixm);
+    for (i = 0; i < h; i++) {
+            /* Interpolate a row of map values between two map rows */
+        im0 = ytab[i] >> 8;
+        fy = ytab[i] & 0xff;
+        im1 = L_MIN(im0 + 1, hm - 1);
+        linem0 = datam + im0 * wplm;
+        linem1 = datam + im1 * wplm;
+        for (j = 0; j < wm; j++)
+            rowm[j] = ((256 - fy) * GET_DATA_TWO_BYTES(linem0, j) +
+                       fy * GET_DATA_TWO_BYTES(linem1, j) + 128) >> 8;
+        rowm[wm] = rowm[wm - 1];
+
+        lines = datas + i * wpls;
+        lined = datad + i * wpld;
+        for (j = 0; j < w; j++) {
+            jm = xtab[j] >> 8;
+            fx = xtab[j] & 0xff;
+            val16 = ((256 - fx) * rowm[jm] + fx * rowm[jm + 1] + 128) >> 8;
+            vals = GET_DATA_BYTE(lines, j);
+            vald = (vals * val16) >> 8;
+            vald = L_MIN(vald, 255);
+            SET_DATA_BYTE(lined, j, vald);
+        }
+    }
+
+    FREE(xtab);
+    FREE(ytab);
+    FREE(rowm);
+    return pixd;
+}
+
+
+/*!
+ *  pixApplyInvBackgroundRGBMapInterp()
+ *
+ *      Input:  pixs (32 bpp rbg)
+ *              pixmr (16 bpp, red inverse background map)
+ *              pixmg (16 bpp, green inverse background map)
+ *              pixmb (16 bpp, blue inverse background map)
+ *              sx (tile width in pixels)
+ *              sy (tile height in pixels)
+ *      Return: pixd (32 bpp rbg), or null on error
+ *
+ *  Notes:
+ *      (1) This is a smooth version of pixApplyInvBackgroundRGBMap().
+ *          See pixApplyInvBackgroundGrayMapInterp() for details.
+ */
+PIX *
+pixApplyInvBackgroundRGBMapInterp(PIX     *pixs,
+                                  PIX     *pixmr,
+                                  PIX     *pixmg,
+                                  PIX     *pixmb,
+                                  l_int32  sx,
+                                  l_int32  sy)
+{
+l_int32    w, h, wm, hm, wpls, wpld, wplm, i, j, jm, fx, fy, im0, im1;
+l_int32    rvald, gvald, bvald, rval16, gval16, bval16;
+l_int32   *xtab, *ytab, *rowr, *rowg, *rowb;
+l_uint32   vals;
+l_uint32  *datas, *datad, *lines, *lined;
+l_uint32  *datamr, *datamg, *datamb, *linem0, *linem1;
+PIX       *pixd;
+
+    PROCNAME("pixApplyInvBackgroundRGBMapInterp");
+
+    if (!pixs || pixGetDepth(pixs) != 32)
+        return (PIX *)ERROR_PTR("pixs undefined or not 32 bpp",
+                                procName, NULL);
+    if (!pixmr || !pixmg || !pixmb)
+        return (PIX *)ERROR_PTR("pix maps not all defined", procName, NULL);
+    if (pixGetDepth(pixmr) != 16 || pixGetDepth(pixmg) != 16 ||
+        pixGetDepth(pixmb) != 16)
+        return (PIX *)ERROR_PTR("pix maps not all 16 bpp", procName, NULL);
+    if (sx <= 0 || sy <= 0)
+        return (PIX *)ERROR_PTR("invalid sx and/or sy", procName, NULL);
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    pixGetDimensions(pixmr, &wm, &hm, NULL);
+    if (pixGetWidth(pixmg) != wm || pixGetHeight(pixmg) != hm ||
+        pixGetWidth(pixmb) != wm || pixGetHeight(pixmb) != hm)
+        return (PIX *)ERROR_PTR("pix maps not all the same size",
+                                procName, NULL);
+    xtab = makeMapInterpTable(w, sx, wm);
+    ytab = makeMapInterpTable(h, sy, hm);
+    rowr = (l_int32 *)CALLOC(wm + 1, sizeof(l_int32));
+    rowg = (l_int32 *)CALLOC(wm + 1, sizeof(l_int32));
+    rowb = (l_int32 *)CALLOC(wm + 1, sizeof(l_int32));
+    pixd = pixCreateTemplate(pixs);
+    if (!xtab || !ytab || !rowr || !rowg || !rowb || !pixd) {
+        FREE(xtab);
+        FREE(ytab);
+        FREE(rowr);
+        FREE(rowg);
+        FREE(rowb);
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("tables or pixd not made", procName, NULL);
+    }
+
+    datas = pixGetData(pixs);
+    wpls = pixGetWpl(pixs);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    datamr = pixGetData(pixmr);
+    datamg = pixGetData(pixmg);
+    datamb = pixGetData(pixmb);
+    wplm = pixGetWpl(pixmr);
+    for (i = 0; i < h; i++) {
+        im0 = ytab[i] >> 8;
+        fy = ytab[i] & 0xff;
+        im1 = L_MIN(im0 + 1, hm - 1);
+        linem0 = datamr + im0 * wplm;
+        linem1 = datamr + im1 * wplm;
+        for (j = 0; j < wm; j++)
+            rowr[j] = ((256 - fy) * GET_DATA_TWO_BYTES(linem0, j) +
+                       fy * GET_DATA_TWO_BYTES(linem1, j) + 128) >> 8;
+        linem0 = datamg + im0 * wplm;
+        linem1 = datamg + im1 * wplm;
+        for (j = 0; j < wm; j++)
+            rowg[j] = ((256 - fy) * GET_DATA_TWO_BYTES(linem0, j) +
+                       fy * GET_DATA_TWO_BYTES(linem1, j) + 128) >> 8;
+        linem0 = datamb + im0 * wplm;
+        linem1 = datamb + im1 * wplm;
+        for (j = 0; j < wm; j++)
+            rowb[j] = ((256 - fy) * GET_DATA_TWO_BYTES(linem0, j) +
+                       fy * GET_DATA_TWO_BYTES(linem1, j) + 128) >> 8;
+        rowr[wm] = rowr[wm - 1];
+        rowg[wm] = rowg[wm - 1];
+        rowb[wm] = rowb[wm - 1];
+
+        lines = datas + i * wpls;
+        lined = datad + i * wpld;
+        for (j = 0; j < w; j++) {
+            jm = xtab[j] >> 8;
+            fx = xtab[j] & 0xff;
+            rval16 = ((256 - fx) * rowr[jm] + fx * rowr[jm + 1] + 128) >> 8;
+            gval16 = ((256 - fx) * rowg[jm] + fx * rowg[jm + 1] + 128) >> 8;
+            bval16 = ((256 - fx) * rowb[jm] + fx * rowb[jm + 1] + 128) >> 8;
+            vals = lines[j];
+            rvald = (((vals >> L_RED_SHIFT) & 0xff) * rval16) >> 8;
+            rvald = L_MIN(rvald, 255);
+            gvald = (((vals >> L_GREEN_SHIFT) & 0xff) * gval16) >> 8;
+            gvald = L_MIN(gvald, 255);
+            bvald = (((vals >> L_BLUE_SHIFT) & 0xff) * bval16) >> 8;
+            bvald = L_MIN(bvald, 255);
+            lined[j] = (rvald << L_RED_SHIFT) | (gvald << L_GREEN_SHIFT) |
+                       (bvald << L_BLUE_SHIFT);
+        }
+    }
+
+    FREE(xtab);
+    FREE(ytab);
+    FREE(rowr);
+    FREE(rowg);
+    FREE(rowb);
+    return pixd;
+}
+
+
+/*!
+ *  makeMapInterpTable()
+ *
+ *      Input:  n (number of image pixels along one direction)
+ *              size (tile size along that direction)
+ *              nm (number of map pixels along that direction)
+ *      Return: table (of n entries), or null on error
+ *
+ *  Notes:
+ *      (1) Each map pixel is taken to be the value at the center of
+ *          its tile.  For image pixel k, entry k holds the index of
+ *          the map pixel to its left (or above) in the upper bits, and
+ *          the 8 bit fractional distance to the next map pixel in the
+ *          lowest 8 bits.  Pixels beyond the outer tile centers use
+ *          the nearest map pixel.
+ */
+static l_int32 *
+makeMapInterpTable(l_int32  n,
+                   l_int32  size,
+                   l_int32  nm)
+{
+l_int32   k, u;
+l_int32  *tab;
+
+    PROCNAME("makeMapInterpTable");
+
+    if ((tab = (l_int32 *)CALLOC(n, sizeof(l_int32))) == NULL)
+        return (l_int32 *)ERROR_PTR("tab not made", procName, NULL);
+
+    for (k = 0; k < n; k++) {
+            /* 256 * ((k + 0.5) / size - 0.5) */
+        u = (256 * (2 * k + 1)) / (2 * size) - 128;
+        if (u < 0)
+            u = 0;
+        if (u >= 256 * (nm - 1))
+            u = 256 * (nm - 1);
+        tab[k] = u;
+    }
+    return tab;
+}
+
+
 /*------------------------------------------------------------------*
  *                         Apply variable map                       *
  *------------------------------------------------------------------*/
@@ -2497,6 +2771,60 @@ PIX  *pixmin, *pixmax;
 }
 
 
+/*!
+ *  pixContrastNormInterp()
+ *
+ *      Input:  pixd (<optional> 8 bpp; null or equal to pixs)
+ *              pixs (8 bpp grayscale; not colormapped)
+ *              sx, sy (tile dimensions)
+ *              mindiff (minimum difference to accept as valid)
+ *              smoothx, smoothy (half-width of convolution kernel applied to
+ *                                min and max arrays: use 0 for no smoothing)
+ *      Return: pixd always
+ *
+ *  Notes:
+ *      (1) This is the same as pixContrastNorm(), except that the
+ *          TRCs of neighboring tiles are bilinearly blended, using
+ *          pixLinearTRCTiledInterp().  This avoids the visible
+ *          discontinuities at tile boundaries that can result from
+ *          mapping each tile with its own TRC.
+ *      (2) See pixContrastNorm() for use of the input parameters.
+ */
+PIX *
+pixContrastNormInterp(PIX       *pixd,
+                      PIX       *pixs,
+                      l_int32    sx,
+                      l_int32    sy,
+                      l_int32    mindiff,
+                      l_int32    smoothx,
+                      l_int32    smoothy)
+{
+PIX  *pixmin, *pixmax;
+
+    PROCNAME("pixContrastNormInterp");
+
+    if (!pixs || pixGetDepth(pixs) != 8)
+        return (PIX *)ERROR_PTR("pixs undefined or not 8 bpp", procName, pixd);
+    if (pixd && pixd != pixs)
+        return (PIX *)ERROR_PTR("pixd not null or == pixs", procName, pixd);
+    if (pixGetColormap(pixs))
+        return (PIX *)ERROR_PTR("pixs is colormapped", procName, pixd);
+    if (sx < 5 || sy < 5)
+        return (PIX *)ERROR_PTR("sx and/or sy less than 5", procName, pixd);
+    if (smoothx < 0 || smoothy < 0)
+        return (PIX *)ERROR_PTR("smooth params less than 0", procName, pixd);
+    if (smoothx > 8 || smoothy > 8)
+        return (PIX *)ERROR_PTR("smooth params exceed 8", procName, pixd);
+
+    pixMinMaxTiles(pixs, sx, sy, mindiff, smoothx, smoothy, &pixmin, &pixmax);
+    pixd = pixLinearTRCTiledInterp(pixd, pixs, sx, sy, pixmin, pixmax);
+
+    pixDestroy(&pixmin);
+    pixDestroy(&pixmax);
+    return pixd;
+}
+
+
 /*!
  *  pixMinMaxTiles()
  *
@@ -2544,8 +2872,8 @@ PIX     *pixmin1, *pixmax1, *pixmin2, *pixmax2;
         return ERROR_INT("smooth params exceed 5", procName, 1);
 
         /* Get the min and max values in each tile */
-    pixmin1 = pixScaleGrayMinMax(pixs, sx, sy, L_CHOOSE_MIN);
-    pixmax1 = pixScaleGrayMinMax(pixs, sx, sy, L_CHOOSE_MAX);
+    if (pixGetTileMinMax(pixs, sx, sy, &pixmin1, &pixmax1))
+        return ERROR_INT("tile min and max not made", procName, 1);
 
     pixmin2 = pixExtendByReplication(pixmin1, 1, 1);
     pixmax2 = pixExtendByReplication(pixmax1, 1, 1);
@@ -2582,6 +2910,101 @@ PIX     *pixmin1, *pixmax1, *pixmin2, *pixmax2;
 }
 
 
+/*!
+ *  pixGetTileMinMax()
+ *
+ *      Input:  pixs (8 bpp grayscale)
+ *              sx, sy (tile dimensions)
+ *              &pixmin (<return> min value in each tile)
+ *              &pixmax (<return> max value in each tile)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This gives the same results as calling pixScaleGrayMinMax()
+ *          with L_CHOOSE_MIN and L_CHOOSE_MAX, but finds both in a
+ *          single pass over pixs.  The image is scanned a full raster
+ *          line at a time, updating the min and max for every tile
+ *          in the current row of tiles.
+ */
+static l_int32
+pixGetTileMinMax(PIX     *pixs,
+                 l_int32  sx,
+                 l_int32  sy,
+                 PIX    **ppixmin,
+                 PIX    **ppixmax)
+{
+l_int32    ws, hs, wd, hd, wpls, wpld, i, j, k, m, xoff, val, minval, maxval;
+l_int32   *mina, *maxa;
+l_uint32  *datas, *datamin, *datamax, *lines;
+PIX       *pixmin, *pixmax;
+
+    PROCNAME("pixGetTileMinMax");
+
+    *ppixmin = *ppixmax = NULL;
+    pixGetDimensions(pixs, &ws, &hs, NULL);
+    wd = ws / sx;
+    if (wd == 0) {  /* single tile */
+        wd = 1;
+        sx = ws;
+    }
+    hd = hs / sy;
+    if (hd == 0) {  /* single tile */
+        hd = 1;
+        sy = hs;
+    }
+
+    pixmin = pixCreate(wd, hd, 8);
+    pixmax = pixCreate(wd, hd, 8);
+    mina = (l_int32 *)CALLOC(wd, sizeof(l_int32));
+    maxa = (l_int32 *)CALLOC(wd, sizeof(l_int32));
+    if (!pixmin || !pixmax || !mina || !maxa) {
+        pixDestroy(&pixmin);
+        pixDestroy(&pixmax);
+        FREE(mina);
+        FREE(maxa);
+        return ERROR_INT("pixmin, pixmax or arrays not made", procName, 1);
+    }
+
+    datas = pixGetData(pixs);
+    wpls = pixGetWpl(pixs);
+    datamin = pixGetData(pixmin);
+    datamax = pixGetData(pixmax);
+    wpld = pixGetWpl(pixmin);
+    for (i = 0; i < hd; i++) {
+        for (j = 0; j < wd; j++) {
+            mina[j] = 255;
+            maxa[j] = 0;
+        }
+        for (k = 0; k < sy; k++) {
+            lines = datas + (sy * i + k) * wpls;
+            for (j = 0, xoff = 0; j < wd; j++, xoff += sx) {
+                minval = mina[j];
+                maxval = maxa[j];
+                for (m = 0; m < sx; m++) {
+                    val = GET_DATA_BYTE(lines, xoff + m);
+                    if (val < minval)
+                        minval = val;
+                    if (val > maxval)
+                        maxval = val;
+                }
+                mina[j] = minval;
+                maxa[j] = maxval;
+            }
+        }
+        for (j = 0; j < wd; j++) {
+            SET_DATA_BYTE(datamin + i * wpld, j, mina[j]);
+            SET_DATA_BYTE(datamax + i * wpld, j, maxa[j]);
+        }
+    }
+
+    FREE(mina);
+    FREE(maxa);
+    *ppixmin = pixmin;
+    *ppixmax = pixmax;
+    return 0;
+}
+
+
 /*!
  *  pixSetLowContrast()
  *
@@ -2752,6 +3175,162 @@ l_uint32  *data, *datamin, *datamax, *line, *tline, *linemin, *linemax;
 }
 
 
+/*!
+ *  pixLinearTRCTiledInterp()
+ *
+ *      Input:  pixd (<optional> 8 bpp)
+ *              pixs (8 bpp, not colormapped)
+ *              sx, sy (tile dimensions)
+ *              pixmin (pix of min values in tiles)
+ *              pixmax (pix of max values in tiles)
+ *      Return: pixd always
+ *
+ *  Notes:
+ *      (1) pixd can be equal to pixs (in-place operation) or
+ *          null (makes a new pixd).
+ *      (2) pixmin and pixmax are generated by pixMinMaxTiles().
+ *      (3) Unlike pixLinearTRCTiled(), where all pixels in a tile are
+ *          mapped with the TRC of that tile, each pixel here is mapped
+ *          with the TRCs of the four tiles whose centers surround it,
+ *          and the results are bilinearly blended, in 8 bit fixed point,
+ *          by the distance to those tile centers.  Pixels beyond the
+ *          outer tile centers use the nearest tiles.
+ *      (4) The TRCs are shared LUTs, one for each (max - min) difference,
+ *          as in pixLinearTRCTiled().  For each raster line, the min
+ *          values and LUTs of the two nearest rows of tiles are found
+ *          once, so that each pixel requires only four table lookups.
+ *      (5) A tile with (max == min) is left unchanged, as in
+ *          pixLinearTRCTiled().
+ */
+PIX *
+pixLinearTRCTiledInterp(PIX       *pixd,
+                        PIX       *pixs,
+                        l_int32    sx,
+                        l_int32    sy,
+                        PIX       *pixmin,
+                        PIX       *pixmax)
+{
+l_int32    i, j, w, h, wt, ht, wpl, wplt, it0, it1, jt, fx, fy;
+l_int32    minval, maxval, val, val0, val1, sval;
+l_int32    ident[256];
+l_int32   *xtab, *ytab, *min0, *min1;
+l_int32  **iaa, **ia0, **ia1;
+l_uint32  *data, *datamin, *datamax, *line;
+l_uint32  *linemin0, *linemax0, *linemin1, *linemax1;
+
+    PROCNAME("pixLinearTRCTiledInterp");
+
+    if (!pixs || pixGetDepth(pixs) != 8)
+        return (PIX *)ERROR_PTR("pixs undefined or not 8 bpp", procName, pixd);
+    if (pixd && pixd != pixs)
+        return (PIX *)ERROR_PTR("pixd not null or == pixs", procName, pixd);
+    if (pixGetColormap(pixs))
+        return (PIX *)ERROR_PTR("pixs is colormapped", procName, pixd);
+    if (!pixmin || !pixmax)
+        return (PIX *)ERROR_PTR("pixmin & pixmax not defined", procName, pixd);
+    if (pixSizesEqual(pixmin, pixmax) == 0)
+        return (PIX *)ERROR_PTR("pixmin & pixmax not same size",
+                                procName, pixd);
+    if (sx < 5 || sy < 5)
+        return (PIX *)ERROR_PTR("sx and/or sy less than 5", procName, pixd);
+
+    pixd = pixCopy(pixd, pixs);
+    pixGetDimensions(pixd, &w, &h, NULL);
+    pixGetDimensions(pixmin, &wt, &ht, NULL);
+    iaa = (l_int32 **)CALLOC(256, sizeof(l_int32 *));
+    xtab = makeMapInterpTable(w, sx, wt);
+    ytab = makeMapInterpTable(h, sy, ht);
+    min0 = (l_int32 *)CALLOC(wt + 1, sizeof(l_int32));
+    min1 = (l_int32 *)CALLOC(wt + 1, sizeof(l_int32));
+    ia0 = (l_int32 **)CALLOC(wt + 1, sizeof(l_int32 *));
+    ia1 = (l_int32 **)CALLOC(wt + 1, sizeof(l_int32 *));
+    if (!iaa || !xtab || !ytab || !min0 || !min1 || !ia0 || !ia1) {
+        L_ERROR("arrays not made", procName);
+        goto cleanup;
+    }
+    for (i = 0; i < 256; i++)
+        ident[i] = i;
+
+    data = pixGetData(pixd);
+    wpl = pixGetWpl(pixd);
+    datamin = pixGetData(pixmin);
+    datamax = pixGetData(pixmax);
+    wplt = pixGetWpl(pixmin);
+    it0 = it1 = -1;
+    for (i = 0; i < h; i++) {
+            /* Update the min values and TRCs of the two rows of tiles
+             * when they change.  The extra entry at the end of each
+             * array duplicates the last tile. */
+        if ((ytab[i] >> 8) != it0) {
+            it0 = ytab[i] >> 8;
+            it1 = L_MIN(it0 + 1, ht - 1);
+            linemin0 = datamin + it0 * wplt;
+            linemax0 = datamax + it0 * wplt;
+            linemin1 = datamin + it1 * wplt;
+            linemax1 = datamax + it1 * wplt;
+            for (j = 0; j < wt; j++) {
+                minval = GET_DATA_BYTE(linemin0, j);
+                maxval = GET_DATA_BYTE(linemax0, j);
+                if (maxval == minval) {
+                    min0[j] = 0;
+                    ia0[j] = ident;
+                }
+                else {
+                    min0[j] = minval;
+                    ia0[j] = iaaGetLinearTRC(iaa, maxval - minval);
+                }
+                minval = GET_DATA_BYTE(linemin1, j);
+                maxval = GET_DATA_BYTE(linemax1, j);
+                if (maxval == minval) {
+                    min1[j] = 0;
+                    ia1[j] = ident;
+                }
+                else {
+                    min1[j] = minval;
+                    ia1[j] = iaaGetLinearTRC(iaa, maxval - minval);
+                }
+            }
+            min0[wt] = min0[wt - 1];
+            min1[wt] = min1[wt - 1];
+            ia0[wt] = ia0[wt - 1];
+            ia1[wt] = ia1[wt - 1];
+        }
+        fy = ytab[i] & 0xff;
+
+        line = data + i * wpl;
+        for (j = 0; j < w; j++) {
+            jt = xtab[j] >> 8;
+            fx = xtab[j] & 0xff;
+            val = GET_DATA_BYTE(line, j);
+            sval = L_MAX(0, val - min0[jt]);
+            val0 = (256 - fx) * ia0[jt][sval];
+            sval = L_MAX(0, val - min0[jt + 1]);
+            val0 += fx * ia0[jt + 1][sval];
+            sval = L_MAX(0, val - min1[jt]);
+            val1 = (256 - fx) * ia1[jt][sval];
+            sval = L_MAX(0, val - min1[jt + 1]);
+            val1 += fx * ia1[jt + 1][sval];
+            val = ((256 - fy) * val0 + fy * val1 + 32768) >> 16;
+            SET_DATA_BYTE(line, j, val);
+        }
+    }
+
+cleanup:
+    if (iaa) {
+        for (i = 0; i < 256; i++)
+            if (iaa[i]) FREE(iaa[i]);
+        FREE(iaa);
+    }
+    FREE(xtab);
+    FREE(ytab);
+    FREE(min0);
+    FREE(min1);
+    FREE(ia0);
+    FREE(ia1);
+    return pixd;
+}
+
+
 /*!
  *  iaaGetLinearTRC()
  *
@@ -45,6 +45,9 @@
  *      Interpolation helper functions
  *           l_int32     linearInterpolatePixelGray()
  *           l_int32     linearInterpolatePixelColor()
+ *           l_int32     getXformRowSpan()
+ *           l_int32     linearInterpolateRowGray()
+ *           l_int32     linearInterpolateRowColor()
  *
  *      Gauss-jordan linear equation solver
  *           l_int32     gaussjordan()
@@ -577,10 +580,9 @@ pixAffineColor(PIX        *pixs,
                l_float32  *vc,
                l_uint32    colorval)
 {
-l_int32    i, j, w, h, d, wpls, wpld;
-l_uint32   val;
+l_int32    i, w, h, d, wpls, wpld, jmin, jmax;
 l_uint32  *datas, *datad, *lined;
-l_float32  x, y;
+l_float64  vr[6];
 PIX       *pixd;
 
     PROCNAME("pixAffineColor");
@@ -600,16 +602,18 @@ PIX       *pixd;
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
 
-        /* Iterate over destination pixels */
+        /* Iterate over destination rows, interpolating over the
+         * span of dest pixels in each row that map inside pixs */
     for (i = 0; i < h; i++) {
         lined = datad + i * wpld;
-        for (j = 0; j < w; j++) {
-                /* Compute float src pixel location corresponding to (i,j) */
-            affineXformPt(vc, j, i, &x, &y);
-            linearInterpolatePixelColor(datas, wpls, w, h, x, y, colorval,
-                                        &val);
-            *(lined + j) = val;
-        }
+        vr[0] = vc[1] * i + vc[2];
+        vr[1] = vc[0];
+        vr[2] = vc[4] * i + vc[5];
+        vr[3] = vc[3];
+        vr[4] = 1.0;
+        vr[5] = 0.0;
+        getXformRowSpan(vr, w, w, h, &jmin, &jmax);
+        linearInterpolateRowColor(datas, wpls, lined, jmin, jmax, vr);
     }
 
     return pixd;
@@ -672,9 +676,9 @@ pixAffineGray(PIX        *pixs,
               l_float32  *vc,
               l_uint8     grayval)
 {
-l_int32    i, j, w, h, wpls, wpld, val;
+l_int32    i, w, h, wpls, wpld, jmin, jmax;
 l_uint32  *datas, *datad, *lined;
-l_float32  x, y;
+l_float64  vr[6];
 PIX       *pixd;
 
     PROCNAME("pixAffineGray");
@@ -694,15 +698,18 @@ PIX       *pixd;
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
 
-        /* Iterate over destination pixels */
+        /* Iterate over destination rows, interpolating over the
+         * span of dest pixels in each row that map inside pixs */
     for (i = 0; i < h; i++) {
         lined = datad + i * wpld;
-        for (j = 0; j < w; j++) {
-                /* Compute float src pixel location corresponding to (i,j) */
-            affineXformPt(vc, j, i, &x, &y);
-            linearInterpolatePixelGray(datas, wpls, w, h, x, y, grayval, &val);
-            SET_DATA_BYTE(lined, j, val);
-        }
+        vr[0] = vc[1] * i + vc[2];
+        vr[1] = vc[0];
+        vr[2] = vc[4] * i + vc[5];
+        vr[3] = vc[3];
+        vr[4] = 1.0;
+        vr[5] = 0.0;
+        getXformRowSpan(vr, w, w, h, &jmin, &jmax);
+        linearInterpolateRowGray(datas, wpls, lined, jmin, jmax, vr);
     }
 
     return pixd;
@@ -1311,6 +1318,273 @@ l_uint32  *lines;
 }
 
 
+/*!
+ *  getXformRowSpan()
+ *
+ *      Input:  vr (6 row coefficients; see notes)
+ *              wd (width of dest row)
+ *              w, h (of src image)
+ *              &jmin, &jmax (<return> range of dest pixels in the row
+ *                            that map to valid src locations)
+ *      Return: 0 if OK, 1 if the row can't be handled by span
+ *
+ *  Notes:
+ *      (1) The src location of the dest pixel at j in the row is
+ *              x = (vr[0] + j * vr[1]) / (vr[4] + j * vr[5])
+ *              y = (vr[2] + j * vr[3]) / (vr[4] + j * vr[5])
+ *          For affine and bilinear transforms, the denominator is 1,
+ *          and x and y are linear in j.  For projective transforms,
+ *          the numerators and denominator are all linear in j.
+ *      (2) The valid src locations, where linear interpolation can be
+ *          done, are 0 <= x <= w - 2 and 0 <= y <= h - 2.  When the
+ *          denominator is positive, each of these is a linear inequality
+ *          in j, so the dest pixels that map inside the src form a
+ *          single span, which is found here once for the row.  The
+ *          span is empty if jmin > jmax.
+ *      (3) If the denominator is not positive over the whole row,
+ *          this returns 1 and the row must be done pixel by pixel.
+ *      (4) The ends of the span are checked with the same fixed point
+ *          arithmetic used by linearInterpolateRow*(), so no pixel
+ *          in the span reads outside the src.
+ */
+l_int32
+getXformRowSpan(l_float64  *vr,
+                l_int32     wd,
+                l_int32     w,
+                l_int32     h,
+                l_int32    *pjmin,
+                l_int32    *pjmax)
+{
+l_int32    k, jmin, jmax, xpm, ypm;
+l_float64  p, q, jlim, factor;
+l_float64  pv[4], qv[4];
+
+    PROCNAME("getXformRowSpan");
+
+    if (!pjmin || !pjmax)
+        return ERROR_INT("&jmin and &jmax not both defined", procName, 1);
+    *pjmin = 0;
+    *pjmax = -1;
+    if (!vr)
+        return ERROR_INT("vr not defined", procName, 1);
+    if (vr[4] <= 0.0 || vr[4] + (wd - 1) * vr[5] <= 0.0)
+        return 1;
+    if (w < 2 || h < 2)
+        return 0;
+
+        /* Each constraint is p + j * q >= 0 */
+    pv[0] = vr[0];
+    qv[0] = vr[1];
+    pv[1] = (w - 2) * vr[4] - vr[0];
+    qv[1] = (w - 2) * vr[5] - vr[1];
+    pv[2] = vr[2];
+    qv[2] = vr[3];
+    pv[3] = (h - 2) * vr[4] - vr[2];
+    qv[3] = (h - 2) * vr[5] - vr[3];
+    jmin = 0;
+    jmax = wd - 1;
+    for (k = 0; k < 4; k++) {
+        p = pv[k];
+        q = qv[k];
+        if (q == 0.0) {
+            if (p < 0.0)
+                return 0;
+            continue;
+        }
+        jlim = -p / q;
+        if (q > 0.0 && jlim > jmin)
+            jmin = (jlim > wd) ? wd : (l_int32)ceil(jlim);
+        else if (q < 0.0 && jlim < jmax)
+            jmax = (jlim < -1) ? -1 : (l_int32)floor(jlim);
+    }
+
+        /* Trim the ends to guard against roundoff */
+    for (; jmin <= jmax; jmin++) {
+        factor = 16.0 / (vr[4] + jmin * vr[5]);
+        xpm = (l_int32)(factor * (vr[0] + jmin * vr[1]) + 0.5);
+        ypm = (l_int32)(factor * (vr[2] + jmin * vr[3]) + 0.5);
+        if (xpm >= 0 && ypm >= 0 && xpm < 16 * (w - 1) && ypm < 16 * (h - 1))
+            break;
+    }
+    for (; jmax >= jmin; jmax--) {
+        factor = 16.0 / (vr[4] + jmax * vr[5]);
+        xpm = (l_int32)(factor * (vr[0] + jmax * vr[1]) + 0.5);
+        ypm = (l_int32)(factor * (vr[2] + jmax * vr[3]) + 0.5);
+        if (xpm >= 0 && ypm >= 0 && xpm < 16 * (w - 1) && ypm < 16 * (h - 1))
+            break;
+    }
+
+    *pjmin = jmin;
+    *pjmax = jmax;
+    return 0;
+}
+
+
+/*!
+ *  linearInterpolateRowGray()
+ *
+ *      Input:  datas (ptr to beginning of 8 bpp src image data)
+ *              wpls (32-bit word/line for src)
+ *              lined (ptr to dest line)
+ *              jmin, jmax (span of dest pixels to be interpolated)
+ *              vr (6 row coefficients, as in getXformRowSpan())
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This does the same linear interpolation as
+ *          linearInterpolatePixelGray() on each pixel of the span,
+ *          which must have been found with getXformRowSpan().  Because
+ *          every pixel in the span maps inside the src, there are no
+ *          bounds tests, and the src location is found by stepping
+ *          along the row rather than by a full transform for each pixel.
+ *      (2) When the denominator is constant (affine and bilinear),
+ *          there is no division in the loop.
+ */
+l_int32
+linearInterpolateRowGray(l_uint32   *datas,
+                         l_int32     wpls,
+                         l_uint32   *lined,
+                         l_int32     jmin,
+                         l_int32     jmax,
+                         l_float64  *vr)
+{
+l_int32    j, xpm, ypm, xp, yp, xf, yf, v00, v10, v01, v11;
+l_float64  x0, dx, y0, dy, z0, dz, factor;
+l_uint32  *lines;
+
+    PROCNAME("linearInterpolateRowGray");
+
+    if (!datas || !lined || !vr)
+        return ERROR_INT("datas, lined and vr not all defined", procName, 1);
+
+        /* Src coords in units of 1/16 pixel, with rounding offset */
+    z0 = vr[4];
+    dz = vr[5];
+    x0 = 16.0 * vr[0];
+    dx = 16.0 * vr[1];
+    y0 = 16.0 * vr[2];
+    dy = 16.0 * vr[3];
+    if (dz == 0.0) {
+        x0 = x0 / z0 + 0.5;
+        dx = dx / z0;
+        y0 = y0 / z0 + 0.5;
+        dy = dy / z0;
+    }
+
+    for (j = jmin; j <= jmax; j++) {
+        if (dz == 0.0) {
+            xpm = (l_int32)(x0 + j * dx);
+            ypm = (l_int32)(y0 + j * dy);
+        }
+        else {
+            factor = 1.0 / (z0 + j * dz);
+            xpm = (l_int32)(factor * (x0 + j * dx) + 0.5);
+            ypm = (l_int32)(factor * (y0 + j * dy) + 0.5);
+        }
+        xp = xpm >> 4;
+        yp = ypm >> 4;
+        xf = xpm & 0x0f;
+        yf = ypm & 0x0f;
+        lines = datas + yp * wpls;
+        v00 = (16 - xf) * (16 - yf) * GET_DATA_BYTE(lines, xp);
+        v10 = xf * (16 - yf) * GET_DATA_BYTE(lines, xp + 1);
+        v01 = (16 - xf) * yf * GET_DATA_BYTE(lines + wpls, xp);
+        v11 = xf * yf * GET_DATA_BYTE(lines + wpls, xp + 1);
+        SET_DATA_BYTE(lined, j, (v00 + v01 + v10 + v11 + 128) / 256);
+    }
+
+    return 0;
+}
+
+
+/*!
+ *  linearInterpolateRowColor()
+ *
+ *      Input:  datas (ptr to beginning of 32 bpp src image data)
+ *              wpls (32-bit word/line for src)
+ *              lined (ptr to dest line)
+ *              jmin, jmax (span of dest pixels to be interpolated)
+ *              vr (6 row coefficients, as in getXformRowSpan())
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This is the rgb version of linearInterpolateRowGray().
+ */
+l_int32
+linearInterpolateRowColor(l_uint32   *datas,
+                          l_int32     wpls,
+                          l_uint32   *lined,
+                          l_int32     jmin,
+                          l_int32     jmax,
+                          l_float64  *vr)
+{
+l_int32    j, xpm, ypm, xp, yp, xf, yf, f00, f10, f01, f11;
+l_int32    rval, gval, bval;
+l_uint32   word00, word01, word10, word11;
+l_float64  x0, dx, y0, dy, z0, dz, factor;
+l_uint32  *lines;
+
+    PROCNAME("linearInterpolateRowColor");
+
+    if (!datas || !lined || !vr)
+        return ERROR_INT("datas, lined and vr not all defined", procName, 1);
+
+    z0 = vr[4];
+    dz = vr[5];
+    x0 = 16.0 * vr[0];
+    dx = 16.0 * vr[1];
+    y0 = 16.0 * vr[2];
+    dy = 16.0 * vr[3];
+    if (dz == 0.0) {
+        x0 = x0 / z0 + 0.5;
+        dx = dx / z0;
+        y0 = y0 / z0 + 0.5;
+        dy = dy / z0;
+    }
+
+    for (j = jmin; j <= jmax; j++) {
+        if (dz == 0.0) {
+            xpm = (l_int32)(x0 + j * dx);
+            ypm = (l_int32)(y0 + j * dy);
+        }
+        else {
+            factor = 1.0 / (z0 + j * dz);
+            xpm = (l_int32)(factor * (x0 + j * dx) + 0.5);
+            ypm = (l_int32)(factor * (y0 + j * dy) + 0.5);
+        }
+        xp = xpm >> 4;
+        yp = ypm >> 4;
+        xf = xpm & 0x0f;
+        yf = ypm & 0x0f;
+        f00 = (16 - xf) * (16 - yf);
+        f10 = xf * (16 - yf);
+        f01 = (16 - xf) * yf;
+        f11 = xf * yf;
+        lines = datas + yp * wpls;
+        word00 = *(lines + xp);
+        word10 = *(lines + xp + 1);
+        word01 = *(lines + wpls + xp);
+        word11 = *(lines + wpls + xp + 1);
+        rval = (f00 * ((word00 >> L_RED_SHIFT) & 0xff) +
+                f10 * ((word10 >> L_RED_SHIFT) & 0xff) +
+                f01 * ((word01 >> L_RED_SHIFT) & 0xff) +
+                f11 * ((word11 >> L_RED_SHIFT) & 0xff) + 128) / 256;
+        gval = (f00 * ((word00 >> L_GREEN_SHIFT) & 0xff) +
+                f10 * ((word10 >> L_GREEN_SHIFT) & 0xff) +
+                f01 * ((word01 >> L_GREEN_SHIFT) & 0xff) +
+                f11 * ((word11 >> L_GREEN_SHIFT) & 0xff) + 128) / 256;
+        bval = (f00 * ((word00 >> L_BLUE_SHIFT) & 0xff) +
+                f10 * ((word10 >> L_BLUE_SHIFT) & 0xff) +
+                f01 * ((word01 >> L_BLUE_SHIFT) & 0xff) +
+                f11 * ((word11 >> L_BLUE_SHIFT) & 0xff) + 128) / 256;
+        *(lined + j) = (rval << L_RED_SHIFT) | (gval << L_GREEN_SHIFT) |
+                       (bval << L_BLUE_SHIFT);
+    }
+
+    return 0;
+}
+
+
 
 /*-------------------------------------------------------------*
  *               Gauss-jordan linear equation solver           *
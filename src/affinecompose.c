@@ -20,6 +20,8 @@
  *           l_float32   *createMatrix2dTranslate()
  *           l_float32   *createMatrixScale()
  *           l_float32   *createMatrixRotate()
+ *           l_float32   *createMatrix2dAffine()
+ *           l_float32   *createMatrix2dProjective()
  *
  *      Special coordinate transforms on pta
  *           PTA         *ptaTranslate()
@@ -35,6 +37,12 @@
  *           PTA         *ptaAffineTransform()
  *           BOXA        *boxaAffineTransform()
  *
+ *      Image transform by a composed matrix
+ *           PIX         *pixTransformByMatrix()
+ *    static PIX         *pixTransformSampledByMatrix()
+ *    static PIX         *pixTransformLIByMatrix()
+ *    static l_int32      invertMatrix2d()
+ *
  *      Matrix operations
  *           l_int32      l_productMatVec()
  *           l_int32      l_productMat2()
@@ -47,6 +55,12 @@
 #include <math.h>
 #include "allheaders.h"
 
+static PIX *pixTransformSampledByMatrix(PIX *pixs, l_float64 *mi, l_int32 wd,
+                                        l_int32 hd, l_int32 incolor);
+static PIX *pixTransformLIByMatrix(PIX *pixs, l_float64 *mi, l_int32 wd,
+                                   l_int32 hd, l_int32 incolor);
+static l_int32 invertMatrix2d(l_float32 *mat, l_float64 *mi);
+
 
 /*-------------------------------------------------------------*
  *                Composable coordinate transforms             *
@@ -188,6 +202,80 @@ l_float32  *mat;
 }
 
 
+/*!
+ *  createMatrix2dAffine()
+ *
+ *      Input:  vc  (vector of 6 affine coefficients)
+ *      Return: 3x3 transform matrix, or null on error
+ *
+ *  Notes;
+ *      (1) This puts the coefficients of an affine transform, as
+ *          computed by getAffineXformCoeffs(), in canonical form:
+ *             A = [ vc[0]  vc[1]  vc[2]
+ *                   vc[3]  vc[4]  vc[5]
+ *                     0      0      1   ]
+ *      (2) getAffineXformCoeffs(ptas, ptad, &vc) gives the transform
+ *          from src to dest, which is the direction used for composing
+ *          matrices.  Note that pixAffine() takes the inverse, from
+ *          getAffineXformCoeffs(ptad, ptas, &vc).
+ */
+l_float32 *
+createMatrix2dAffine(l_float32  *vc)
+{
+l_int32     i;
+l_float32  *mat;
+
+    PROCNAME("createMatrix2dAffine");
+
+    if (!vc)
+        return (l_float32 *)ERROR_PTR("vc not defined", procName, NULL);
+    if ((mat = (l_float32 *)CALLOC(9, sizeof(l_float32))) == NULL)
+        return (l_float32 *)ERROR_PTR("mat not made", procName, NULL);
+
+    for (i = 0; i < 6; i++)
+        mat[i] = vc[i];
+    mat[8] = 1;
+    return mat;
+}
+
+
+/*!
+ *  createMatrix2dProjective()
+ *
+ *      Input:  vc  (vector of 8 projective coefficients)
+ *      Return: 3x3 transform matrix, or null on error
+ *
+ *  Notes;
+ *      (1) This puts the coefficients of a projective transform, as
+ *          computed by getProjectiveXformCoeffs(), in canonical form:
+ *             A = [ vc[0]  vc[1]  vc[2]
+ *                   vc[3]  vc[4]  vc[5]
+ *                   vc[6]  vc[7]    1   ]
+ *          The transformed point is found by dividing the first two
+ *          components of v' = Av by the third.
+ *      (2) As with createMatrix2dAffine(), use the coefficients for the
+ *          transform from src to dest.
+ */
+l_float32 *
+createMatrix2dProjective(l_float32  *vc)
+{
+l_int32     i;
+l_float32  *mat;
+
+    PROCNAME("createMatrix2dProjective");
+
+    if (!vc)
+        return (l_float32 *)ERROR_PTR("vc not defined", procName, NULL);
+    if ((mat = (l_float32 *)CALLOC(9, sizeof(l_float32))) == NULL)
+        return (l_float32 *)ERROR_PTR("mat not made", procName, NULL);
+
+    for (i = 0; i < 8; i++)
+        mat[i] = vc[i];
+    mat[8] = 1;
+    return mat;
+}
+
+
 
 /*-------------------------------------------------------------*
  *            Special coordinate transforms on pta             *
@@ -481,6 +569,299 @@ BOXA  *boxad;
 }
 
 
+/*-------------------------------------------------------------*
+ *             Image transform by a composed matrix            *
+ *-------------------------------------------------------------*/
+/*!
+ *  pixTransformByMatrix()
+ *
+ *      Input:  pixs (all depths; colormap ok)
+ *              mat  (3x3 transform matrix from src to dest)
+ *              wd, hd (size of dest; use 0 for the size of pixs)
+ *              type (L_INTERPOLATED, L_SAMPLED)
+ *              incolor (L_BRING_IN_WHITE, L_BRING_IN_BLACK)
+ *      Return: pixd, or null on error
+ *
+ *  Notes:
+ *      (1) This does a sequence of rotations, scalings, translations,
+ *          affine and projective transforms with a single resampling
+ *          of pixs.  Make the matrix for each step with createMatrix2d*(),
+ *          and compose them with l_productMat*(), with the last step
+ *          first.  For example, to rotate, then do a projective
+ *          transform, then scale:
+ *              l_productMat3(matscale, matproj, matrot, mat, 3);
+ *          Compared with doing each step separately, this avoids the
+ *          intermediate images and the blurring of repeated
+ *          interpolation.
+ *      (2) The matrix is inverted, and each dest pixel is found from
+ *          its location in pixs.  The rows are done as in
+ *          pixProjectiveGray(), over the span of each row that maps
+ *          inside pixs.
+ *      (3) A dest size can be given so that, e.g., scaling doesn't
+ *          clip or pad the result.
+ *      (4) As with pixProjective(), 1 bpp images are always sampled,
+ *          and for interpolation a colormap is removed and images of
+ *          less than 8 bpp are converted to 8 bpp.
+ */
+PIX *
+pixTransformByMatrix(PIX        *pixs,
+                     l_float32  *mat,
+                     l_int32     wd,
+                     l_int32     hd,
+                     l_int32     type,
+                     l_int32     incolor)
+{
+l_float64  mi[9];
+
+    PROCNAME("pixTransformByMatrix");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (!mat)
+        return (PIX *)ERROR_PTR("mat not defined", procName, NULL);
+    if (type != L_INTERPOLATED && type != L_SAMPLED)
+        return (PIX *)ERROR_PTR("invalid type", procName, NULL);
+    if (incolor != L_BRING_IN_WHITE && incolor != L_BRING_IN_BLACK)
+        return (PIX *)ERROR_PTR("invalid incolor", procName, NULL);
+    if (wd <= 0 || hd <= 0)
+        pixGetDimensions(pixs, &wd, &hd, NULL);
+
+    if (invertMatrix2d(mat, mi))
+        return (PIX *)ERROR_PTR("mat not invertible", procName, NULL);
+
+    if (type == L_SAMPLED || pixGetDepth(pixs) == 1)
+        return pixTransformSampledByMatrix(pixs, mi, wd, hd, incolor);
+    else
+        return pixTransformLIByMatrix(pixs, mi, wd, hd, incolor);
+}
+
+
+/*!
+ *  pixTransformSampledByMatrix()
+ *
+ *      Input:  pixs (all depths)
+ *              mi (inverse 3x3 matrix, from dest to src)
+ *              wd, hd (size of dest)
+ *              incolor (L_BRING_IN_WHITE, L_BRING_IN_BLACK)
+ *      Return: pixd, or null on error
+ */
+static PIX *
+pixTransformSampledByMatrix(PIX        *pixs,
+                            l_float64  *mi,
+                            l_int32     wd,
+                            l_int32     hd,
+                            l_int32     incolor)
+{
+l_int32    i, j, w, h, d, x, y, wpls, wpld, color, cmapindex;
+l_uint32   val;
+l_uint32  *datas, *datad, *lines, *lined;
+l_float64  xn, yn, zn;
+PIX       *pixd;
+PIXCMAP   *cmap;
+
+    PROCNAME("pixTransformSampledByMatrix");
+
+    pixGetDimensions(pixs, &w, &h, &d);
+    if (d != 1 && d != 2 && d != 4 && d != 8 && d != 32)
+        return (PIX *)ERROR_PTR("depth not 1, 2, 4, 8 or 32", procName, NULL);
+    if ((pixd = pixCreate(wd, hd, d)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
+    pixCopyResolution(pixd, pixs);
+    pixCopyColormap(pixd, pixs);
+
+        /* Init all dest pixels to color to be brought in from outside */
+    if ((cmap = pixGetColormap(pixd)) != NULL) {
+        color = (incolor == L_BRING_IN_WHITE) ? 1 : 0;
+        pixcmapAddBlackOrWhite(cmap, color, &cmapindex);
+        pixSetAllArbitrary(pixd, cmapindex);
+    }
+    else {
+        if ((d == 1 && incolor == L_BRING_IN_WHITE) ||
+            (d > 1 && incolor == L_BRING_IN_BLACK))
+            pixClearAll(pixd);
+        else
+            pixSetAll(pixd);
+    }
+
+    datas = pixGetData(pixs);
+    wpls = pixGetWpl(pixs);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    for (i = 0; i < hd; i++) {
+        lined = datad + i * wpld;
+        for (j = 0; j < wd; j++) {
+            zn = mi[6] * j + mi[7] * i + mi[8];
+            if (zn == 0.0)
+                continue;
+            xn = (mi[0] * j + mi[1] * i + mi[2]) / zn;
+            yn = (mi[3] * j + mi[4] * i + mi[5]) / zn;
+            if (xn < -0.5 || yn < -0.5 || xn >= w - 0.5 || yn >= h - 0.5)
+                continue;
+            x = (l_int32)(xn + 0.5);
+            y = (l_int32)(yn + 0.5);
+            lines = datas + y * wpls;
+            if (d == 1) {
+                val = GET_DATA_BIT(lines, x);
+                SET_DATA_BIT_VAL(lined, j, val);
+            }
+            else if (d == 8) {
+                val = GET_DATA_BYTE(lines, x);
+                SET_DATA_BYTE(lined, j, val);
+            }
+            else if (d == 32) {
+                lined[j] = lines[x];
+            }
+            else if (d == 2) {
+                val = GET_DATA_DIBIT(lines, x);
+                SET_DATA_DIBIT(lined, j, val);
+            }
+            else if (d == 4) {
+                val = GET_DATA_QBIT(lines, x);
+                SET_DATA_QBIT(lined, j, val);
+            }
+        }
+    }
+
+    return pixd;
+}
+
+
+/*!
+ *  pixTransformLIByMatrix()
+ *
+ *      Input:  pixs (2, 4, 8 or 32 bpp; colormap ok)
+ *              mi (inverse 3x3 matrix, from dest to src)
+ *              wd, hd (size of dest)
+ *              incolor (L_BRING_IN_WHITE, L_BRING_IN_BLACK)
+ *      Return: pixd, or null on error
+ */
+static PIX *
+pixTransformLIByMatrix(PIX        *pixs,
+                       l_float64  *mi,
+                       l_int32     wd,
+                       l_int32     hd,
+                       l_int32     incolor)
+{
+l_int32    i, j, k, w, h, d, wpls, wpld, jmin, jmax, val;
+l_uint32   colorval, cval;
+l_uint32  *datas, *datad, *lined;
+l_float32  x, y;
+l_float64  vr[6];
+PIX       *pixt1, *pixt2, *pixd;
+
+    PROCNAME("pixTransformLIByMatrix");
+
+        /* Remove cmap if it exists, and unpack to 8 bpp if necessary */
+    pixt1 = pixRemoveColormap(pixs, REMOVE_CMAP_BASED_ON_SRC);
+    if (pixGetDepth(pixt1) < 8)
+        pixt2 = pixConvertTo8(pixt1, FALSE);
+    else
+        pixt2 = pixClone(pixt1);
+    pixDestroy(&pixt1);
+    pixGetDimensions(pixt2, &w, &h, &d);
+    if (d != 8 && d != 32) {
+        pixDestroy(&pixt2);
+        return (PIX *)ERROR_PTR("depth not 8 or 32 after conversion",
+                                procName, NULL);
+    }
+
+        /* Compute actual color to bring in from edges */
+    colorval = 0;
+    if (incolor == L_BRING_IN_WHITE)
+        colorval = (d == 8) ? 255 : 0xffffff00;
+
+    if ((pixd = pixCreate(wd, hd, d)) == NULL) {
+        pixDestroy(&pixt2);
+        return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
+    }
+    pixCopyResolution(pixd, pixs);
+    pixSetAllArbitrary(pixd, colorval);
+    datas = pixGetData(pixt2);
+    wpls = pixGetWpl(pixt2);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+
+        /* Iterate over dest rows, as in pixProjectiveGray() */
+    for (i = 0; i < hd; i++) {
+        lined = datad + i * wpld;
+        vr[0] = mi[1] * i + mi[2];
+        vr[1] = mi[0];
+        vr[2] = mi[4] * i + mi[5];
+        vr[3] = mi[3];
+        vr[4] = mi[7] * i + mi[8];
+        vr[5] = mi[6];
+        if (vr[4] < 0.0) {  /* make the denominator positive at j = 0 */
+            for (k = 0; k < 6; k++)
+                vr[k] = -vr[k];
+        }
+        if (getXformRowSpan(vr, wd, w, h, &jmin, &jmax) == 0) {
+            if (d == 8)
+                linearInterpolateRowGray(datas, wpls, lined, jmin, jmax, vr);
+            else
+                linearInterpolateRowColor(datas, wpls, lined, jmin, jmax, vr);
+            continue;
+        }
+        for (j = 0; j < wd; j++) {
+            if (vr[4] + j * vr[5] == 0.0)
+                continue;
+            x = (vr[0] + j * vr[1]) / (vr[4] + j * vr[5]);
+            y = (vr[2] + j * vr[3]) / (vr[4] + j * vr[5]);
+            if (d == 8) {
+                linearInterpolatePixelGray(datas, wpls, w, h, x, y,
+                                           colorval, &val);
+                SET_DATA_BYTE(lined, j, val);
+            }
+            else {
+                linearInterpolatePixelColor(datas, wpls, w, h, x, y,
+                                            colorval, &cval);
+                lined[j] = cval;
+            }
+        }
+    }
+
+    pixDestroy(&pixt2);
+    return pixd;
+}
+
+
+/*!
+ *  invertMatrix2d()
+ *
+ *      Input:  mat (3x3 transform matrix)
+ *              mi (<return> inverse 3x3 matrix; 9 doubles)
+ *      Return: 0 if OK, 1 if the matrix is singular
+ *
+ *  Notes:
+ *      (1) This uses the adjugate; the inverse is only needed up to
+ *          a scale factor for a projective transform, but we scale
+ *          it so that mi[8] == 1 when possible.
+ */
+static l_int32
+invertMatrix2d(l_float32  *mat,
+               l_float64  *mi)
+{
+l_int32    k;
+l_float64  det, norm;
+
+    mi[0] = (l_float64)mat[4] * mat[8] - (l_float64)mat[5] * mat[7];
+    mi[1] = (l_float64)mat[2] * mat[7] - (l_float64)mat[1] * mat[8];
+    mi[2] = (l_float64)mat[1] * mat[5] - (l_float64)mat[2] * mat[4];
+    mi[3] = (l_float64)mat[5] * mat[6] - (l_float64)mat[3] * mat[8];
+    mi[4] = (l_float64)mat[0] * mat[8] - (l_float64)mat[2] * mat[6];
+    mi[5] = (l_float64)mat[2] * mat[3] - (l_float64)mat[0] * mat[5];
+    mi[6] = (l_float64)mat[3] * mat[7] - (l_float64)mat[4] * mat[6];
+    mi[7] = (l_float64)mat[1] * mat[6] - (l_float64)mat[0] * mat[7];
+    mi[8] = (l_float64)mat[0] * mat[4] - (l_float64)mat[1] * mat[3];
+    det = mat[0] * mi[0] + mat[1] * mi[3] + mat[2] * mi[6];
+    if (det == 0.0)
+        return 1;
+    norm = (mi[8] != 0.0) ? mi[8] : det;
+    for (k = 0; k < 9; k++)
+        mi[k] /= norm;
+    return 0;
+}
+
+
 /*-------------------------------------------------------------*
  *                      Matrix operations                      *
  *-------------------------------------------------------------*/
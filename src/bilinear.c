@@ -439,10 +439,9 @@ pixBilinearColor(PIX        *pixs,
                  l_float32  *vc,
                  l_uint32    colorval)
 {
-l_int32    i, j, w, h, d, wpls, wpld;
-l_uint32   val;
+l_int32    i, w, h, d, wpls, wpld, jmin, jmax;
 l_uint32  *datas, *datad, *lined;
-l_float32  x, y;
+l_float64  vr[6];
 PIX       *pixd;
 
     PROCNAME("pixBilinearColor");
@@ -462,16 +461,18 @@ PIX       *pixd;
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
 
-        /* Iterate over destination pixels */
+        /* Iterate over destination rows, interpolating over the
+         * span of dest pixels in each row that map inside pixs */
     for (i = 0; i < h; i++) {
         lined = datad + i * wpld;
-        for (j = 0; j < w; j++) {
-                /* Compute float src pixel location corresponding to (i,j) */
-            bilinearXformPt(vc, j, i, &x, &y);
-            linearInterpolatePixelColor(datas, wpls, w, h, x, y, colorval,
-                                        &val);
-            *(lined + j) = val;
-        }
+        vr[0] = vc[1] * i + vc[3];
+        vr[1] = vc[0] + vc[2] * i;
+        vr[2] = vc[5] * i + vc[7];
+        vr[3] = vc[4] + vc[6] * i;
+        vr[4] = 1.0;
+        vr[5] = 0.0;
+        getXformRowSpan(vr, w, w, h, &jmin, &jmax);
+        linearInterpolateRowColor(datas, wpls, lined, jmin, jmax, vr);
     }
 
     return pixd;
@@ -533,9 +534,9 @@ pixBilinearGray(PIX        *pixs,
                 l_float32  *vc,
                 l_uint8     grayval)
 {
-l_int32    i, j, w, h, wpls, wpld, val;
+l_int32    i, w, h, wpls, wpld, jmin, jmax;
 l_uint32  *datas, *datad, *lined;
-l_float32  x, y;
+l_float64  vr[6];
 PIX       *pixd;
 
     PROCNAME("pixBilinearGray");
@@ -555,15 +556,18 @@ PIX       *pixd;
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
 
-        /* Iterate over destination pixels */
+        /* Iterate over destination rows, interpolating over the
+         * span of dest pixels in each row that map inside pixs */
     for (i = 0; i < h; i++) {
         lined = datad + i * wpld;
-        for (j = 0; j < w; j++) {
-                /* Compute float src pixel location corresponding to (i,j) */
-            bilinearXformPt(vc, j, i, &x, &y);
-            linearInterpolatePixelGray(datas, wpls, w, h, x, y, grayval, &val);
-            SET_DATA_BYTE(lined, j, val);
-        }
+        vr[0] = vc[1] * i + vc[3];
+        vr[1] = vc[0] + vc[2] * i;
+        vr[2] = vc[5] * i + vc[7];
+        vr[3] = vc[4] + vc[6] * i;
+        vr[4] = 1.0;
+        vr[5] = 0.0;
+        getXformRowSpan(vr, w, w, h, &jmin, &jmax);
+        linearInterpolateRowGray(datas, wpls, lined, jmin, jmax, vr);
     }
 
     return pixd;
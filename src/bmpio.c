@@ -18,6 +18,7 @@
  *
  *      Read bmp from file
  *           PIX          *pixReadStreamBmp()
+ *           l_int32       sreadHeaderBmp()
  *
  *      Write bmp to file
  *           l_int32       pixWriteStreamBmp()
@@ -280,6 +281,88 @@ PIXCMAP   *cmap;
 
 
 
+/*!
+ *  sreadHeaderBmp()
+ *
+ *      Input:  data (bmp file data)
+ *              size (of data, in bytes)
+ *              &width (<return>)
+ *              &height (<return>)
+ *              &bps (<return>, bits/sample)
+ *              &spp (<return>, samples/pixel)
+ *              &iscmap (<optional return>; input NULL to ignore)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This parses only the file and info headers, and returns the
+ *          values for the pix that pixReadStreamBmp() would make.
+ *          24 and 32 bpp images are both read into 32 bpp rgb, and
+ *          are returned with 8 bps and 3 spp.
+ *      (2) The headers are checked as in pixReadStreamBmp(), so a file
+ *          that it would reject is also rejected here.
+ *      (3) If there is a colormap, iscmap is returned as 1; else 0.
+ *          A 1 bpp colormap is removed on reading, so it is not reported.
+ */
+l_int32
+sreadHeaderBmp(const l_uint8  *data,
+               size_t          size,
+               l_int32        *pwidth,
+               l_int32        *pheight,
+               l_int32        *pbps,
+               l_int32        *pspp,
+               l_int32        *piscmap)
+{
+l_int32  offset, width, height, depth, compression, imagebytes, fileBpl;
+
+    PROCNAME("sreadHeaderBmp");
+
+    if (!data)
+        return ERROR_INT("data not defined", procName, 1);
+    if (!pwidth || !pheight || !pbps || !pspp)
+        return ERROR_INT("input ptr(s) not defined", procName, 1);
+    *pwidth = *pheight = *pbps = *pspp = 0;
+    if (piscmap)
+      *piscmap = 0;
+    if (size < BMP_FHBYTES + BMP_IHBYTES)
+        return ERROR_INT("data too small to be bmp", procName, 1);
+    if (data[0] != 'B' || data[1] != 'M')
+        return ERROR_INT("not bmf format", procName, 1);
+
+        /* All fields are little-endian */
+    offset = data[10] | (data[11] << 8);
+    width = data[18] | (data[19] << 8) | (data[20] << 16) | (data[21] << 24);
+    height = data[22] | (data[23] << 8) | (data[24] << 16) | (data[25] << 24);
+    depth = data[28] | (data[29] << 8);
+    compression = data[30] | (data[31] << 8) | (data[32] << 16) |
+                  (data[33] << 24);
+    imagebytes = data[34] | (data[35] << 8) | (data[36] << 16) |
+                 (data[37] << 24);
+
+    if (compression != 0)
+        return ERROR_INT("cannot read compressed BMP files", procName, 1);
+    if (width < 1 || height < 1)
+        return ERROR_INT("invalid dimensions", procName, 1);
+    if (depth < 1 || depth > 32)
+        return ERROR_INT("depth not in [1 ... 32]", procName, 1);
+    fileBpl = 4 * ((width * depth + 31)/32);
+    if (imagebytes != 0 && imagebytes != fileBpl * height)
+        return ERROR_INT("invalid imagebytes", procName, 1);
+    if (offset < BMP_FHBYTES + BMP_IHBYTES)
+        return ERROR_INT("invalid offset: too small", procName, 1);
+    if (offset > BMP_FHBYTES + BMP_IHBYTES + 4 * 256)
+        return ERROR_INT("invalid offset: too large", procName, 1);
+
+    *pwidth = width;
+    *pheight = height;
+    *pbps = (depth == 24 || depth == 32) ? 8 : depth;
+    *pspp = (depth == 24 || depth == 32) ? 3 : 1;
+    if (piscmap && depth > 1 && depth <= 8 &&
+        offset > BMP_FHBYTES + BMP_IHBYTES)
+        *piscmap = 1;
+    return 0;
+}
+
+
 /*!
  *  pixWriteStreamBmp()
  *
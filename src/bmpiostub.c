@@ -30,6 +30,13 @@ PIX * pixReadStreamBmp(FILE *fp)
     return (PIX * )ERROR_PTR("function not present", "pixReadStreamBmp", NULL);
 }
 
+l_int32 sreadHeaderBmp(const l_uint8 *data, size_t size, l_int32 *pwidth,
+                       l_int32 *pheight, l_int32 *pbps, l_int32 *pspp,
+                       l_int32 *piscmap)
+{
+    return ERROR_INT("function not present", "sreadHeaderBmp", 1);
+}
+
 l_int32 pixWriteStreamBmp(FILE *fp, PIX *pix)
 {
     return ERROR_INT("function not present", "pixWriteStreamBmp", 1);
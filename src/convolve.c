@@ -57,13 +57,37 @@
  *          FPIX     *fpixConvolve()
  *          FPIX     *fpixConvolveSep()
  *
+ *      Recursive (IIR) gaussian convolution
+ *          PIX      *pixRecursiveGaussian()
+ *          FPIX     *fpixRecursiveGaussian()
+ *
  *      Set parameter for convolution subsampling
  *          void      l_setConvolveSampling()
+ *
+ *      Static helpers for generic convolution
+ *          static FPIX *fpixConvolveBordered()
+ *          static FPIX *fpixConvolveSepBordered()
+ *          static void  convolveFloatLow()
+ *
+ *      Static helper for recursive gaussian convolution
+ *          static void  recursiveGaussianLow()
  */
 
+#include <string.h>
 #include <math.h>
 #include "allheaders.h"
 
+static FPIX *fpixConvolveBordered(FPIX *fpixt, L_KERNEL *kel, l_int32 wd,
+                                  l_int32 hd);
+static FPIX *fpixConvolveSepBordered(FPIX *fpixt, L_KERNEL *kelx,
+                                     L_KERNEL *kely, l_int32 wd, l_int32 hd,
+                                     l_int32 absflag);
+static void convolveFloatLow(l_float32 *datad, l_int32 wd, l_int32 hd,
+                             l_int32 wpld, l_float32 *datat, l_int32 wplt,
+                             L_KERNEL *kel, l_int32 xfact, l_int32 yfact);
+static void recursiveGaussianLow(l_float32 *data, l_int32 w, l_int32 h,
+                                 l_int32 wpl, l_float32 stdev);
+
     /* These globals determine the subsampling factors for
      * generic convolution of pix and fpix.  Declare extern to use.
      * To change the values, use l_setConvolveSampling(). */
@@ -1348,10 +1372,16 @@ PIX       *pixav, *pixd;
  *      (7) To get a subsampled output, call l_setConvolveSampling().
  *          The time to make a subsampled output is reduced by the
  *          product of the sampling factors.
- *      (8) The function is slow, running at about 12 machine cycles for
- *          each pixel-op in the convolution.  For example, with a 3 GHz
- *          cpu, a 1 Mpixel grayscale image, and a kernel with
- *          (sx * sy) = 25 elements, the convolution takes about 100 msec.
+ *      (8) The image is converted to float, and the convolution is
+ *          done a raster line at a time, accumulating the contribution
+ *          of each kernel element over the entire line.  These inner
+ *          loops are simple enough for the compiler to vectorize.
+ *      (9) If the kernel is separable (rank 1), such as the kernels
+ *          made by makeGaussianKernel(), it is factored automatically
+ *          and the convolution is done in two 1D passes, when that
+ *          takes fewer operations.
+ *      (10) Output values that are too large for @outdepth are clipped
+ *           to the maximum value.
  */
 PIX *
 pixConvolve(PIX       *pixs,
@@ -1359,12 +1389,10 @@ pixConvolve(PIX       *pixs,
 	    l_int32    outdepth,
 	    l_int32    normflag)
 {
-l_int32    i, j, id, jd, k, m, w, h, d, wd, hd, sx, sy, cx, cy, wplt, wpld;
-l_int32    val;
-l_uint32  *datat, *datad, *linet, *lined;
-l_float32  sum;
+l_int32    w, h, d, wd, hd, sx, sy, cx, cy;
 L_KERNEL  *keli, *keln;
 PIX       *pixt, *pixd;
+FPIX      *fpixt, *fpixd;
 
     PROCNAME("pixConvolve");
 
@@ -1385,56 +1413,30 @@ PIX       *pixt, *pixd;
     else
         keln = kernelCopy(keli);
 
-    if ((pixt = pixAddMirroredBorder(pixs, cx, sx - cx, cy, sy - cy)) == NULL)
-        return (PIX *)ERROR_PTR("pixt not made", procName, NULL);
+    pixd = NULL;
+    fpixt = fpixd = NULL;
+    if ((pixt = pixAddMirroredBorder(pixs, cx, sx - cx, cy, sy - cy)) == NULL) {
+        L_ERROR("pixt not made", procName);
+        goto cleanup;
+    }
+    fpixt = pixConvertToFPix(pixt, 1);
+    pixDestroy(&pixt);
+    if (!fpixt) {
+        L_ERROR("fpixt not made", procName);
+        goto cleanup;
+    }
 
+        /* Negative results are replaced by their absolute value */
     wd = (w + ConvolveSamplingFactX - 1) / ConvolveSamplingFactX;
     hd = (h + ConvolveSamplingFactY - 1) / ConvolveSamplingFactY;
-    pixd = pixCreate(wd, hd, outdepth);
-    datat = pixGetData(pixt);
-    datad = pixGetData(pixd);
-    wplt = pixGetWpl(pixt);
-    wpld = pixGetWpl(pixd);
-    for (i = 0, id = 0; id < hd; i += ConvolveSamplingFactY, id++) {
-        lined = datad + id * wpld;
-        for (j = 0, jd = 0; jd < wd; j += ConvolveSamplingFactX, jd++) {
-            sum = 0.0;
-            for (k = 0; k < sy; k++) {
-                linet = datat + (i + k) * wplt;
-                if (d == 8) {
-                    for (m = 0; m < sx; m++) {
-                        val = GET_DATA_BYTE(linet, j + m);
-                        sum += val * keln->data[k][m];
-                    }
-                }
-                else if (d == 16) {
-                    for (m = 0; m < sx; m++) {
-                        val = GET_DATA_TWO_BYTES(linet, j + m);
-                        sum += val * keln->data[k][m];
-                    }
-                }
-                else {  /* d == 32 */
-                    for (m = 0; m < sx; m++) {
-                        val = *(linet + j + m);
-                        sum += val * keln->data[k][m];
-                    }
-                }
-            }
-#if 1
-	    if (sum < 0.0) sum = -sum;  /* make it non-negative */
-#endif
-            if (outdepth == 8)
-                SET_DATA_BYTE(lined, jd, (l_int32)(sum + 0.5));
-            else if (outdepth == 16)
-                SET_DATA_TWO_BYTES(lined, jd, (l_int32)(sum + 0.5));
-            else  /* outdepth == 32 */
-                *(lined + jd) = (l_uint32)(sum + 0.5);
-        }
-    }
+    if ((fpixd = fpixConvolveBordered(fpixt, keln, wd, hd)) != NULL)
+        pixd = fpixConvertToPix(fpixd, outdepth, L_TAKE_ABSVAL, 0);
 
+cleanup:
     kernelDestroy(&keli);
     kernelDestroy(&keln);
-    pixDestroy(&pixt);
+    fpixDestroy(&fpixt);
+    fpixDestroy(&fpixd);
     return pixd;
 }
 
@@ -1479,6 +1481,15 @@ PIX       *pixt, *pixd;
  *          convolution.
  *      (6) This uses mirrored borders to avoid special casing on
  *          the boundaries.
+ *      (7) The intermediate result is kept in float, so there is no
+ *          loss of precision between the two passes.  As before, the
+ *          absolute value of the intermediate result is taken, so for
+ *          kernels with negative values (e.g., derivative filters) the
+ *          result is the same as two successive calls to pixConvolve().
+ *      (8) Because the intermediate is not truncated to an integer,
+ *          the result can differ by a few units from versions that
+ *          did so.  For example, with @normflag == 0 and 16 bpp
+ *          output, differences of 2 are found.
  */
 PIX *
 pixConvolveSep(PIX       *pixs,
@@ -1487,15 +1498,16 @@ pixConvolveSep(PIX       *pixs,
                l_int32    outdepth,
                l_int32    normflag)
 {
-l_int32    d, xfact, yfact;
-L_KERNEL  *kelxn, *kelyn;
+l_int32    w, h, d, wd, hd, sx, sy, cx, cy;
+L_KERNEL  *kelxi, *kelyi, *kelxn, *kelyn;
 PIX       *pixt, *pixd;
+FPIX      *fpixt, *fpixd;
 
     PROCNAME("pixConvolveSep");
 
     if (!pixs)
         return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
-    d = pixGetDepth(pixs);
+    pixGetDimensions(pixs, &w, &h, &d);
     if (d != 8 && d != 16 && d != 32)
         return (PIX *)ERROR_PTR("pixs not 8, 16, or 32 bpp", procName, NULL);
     if (!kelx)
@@ -1503,28 +1515,46 @@ PIX       *pixt, *pixd;
     if (!kely)
         return (PIX *)ERROR_PTR("kely not defined", procName, NULL);
 
-    xfact = ConvolveSamplingFactX;
-    yfact = ConvolveSamplingFactY;
+    kelxi = kernelInvert(kelx);
+    kelyi = kernelInvert(kely);
     if (normflag) {
-        kelxn = kernelNormalize(kelx, 1000.0);
-        kelyn = kernelNormalize(kely, 0.001);
-        l_setConvolveSampling(xfact, 1);
-        pixt = pixConvolve(pixs, kelxn, 32, 0);
-        l_setConvolveSampling(1, yfact);
-        pixd = pixConvolve(pixt, kelyn, outdepth, 0);
-        l_setConvolveSampling(xfact, yfact);  /* restore */
-        kernelDestroy(&kelxn);
-        kernelDestroy(&kelyn);
+        kelxn = kernelNormalize(kelxi, 1.0);
+        kelyn = kernelNormalize(kelyi, 1.0);
     }
     else {  /* don't normalize */
-        l_setConvolveSampling(xfact, 1);
-        pixt = pixConvolve(pixs, kelx, 32, 0);
-        l_setConvolveSampling(1, yfact);
-        pixd = pixConvolve(pixt, kely, outdepth, 0);
-        l_setConvolveSampling(xfact, yfact);
+        kelxn = kernelCopy(kelxi);
+        kelyn = kernelCopy(kelyi);
     }
-
+    kernelGetParameters(kelxn, NULL, &sx, NULL, &cx);
+    kernelGetParameters(kelyn, &sy, NULL, &cy, NULL);
+
+    pixd = NULL;
+    fpixt = fpixd = NULL;
+    if ((pixt = pixAddMirroredBorder(pixs, cx, sx - cx, cy, sy - cy)) == NULL) {
+        L_ERROR("pixt not made", procName);
+        goto cleanup;
+    }
+    fpixt = pixConvertToFPix(pixt, 1);
     pixDestroy(&pixt);
+    if (!fpixt) {
+        L_ERROR("fpixt not made", procName);
+        goto cleanup;
+    }
+
+        /* As with two calls to pixConvolve(), the absolute value is
+         * taken after each pass */
+    wd = (w + ConvolveSamplingFactX - 1) / ConvolveSamplingFactX;
+    hd = (h + ConvolveSamplingFactY - 1) / ConvolveSamplingFactY;
+    if ((fpixd = fpixConvolveSepBordered(fpixt, kelxn, kelyn, wd, hd, 1)))
+        pixd = fpixConvertToPix(fpixd, outdepth, L_TAKE_ABSVAL, 0);
+
+cleanup:
+    kernelDestroy(&kelxi);
+    kernelDestroy(&kelyi);
+    kernelDestroy(&kelxn);
+    kernelDestroy(&kelyn);
+    fpixDestroy(&fpixt);
+    fpixDestroy(&fpixd);
     return pixd;
 }
 
@@ -1607,6 +1637,8 @@ PIX  *pixt, *pixr, *pixg, *pixb, *pixd;
  *          product of the sampling factors.
  *      (4) This uses a mirrored border to avoid special casing on
  *          the boundaries.
+ *      (5) The intermediate result of each component is kept in float;
+ *          see pixConvolveSep().
  */
 PIX *
 pixConvolveRGBSep(PIX       *pixs,
@@ -1666,18 +1698,17 @@ PIX  *pixt, *pixr, *pixg, *pixb, *pixd;
  *          product of the sampling factors.
  *      (5) This uses a mirrored border to avoid special casing on
  *          the boundaries.
+ *      (6) As with pixConvolve(), a separable kernel is factored
+ *          and applied in two 1D passes when that is faster.
  */
 FPIX *
 fpixConvolve(FPIX      *fpixs,
              L_KERNEL  *kel,
 	     l_int32    normflag)
 {
-l_int32     i, j, id, jd, k, m, w, h, wd, hd, sx, sy, cx, cy, wplt, wpld;
-l_float32   val;
-l_float32  *datat, *datad, *linet, *lined;
-l_float32   sum;
-L_KERNEL   *keli, *keln;
-FPIX       *fpixt, *fpixd;
+l_int32    w, h, wd, hd, sx, sy, cx, cy;
+L_KERNEL  *keli, *keln;
+FPIX      *fpixt, *fpixd;
 
     PROCNAME("fpixConvolve");
 
@@ -1700,25 +1731,7 @@ FPIX       *fpixt, *fpixd;
 
     wd = (w + ConvolveSamplingFactX - 1) / ConvolveSamplingFactX;
     hd = (h + ConvolveSamplingFactY - 1) / ConvolveSamplingFactY;
-    fpixd = fpixCreate(wd, hd);
-    datat = fpixGetData(fpixt);
-    datad = fpixGetData(fpixd);
-    wplt = fpixGetWpl(fpixt);
-    wpld = fpixGetWpl(fpixd);
-    for (i = 0, id = 0; id < hd; i += ConvolveSamplingFactY, id++) {
-        lined = datad + id * wpld;
-        for (j = 0, jd = 0; jd < wd; j += ConvolveSamplingFactX, jd++) {
-            sum = 0.0;
-            for (k = 0; k < sy; k++) {
-                linet = datat + (i + k) * wplt;
-                for (m = 0; m < sx; m++) {
-                    val = *(linet + j + m);
-                    sum += val * keln->data[k][m];
-                }
-            }
-            *(lined + jd) = sum;
-        }
-    }
+    fpixd = fpixConvolveBordered(fpixt, keln, wd, hd);
 
     kernelDestroy(&keli);
     kernelDestroy(&keln);
@@ -1760,8 +1773,8 @@ fpixConvolveSep(FPIX      *fpixs,
                 L_KERNEL  *kely,
                 l_int32    normflag)
 {
-l_int32    xfact, yfact;
-L_KERNEL  *kelxn, *kelyn;
+l_int32    w, h, wd, hd, sx, sy, cx, cy;
+L_KERNEL  *kelxi, *kelyi, *kelxn, *kelyn;
 FPIX      *fpixt, *fpixd;
 
     PROCNAME("fpixConvolveSep");
@@ -1773,32 +1786,153 @@ FPIX      *fpixt, *fpixd;
     if (!kely)
         return (FPIX *)ERROR_PTR("kely not defined", procName, NULL);
 
-    xfact = ConvolveSamplingFactX;
-    yfact = ConvolveSamplingFactY;
+    kelxi = kernelInvert(kelx);
+    kelyi = kernelInvert(kely);
     if (normflag) {
-        kelxn = kernelNormalize(kelx, 1.0);
-        kelyn = kernelNormalize(kely, 1.0);
-        l_setConvolveSampling(xfact, 1);
-        fpixt = fpixConvolve(fpixs, kelxn, 0);
-        l_setConvolveSampling(1, yfact);
-        fpixd = fpixConvolve(fpixt, kelyn, 0);
-        l_setConvolveSampling(xfact, yfact);  /* restore */
-        kernelDestroy(&kelxn);
-        kernelDestroy(&kelyn);
+        kelxn = kernelNormalize(kelxi, 1.0);
+        kelyn = kernelNormalize(kelyi, 1.0);
     }
     else {  /* don't normalize */
-        l_setConvolveSampling(xfact, 1);
-        fpixt = fpixConvolve(fpixs, kelx, 0);
-        l_setConvolveSampling(1, yfact);
-        fpixd = fpixConvolve(fpixt, kely, 0);
-        l_setConvolveSampling(xfact, yfact);
+        kelxn = kernelCopy(kelxi);
+        kelyn = kernelCopy(kelyi);
+    }
+    kernelGetParameters(kelxn, NULL, &sx, NULL, &cx);
+    kernelGetParameters(kelyn, &sy, NULL, &cy, NULL);
+
+    fpixGetDimensions(fpixs, &w, &h);
+    fpixd = NULL;
+    if ((fpixt = fpixAddMirroredBorder(fpixs, cx, sx - cx, cy, sy - cy))
+        == NULL) {
+        L_ERROR("fpixt not made", procName);
+        goto cleanup;
     }
 
+    wd = (w + ConvolveSamplingFactX - 1) / ConvolveSamplingFactX;
+    hd = (h + ConvolveSamplingFactY - 1) / ConvolveSamplingFactY;
+    fpixd = fpixConvolveSepBordered(fpixt, kelxn, kelyn, wd, hd, 0);
+
+cleanup:
+    kernelDestroy(&kelxi);
+    kernelDestroy(&kelyi);
+    kernelDestroy(&kelxn);
+    kernelDestroy(&kelyn);
     fpixDestroy(&fpixt);
     return fpixd;
 }
 
 
+/*----------------------------------------------------------------------*
+ *                 Recursive (IIR) gaussian convolution                 *
+ *----------------------------------------------------------------------*/
+/*!
+ *  pixRecursiveGaussian()
+ *
+ *      Input:  pixs (8 or 32 bpp; or 2, 4 or 8 bpp with colormap)
+ *              stdev (standard deviation of the gaussian; >= 0.5)
+ *      Return: pixd (8 or 32 bpp), or null on error
+ *
+ *  Notes:
+ *      (1) This approximates convolution with a normalized gaussian,
+ *          using the recursive filter of Young and van Vliet
+ *          ("Recursive implementation of the Gaussian filter",
+ *          Signal Processing 44, 1995, pp. 139-151).
+ *      (2) The cost per pixel is independent of @stdev.  For @stdev
+ *          greater than about 3, this is faster than pixConvolveSep()
+ *          with a kernel from makeGaussianKernelSep(), and there is
+ *          no kernel truncation.  For small @stdev, the error of the
+ *          approximation is larger, and a kernel convolution is better.
+ *      (3) Boundary pixels are replicated outward.
+ *      (4) For 32 bpp, each rgb component is filtered independently.
+ */
+PIX *
+pixRecursiveGaussian(PIX       *pixs,
+                     l_float32  stdev)
+{
+l_int32  d;
+PIX     *pixt, *pixr, *pixg, *pixb, *pixrf, *pixgf, *pixbf, *pixd;
+FPIX    *fpixt, *fpixd;
+
+    PROCNAME("pixRecursiveGaussian");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (stdev < 0.5)
+        return (PIX *)ERROR_PTR("stdev < 0.5", procName, NULL);
+
+        /* Remove colormap if necessary */
+    d = pixGetDepth(pixs);
+    if ((d == 2 || d == 4 || d == 8) && pixGetColormap(pixs)) {
+        L_WARNING("pix has colormap; removing", procName);
+        pixt = pixRemoveColormap(pixs, REMOVE_CMAP_BASED_ON_SRC);
+        d = pixGetDepth(pixt);
+    }
+    else
+        pixt = pixClone(pixs);
+    if (d != 8 && d != 32) {
+        pixDestroy(&pixt);
+        return (PIX *)ERROR_PTR("depth not 8 or 32 bpp", procName, NULL);
+    }
+
+    if (d == 8) {
+        fpixt = pixConvertToFPix(pixt, 1);
+        fpixd = fpixRecursiveGaussian(fpixt, stdev);
+        pixd = fpixConvertToPix(fpixd, 8, L_CLIP_TO_ZERO, 0);
+        fpixDestroy(&fpixt);
+        fpixDestroy(&fpixd);
+    }
+    else {  /* d == 32 */
+        pixr = pixGetRGBComponent(pixt, COLOR_RED);
+        pixrf = pixRecursiveGaussian(pixr, stdev);
+        pixDestroy(&pixr);
+        pixg = pixGetRGBComponent(pixt, COLOR_GREEN);
+        pixgf = pixRecursiveGaussian(pixg, stdev);
+        pixDestroy(&pixg);
+        pixb = pixGetRGBComponent(pixt, COLOR_BLUE);
+        pixbf = pixRecursiveGaussian(pixb, stdev);
+        pixDestroy(&pixb);
+        pixd = pixCreateRGBImage(pixrf, pixgf, pixbf);
+        pixDestroy(&pixrf);
+        pixDestroy(&pixgf);
+        pixDestroy(&pixbf);
+    }
+
+    pixDestroy(&pixt);
+    return pixd;
+}
+
+
+/*!
+ *  fpixRecursiveGaussian()
+ *
+ *      Input:  fpixs
+ *              stdev (standard deviation of the gaussian; >= 0.5)
+ *      Return: fpixd, or null on error
+ *
+ *  Notes:
+ *      (1) See pixRecursiveGaussian().
+ */
+FPIX *
+fpixRecursiveGaussian(FPIX      *fpixs,
+                      l_float32  stdev)
+{
+l_int32  w, h;
+FPIX    *fpixd;
+
+    PROCNAME("fpixRecursiveGaussian");
+
+    if (!fpixs)
+        return (FPIX *)ERROR_PTR("fpixs not defined", procName, NULL);
+    if (stdev < 0.5)
+        return (FPIX *)ERROR_PTR("stdev < 0.5", procName, NULL);
+
+    if ((fpixd = fpixCopy(NULL, fpixs)) == NULL)
+        return (FPIX *)ERROR_PTR("fpixd not made", procName, NULL);
+    fpixGetDimensions(fpixd, &w, &h);
+    recursiveGaussianLow(fpixGetData(fpixd), w, h, fpixGetWpl(fpixd), stdev);
+    return fpixd;
+}
+
+
 /*------------------------------------------------------------------------*
  *                Set parameter for convolution subsampling               *
  *------------------------------------------------------------------------*/
@@ -1822,3 +1956,272 @@ l_setConvolveSampling(l_int32  xfact,
     ConvolveSamplingFactY = yfact;
 }
 
+
+/*------------------------------------------------------------------------*
+ *                Static helpers for generic convolution                  *
+ *------------------------------------------------------------------------*/
+/*!
+ *  fpixConvolveBordered()
+ *
+ *      Input:  fpixt (with border added for the kernel)
+ *              kel (inverted, and normalized if requested)
+ *              wd, hd (size of output, including subsampling)
+ *      Return: fpixd, or null on error
+ *
+ *  Notes:
+ *      (1) If the kernel is separable and the two 1D passes take fewer
+ *          operations than the 2D convolution, this does the separable
+ *          convolution.  The first (horizontal) pass must be done on
+ *          every line of fpixt, so large vertical sampling factors
+ *          favor the 2D convolution.
+ */
+static FPIX *
+fpixConvolveBordered(FPIX      *fpixt,
+                     L_KERNEL  *kel,
+                     l_int32    wd,
+                     l_int32    hd)
+{
+l_int32    sx, sy, ht;
+L_KERNEL  *kelx, *kely;
+FPIX      *fpixd;
+
+    PROCNAME("fpixConvolveBordered");
+
+    kernelGetParameters(kel, &sy, &sx, NULL, NULL);
+    fpixGetDimensions(fpixt, NULL, &ht);
+    if (sx > 1 && sy > 1 &&
+        (l_float64)sx * ht + (l_float64)sy * hd < (l_float64)sx * sy * hd) {
+        kernelGetSeparableParts(kel, &kelx, &kely);
+        if (kelx) {
+            fpixd = fpixConvolveSepBordered(fpixt, kelx, kely, wd, hd, 0);
+            kernelDestroy(&kelx);
+            kernelDestroy(&kely);
+            return fpixd;
+        }
+    }
+
+    if ((fpixd = fpixCreate(wd, hd)) == NULL)
+        return (FPIX *)ERROR_PTR("fpixd not made", procName, NULL);
+    convolveFloatLow(fpixGetData(fpixd), wd, hd, fpixGetWpl(fpixd),
+                     fpixGetData(fpixt), fpixGetWpl(fpixt), kel,
+                     ConvolveSamplingFactX, ConvolveSamplingFactY);
+    return fpixd;
+}
+
+
+/*!
+ *  fpixConvolveSepBordered()
+ *
+ *      Input:  fpixt (with border added for the kernel)
+ *              kelx (1 row; inverted, and normalized if requested)
+ *              kely (1 column; inverted, and normalized if requested)
+ *              wd, hd (size of output, including subsampling)
+ *              absflag (1 to take the absolute value of the result
+ *                       of the horizontal pass; 0 otherwise)
+ *      Return: fpixd, or null on error
+ *
+ *  Notes:
+ *      (1) The horizontal pass is subsampled by ConvolveSamplingFactX
+ *          and done on all lines of fpixt; the vertical pass is then
+ *          subsampled by ConvolveSamplingFactY.
+ *      (2) Both passes run along raster lines, so the vertical pass
+ *          also has sequential memory access and no transposition
+ *          is required.
+ */
+static FPIX *
+fpixConvolveSepBordered(FPIX      *fpixt,
+                        L_KERNEL  *kelx,
+                        L_KERNEL  *kely,
+                        l_int32    wd,
+                        l_int32    hd,
+                        l_int32    absflag)
+{
+l_int32     i, j, ht, wplh;
+l_float32  *datah, *lineh;
+FPIX       *fpixh, *fpixd;
+
+    PROCNAME("fpixConvolveSepBordered");
+
+    fpixGetDimensions(fpixt, NULL, &ht);
+    fpixh = fpixCreate(wd, ht);
+    fpixd = fpixCreate(wd, hd);
+    if (!fpixh || !fpixd) {
+        fpixDestroy(&fpixh);
+        fpixDestroy(&fpixd);
+        return (FPIX *)ERROR_PTR("fpixh or fpixd not made", procName, NULL);
+    }
+    convolveFloatLow(fpixGetData(fpixh), wd, ht, fpixGetWpl(fpixh),
+                     fpixGetData(fpixt), fpixGetWpl(fpixt), kelx,
+                     ConvolveSamplingFactX, 1);
+    if (absflag) {
+        datah = fpixGetData(fpixh);
+        wplh = fpixGetWpl(fpixh);
+        for (i = 0; i < ht; i++) {
+            lineh = datah + i * wplh;
+            for (j = 0; j < wd; j++) {
+                if (lineh[j] < 0.0)
+                    lineh[j] = -lineh[j];
+            }
+        }
+    }
+    convolveFloatLow(fpixGetData(fpixd), wd, hd, fpixGetWpl(fpixd),
+                     fpixGetData(fpixh), fpixGetWpl(fpixh), kely,
+                     1, ConvolveSamplingFactY);
+    fpixDestroy(&fpixh);
+    return fpixd;
+}
+
+
+/*!
+ *  convolveFloatLow()
+ *
+ *      Input:  datad, wd, hd, wpld (output data and size)
+ *              datat, wplt (bordered input data)
+ *              kel (inverted, and normalized if requested)
+ *              xfact, yfact (subsampling factors)
+ *      Return: void
+ *
+ *  Notes:
+ *      (1) For each output line, the contribution of each kernel
+ *          element is accumulated over the whole line.  Without
+ *          subsampling in x, this is a unit-stride multiply-add that
+ *          the compiler can vectorize.  Zero kernel elements are skipped.
+ */
+static void
+convolveFloatLow(l_float32  *datad,
+                 l_int32     wd,
+                 l_int32     hd,
+                 l_int32     wpld,
+                 l_float32  *datat,
+                 l_int32     wplt,
+                 L_KERNEL   *kel,
+                 l_int32     xfact,
+                 l_int32     yfact)
+{
+l_int32     i, id, jd, k, m, sx, sy;
+l_float32   kval;
+l_float32  *lined, *linet;
+
+    kernelGetParameters(kel, &sy, &sx, NULL, NULL);
+    for (i = 0, id = 0; id < hd; i += yfact, id++) {
+        lined = datad + id * wpld;
+        for (jd = 0; jd < wd; jd++)
+            lined[jd] = 0.0;
+        for (k = 0; k < sy; k++) {
+            linet = datat + (i + k) * wplt;
+            for (m = 0; m < sx; m++) {
+                if ((kval = kel->data[k][m]) == 0.0)
+                    continue;
+                if (xfact == 1) {
+                    for (jd = 0; jd < wd; jd++)
+                        lined[jd] += kval * linet[jd + m];
+                }
+                else {
+                    for (jd = 0; jd < wd; jd++)
+                        lined[jd] += kval * linet[jd * xfact + m];
+                }
+            }
+        }
+    }
+    return;
+}
+
+
+/*------------------------------------------------------------------------*
+ *            Static helper for recursive gaussian convolution            *
+ *------------------------------------------------------------------------*/
+/*!
+ *  recursiveGaussianLow()
+ *
+ *      Input:  data (float image data, filtered in-place)
+ *              w, h, wpl
+ *              stdev (>= 0.5)
+ *      Return: void
+ *
+ *  Notes:
+ *      (1) The 3rd order causal and anti-causal filters are applied
+ *          first along each row and then along each column, using
+ *          the coefficients of Young and van Vliet:
+ *             y[n] = B * x[n] + a1 * y[n-1] + a2 * y[n-2] + a3 * y[n-3]
+ *          with B = 1 - (a1 + a2 + a3), so a constant input is unchanged.
+ *      (2) The filter state at each end is initialized to the value
+ *          at the boundary, which is the steady state for replicated
+ *          boundary pixels.
+ *      (3) The vertical filter is applied to entire raster lines at
+ *          a time, so memory access is sequential in both directions.
+ */
+static void
+recursiveGaussianLow(l_float32  *data,
+                     l_int32     w,
+                     l_int32     h,
+                     l_int32     wpl,
+                     l_float32   stdev)
+{
+l_int32     i, j;
+l_float32   q, b0, b1, b2, b3, a1, a2, a3, bnorm, p1, p2, p3, val;
+l_float32  *line, *line1, *line2, *line3, *bufs;
+
+    PROCNAME("recursiveGaussianLow");
+
+    if (stdev >= 2.5)
+        q = 0.98711 * stdev - 0.96330;
+    else
+        q = 3.97156 - 4.14554 * sqrt(1.0 - 0.26891 * stdev);
+    b0 = 1.57825 + 2.44413 * q + 1.4281 * q * q + 0.422205 * q * q * q;
+    b1 = 2.44413 * q + 2.85619 * q * q + 1.26661 * q * q * q;
+    b2 = -(1.4281 * q * q + 1.26661 * q * q * q);
+    b3 = 0.422205 * q * q * q;
+    a1 = b1 / b0;
+    a2 = b2 / b0;
+    a3 = b3 / b0;
+    bnorm = 1.0 - (a1 + a2 + a3);
+
+        /* Horizontal filter: causal, then anticausal */
+    for (i = 0; i < h; i++) {
+        line = data + i * wpl;
+        p1 = p2 = p3 = line[0];
+        for (j = 0; j < w; j++) {
+            val = bnorm * line[j] + a1 * p1 + a2 * p2 + a3 * p3;
+            p3 = p2;
+            p2 = p1;
+            p1 = line[j] = val;
+        }
+        p1 = p2 = p3 = line[w - 1];
+        for (j = w - 1; j >= 0; j--) {
+            val = bnorm * line[j] + a1 * p1 + a2 * p2 + a3 * p3;
+            p3 = p2;
+            p2 = p1;
+            p1 = line[j] = val;
+        }
+    }
+
+        /* Vertical filter, on whole lines.  The boundary line is
+         * saved in bufs, for use as the initial filter state. */
+    if ((bufs = (l_float32 *)CALLOC(w, sizeof(l_float32))) == NULL) {
+        L_ERROR("bufs not made", procName);
+        return;
+    }
+    memcpy(bufs, data, w * sizeof(l_float32));
+    for (i = 0; i < h; i++) {
+        line = data + i * wpl;
+        line1 = (i >= 1) ? line - wpl : bufs;
+        line2 = (i >= 2) ? line - 2 * wpl : bufs;
+        line3 = (i >= 3) ? line - 3 * wpl : bufs;
+        for (j = 0; j < w; j++)
+            line[j] = bnorm * line[j] + a1 * line1[j] + a2 * line2[j] +
+                      a3 * line3[j];
+    }
+    memcpy(bufs, data + (h - 1) * wpl, w * sizeof(l_float32));
+    for (i = h - 1; i >= 0; i--) {
+        line = data + i * wpl;
+        line1 = (i <= h - 2) ? line + wpl : bufs;
+        line2 = (i <= h - 3) ? line + 2 * wpl : bufs;
+        line3 = (i <= h - 4) ? line + 3 * wpl : bufs;
+        for (j = 0; j < w; j++)
+            line[j] = bnorm * line[j] + a1 * line1[j] + a2 * line2[j] +
+                      a3 * line3[j];
+    }
+
+    FREE(bufs);
+    return;
+}
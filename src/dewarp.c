@@ -32,6 +32,8 @@
  *          l_int32        dewarpApplyDisparity()
  *          l_int32        pixApplyVerticalDisparity()
  *          l_int32        pixApplyHorizontalDisparity()
+ *          PIX           *pixApplySampledDisparity()
+ *          static l_int32 fpixScaleRowByInteger()
  *
  *      Stripping out data and populating full res disparity
  *          l_int32        dewarpMinimize()
@@ -43,6 +45,20 @@
  *          l_int32        dewarpWrite()
  *          l_int32        dewarpWriteStream()
  *
+ *      Models for the pages of a book
+ *          L_DEWARPA     *dewarpaCreate()
+ *          void           dewarpaDestroy()
+ *          l_int32        dewarpaInsertDewarp()
+ *          L_DEWARP      *dewarpaGetDewarp()
+ *          L_DEWARP      *dewarpaFindModel()
+ *          l_int32        dewarpaApplyDisparity()
+ *
+ *      Serialized I/O of models for a book
+ *          L_DEWARPA     *dewarpaRead()
+ *          L_DEWARPA     *dewarpaReadStream()
+ *          l_int32        dewarpaWrite()
+ *          l_int32        dewarpaWriteStream()
+ *
  *  Basic functioning:
  *     Pix *pixb = "binarize"(pixs);
  *     L_Dewarp *dew = dewarpCreate(pixb, ...);
@@ -57,6 +73,20 @@
  *  Applying a model (stripped or not) to another image:
  *     dewarpApplyDisparity(dew, newpix, 0);
  *
+ *  Building models for some pages of a book and applying them
+ *  to all pages:
+ *     L_Dewarpa *dewa = dewarpaCreate(0, -1);
+ *     for (each page chosen for a model) {
+ *         L_Dewarp *dew = dewarpCreate(pixb, pageno, ...);
+ *         dewarpBuildModel(dew, 0);
+ *         dewarpMinimize(dew);
+ *         dewarpaInsertDewarp(dewa, dew);
+ *     }
+ *     for (each page) {
+ *         if (dewarpaApplyDisparity(dewa, pageno, pix, &pixd))
+ *             pixd = pixClone(pix);  // no model for this page
+ *     }
+ *
  *  Description of the problem and the approach
  *  -------------------------------------------
  *
@@ -232,6 +262,12 @@
     /* Default parameter values */
 static const l_int32     L_DEFAULT_SAMPLING = 30;
 static const l_float32   DEFAULT_SLOPE_FACTOR = 2000.;
+static const l_int32     INITIAL_PTR_ARRAYSIZE = 20;
+static const l_int32     DEFAULT_MAX_PAGE_DIST = 4;
+
+static l_int32 fpixScaleRowByInteger(FPIX *fpixs, l_int32 factor, l_int32 i,
+                                     l_float32 *fract, l_float32 *row,
+                                     l_int32 n);
 
 
 /*----------------------------------------------------------------------*
@@ -952,15 +988,25 @@ FPIX       *fpixd;
  *      (1) This applies the vertical disparity array to the specified
  *          image.  For src pixels above the image, we use the pixels
  *          in the first raster line.
- *      (2) This works with stripped models.  If the full resolution
- *          disparity array(s) are missing, they are remade.
+ *      (2) The sampled disparity arrays are applied directly with
+ *          pixApplySampledDisparity(), so this works with stripped
+ *          models and the full resolution disparity arrays are
+ *          never made.
+ *      (3) The full res horizontal disparity array made by
+ *          dewarpBuildModel() is not the same as the one interpolated
+ *          from the sampled array.  If it is still in the model, it
+ *          is used, so the result is the same as applying both full
+ *          res arrays with pixApplyVerticalDisparity() and
+ *          pixApplyHorizontalDisparity().
  */
 l_int32
 dewarpApplyDisparity(L_DEWARP  *dew,
                      PIX       *pixs,
                      l_int32    debugflag)
 {
-PIX  *pixv, *pixd;
+l_int32  hsampling;
+FPIX    *fpixh;
+PIX     *pixd;
 
     PROCNAME("dewarpApplyDisparity");
 
@@ -970,32 +1016,29 @@ PIX  *pixv, *pixd;
         return ERROR_INT("model failed to build", procName, 1);
     if (!pixs)
         return ERROR_INT("pixs not defined", procName, 1);
+    if (!dew->sampvdispar)
+        return ERROR_INT("no sampled vert disparity", procName, 1);
+    fpixh = NULL;
+    hsampling = dew->sampling;
+    if (dew->applyhoriz) {
+        if (dew->fullhdispar) {
+            fpixh = dew->fullhdispar;
+            hsampling = 1;
+        }
+        else if ((fpixh = dew->samphdispar) == NULL)
+            return ERROR_INT("no sampled horiz disparity", procName, 1);
+    }
 
-        /* Generate the full res disparity arrays if they don't exist;
-         * e.g., if they've been minimized or read from file.  */
-    dewarpPopulateFullRes(dew);
     pixDestroy(&dew->pixd);  /* remove any previous one */
-
-    if ((pixv = pixApplyVerticalDisparity(pixs, dew->fullvdispar)) == NULL)
-        return ERROR_INT("pixv not made", procName, 1);
+    if ((pixd = pixApplySampledDisparity(pixs, dew->sampvdispar, fpixh,
+                                         dew->sampling, hsampling,
+                                         dew->extraw)) == NULL)
+        return ERROR_INT("pixd not made", procName, 1);
+    dew->pixd = pixd;
     if (debugflag) {
-        pixDisplayWithTitle(pixv, 300, 0, "pixv", 1);
-        pixWriteTempfile("/tmp", "pixv.png", pixv, IFF_PNG, NULL);
-    }
-
-    if (dew->applyhoriz) {
-        if ((pixd = pixApplyHorizontalDisparity(pixv, dew->fullhdispar,
-                                                dew->extraw)) == NULL)
-            return ERROR_INT("pixd not made", procName, 1);
-        pixDestroy(&pixv);
-        dew->pixd = pixd;
-        if (debugflag) {
-            pixDisplayWithTitle(pixd, 600, 0, "pixd", 1);
-            pixWriteTempfile("/tmp", "pixd.png", pixd, IFF_PNG, NULL);
-        }
+        pixDisplayWithTitle(pixd, 600, 0, "pixd", 1);
+        pixWriteTempfile("/tmp", "pixd.png", pixd, IFF_PNG, NULL);
     }
-    else
-        dew->pixd = pixv;
     return 0;
 }
 
@@ -1180,6 +1223,201 @@ PIX        *pixd;
 }
 
 
+/*!
+ *  pixApplySampledDisparity()
+ *
+ *      Input:  pixs (1, 8 or 32 bpp)
+ *              fpixv (sampled vertical disparity array)
+ *              fpixh (<optional> sampled horizontal disparity array)
+ *              vsampling (sampling factor of fpixv)
+ *              hsampling (sampling factor of fpixh; use 1 if it is
+ *                         at full resolution)
+ *              extraw (extra width added to pixd; ignored if no fpixh)
+ *      Return: pixd (modified by the disparity arrays), or null on error
+ *
+ *  Notes:
+ *      (1) This gives the same result as pixApplyVerticalDisparity()
+ *          followed by pixApplyHorizontalDisparity(), using the full
+ *          resolution arrays made by fpixScaleByInteger().  However,
+ *          both disparities are applied in a single pass over pixd,
+ *          and each row of the full resolution arrays is interpolated
+ *          from the sampled arrays only when it is needed, so neither
+ *          the full resolution arrays nor the intermediate image
+ *          are made.
+ *      (2) The dest pixel at (j,i) comes from the src pixel at
+ *          (jsrc, isrc), where
+ *              jsrc = j - H(j,i)
+ *              isrc = i - V(jsrc,i)
+ *          and each is rounded and clipped to the src.
+ *      (3) The rows of pixd are independent, and can be done in any order.
+ *      (4) With @hsampling == 1, the rows of fpixh are used as they are.
+ */
+PIX *
+pixApplySampledDisparity(PIX      *pixs,
+                         FPIX     *fpixv,
+                         FPIX     *fpixh,
+                         l_int32   vsampling,
+                         l_int32   hsampling,
+                         l_int32   extraw)
+{
+l_int32     i, j, w, h, d, wd, fw, fh, wpld, isrc, jsrc, val8;
+l_uint32   *datad, *lined;
+l_float32  *fractv, *fracth, *rowv, *rowh;
+void      **lineptrs;
+PIX        *pixd;
+
+    PROCNAME("pixApplySampledDisparity");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (!fpixv)
+        return (PIX *)ERROR_PTR("fpixv not defined", procName, NULL);
+    if (vsampling < 1 || hsampling < 1)
+        return (PIX *)ERROR_PTR("sampling < 1", procName, NULL);
+    pixGetDimensions(pixs, &w, &h, &d);
+    if (d != 1 && d != 8 && d != 32)
+        return (PIX *)ERROR_PTR("pix not 1, 8 or 32 bpp", procName, NULL);
+    wd = (fpixh) ? w + extraw : w;
+
+        /* Check the size of the full res arrays */
+    fpixGetDimensions(fpixv, &fw, &fh);
+    fw = vsampling * (fw - 1) + 1;
+    fh = vsampling * (fh - 1) + 1;
+    if (fw < w || fh < h)
+        return (PIX *)ERROR_PTR("invalid fpixv size", procName, NULL);
+    if (fpixh) {
+        fpixGetDimensions(fpixh, &fw, &fh);
+        fw = hsampling * (fw - 1) + 1;
+        fh = hsampling * (fh - 1) + 1;
+        if (fw < wd || fh < h)
+            return (PIX *)ERROR_PTR("invalid fpixh size", procName, NULL);
+    }
+
+    if ((pixd = pixCreate(wd, h, d)) == NULL)
+        return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
+    pixCopyResolution(pixd, pixs);
+    pixCopyColormap(pixd, pixs);
+    fractv = (l_float32 *)CALLOC(vsampling, sizeof(l_float32));
+    fracth = (l_float32 *)CALLOC(hsampling, sizeof(l_float32));
+    rowv = (l_float32 *)CALLOC(w, sizeof(l_float32));
+    rowh = (l_float32 *)CALLOC(wd, sizeof(l_float32));
+    for (i = 0; i < vsampling; i++)
+        fractv[i] = i / (l_float32)vsampling;
+    for (i = 0; i < hsampling; i++)
+        fracth[i] = i / (l_float32)hsampling;
+
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    lineptrs = pixGetLinePtrs(pixs, NULL);
+    for (i = 0; i < h; i++) {
+        fpixScaleRowByInteger(fpixv, vsampling, i, fractv, rowv, w);
+        if (fpixh)
+            fpixScaleRowByInteger(fpixh, hsampling, i, fracth, rowh, wd);
+        lined = datad + i * wpld;
+        for (j = 0; j < wd; j++) {
+            jsrc = j;
+            if (fpixh) {
+                jsrc = (l_int32)(j - rowh[j] + 0.5);
+                if (jsrc < 0) jsrc = 0;
+                if (jsrc > w - 1) jsrc = w - 1;
+            }
+            isrc = (l_int32)(i - rowv[jsrc] + 0.5);
+            if (isrc < 0) isrc = 0;
+            if (isrc > h - 1) isrc = h - 1;
+            if (d == 1) {
+                if (GET_DATA_BIT(lineptrs[isrc], jsrc))
+                    SET_DATA_BIT(lined, j);
+            }
+            else if (d == 8) {
+                val8 = GET_DATA_BYTE(lineptrs[isrc], jsrc);
+                SET_DATA_BYTE(lined, j, val8);
+            }
+            else {  /* d == 32 */
+                lined[j] = GET_DATA_FOUR_BYTES(lineptrs[isrc], jsrc);
+            }
+        }
+    }
+
+    FREE(lineptrs);
+    FREE(fractv);
+    FREE(fracth);
+    FREE(rowv);
+    FREE(rowh);
+    return pixd;
+}
+
+
+/*!
+ *  fpixScaleRowByInteger()
+ *
+ *      Input:  fpixs (low resolution, subsampled)
+ *              factor (scaling factor)
+ *              i (row of the full resolution array)
+ *              fract (array of @factor fractions, fract[k] = k / factor)
+ *              row (<return> the first @n values of the row)
+ *              n (number of values to compute)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This computes row @i of fpixScaleByInteger(fpixs, factor),
+ *          with identical arithmetic, without making the full array.
+ *      (2) The caller must ensure that @i and @n are within the
+ *          full resolution array.
+ */
+static l_int32
+fpixScaleRowByInteger(FPIX       *fpixs,
+                      l_int32     factor,
+                      l_int32     i,
+                      l_float32  *fract,
+                      l_float32  *row,
+                      l_int32     n)
+{
+l_int32     j, k, m, js, ws, hs, wd, hd, wpls;
+l_float32   val0, val1, val2, val3;
+l_float32  *lines;
+
+    fpixGetDimensions(fpixs, &ws, &hs);
+    wpls = fpixGetWpl(fpixs);
+    wd = factor * (ws - 1) + 1;
+    hd = factor * (hs - 1) + 1;
+
+    if (i < hd - 1) {
+        lines = fpixGetData(fpixs) + (i / factor) * wpls;
+        k = i % factor;
+        for (j = 0; j < n; j++) {
+            if (j == wd - 1) {  /* right-most column */
+                row[j] = lines[ws - 1] * (1.0 - fract[k]) +
+                         lines[wpls + ws - 1] * fract[k];
+                continue;
+            }
+            js = j / factor;
+            m = j % factor;
+            val0 = lines[js];
+            val1 = lines[js + 1];
+            val2 = lines[wpls + js];
+            val3 = lines[wpls + js + 1];
+            row[j] = val0 * (1.0 - fract[m]) * (1.0 - fract[k]) +
+                     val1 * fract[m] * (1.0 - fract[k]) +
+                     val2 * (1.0 - fract[m]) * fract[k] +
+                     val3 * fract[m] * fract[k];
+        }
+    }
+    else {  /* bottom-most row */
+        lines = fpixGetData(fpixs) + (hs - 1) * wpls;
+        for (j = 0; j < n; j++) {
+            if (j == wd - 1) {  /* LR corner */
+                row[j] = lines[ws - 1];
+                continue;
+            }
+            js = j / factor;
+            m = j % factor;
+            row[j] = lines[js] * (1.0 - fract[m]) + lines[js + 1] * fract[m];
+        }
+    }
+    return 0;
+}
+
+
 /*----------------------------------------------------------------------*
  *          Stripping out data and populating full res disparity        *
  *----------------------------------------------------------------------*/
@@ -1284,11 +1522,13 @@ L_DEWARP  *dew;
  *  Notes:
  *      (1) The dewarp struct is stored in minimized format, with only
  *          subsampled disparity arrays.
+ *      (2) Version 1 files, which do not store the extra width for the
+ *          horizontal disparity, can still be read; extraw is then 0.
  */
 L_DEWARP *
 dewarpReadStream(FILE  *fp)
 {
-l_int32    version, sampling, pageno, nx, ny, hdispar;
+l_int32    version, sampling, pageno, nx, ny, hdispar, extraw;
 L_DEWARP  *dew;
 FPIX      *fpixv, *fpixh;
 
@@ -1299,13 +1539,16 @@ FPIX      *fpixv, *fpixh;
 
     if (fscanf(fp, "\nDewarp Version %d\n", &version) != 1)
         return (L_DEWARP *)ERROR_PTR("not a dewarp file", procName, NULL);
-    if (version != DEWARP_VERSION_NUMBER)
+    if (version != DEWARP_VERSION_NUMBER && version != 1)
         return (L_DEWARP *)ERROR_PTR("invalid dewarp version", procName, NULL);
     if (fscanf(fp, "pageno = %d, sampling = %d\n", &pageno, &sampling) != 2)
         return (L_DEWARP *)ERROR_PTR("read fail for pageno+", procName, NULL);
     if (fscanf(fp, "nx = %d, ny = %d, horiz_disparity = %d\n",
                &nx, &ny, &hdispar) != 3)
         return (L_DEWARP *)ERROR_PTR("read fail for nx+", procName, NULL);
+    extraw = 0;
+    if (version > 1 && fscanf(fp, "extraw = %d\n", &extraw) != 1)
+        return (L_DEWARP *)ERROR_PTR("read fail for extraw", procName, NULL);
     if ((fpixv = fpixReadStream(fp)) == NULL)
         return (L_DEWARP *)ERROR_PTR("read fail for vdispar", procName, NULL);
     if (hdispar) {
@@ -1319,6 +1562,7 @@ FPIX      *fpixv, *fpixh;
     dew->pageno = pageno;
     dew->nx = nx;
     dew->ny = ny;
+    dew->extraw = extraw;
     dew->success = 1;
     dew->sampvdispar = fpixv;
     if (hdispar) {
@@ -1385,6 +1629,7 @@ l_int32  hdispar;
     hdispar = (dew->samphdispar) ? 1 : 0;
     fprintf(fp, "nx = %d, ny = %d, horiz_disparity = %d\n",
             dew->nx, dew->ny, hdispar);
+    fprintf(fp, "extraw = %d\n", dew->extraw);
 
     fpixWriteStream(fp, dew->sampvdispar);
     if (hdispar)
@@ -1394,3 +1639,428 @@ l_int32  hdispar;
 }
 
 
+/*----------------------------------------------------------------------*
+ *                    Models for the pages of a book                    *
+ *----------------------------------------------------------------------*/
+/*!
+ *  dewarpaCreate()
+ *
+ *     Input: nptrs (initial size of the array; use 0 for default)
+ *            maxdist (max distance in pages from a page to the model
+ *                     applied to it; use -1 for default)
+ *     Return: dewa (or null on error)
+ *
+ *  Notes:
+ *      (1) The models are stored in an array indexed by page number,
+ *          which is extended as needed.
+ *      (2) Consecutive pages of a bound book have nearly the same
+ *          curvature, but the even and odd pages curve in opposite
+ *          directions.  A model is therefore only applied to pages of
+ *          the same parity; use @maxdist = 0 to only apply a model to
+ *          the page it was built from.
+ */
+L_DEWARPA *
+dewarpaCreate(l_int32  nptrs,
+              l_int32  maxdist)
+{
+L_DEWARPA  *dewa;
+
+    PROCNAME("dewarpaCreate");
+
+    if (nptrs <= 0)
+        nptrs = INITIAL_PTR_ARRAYSIZE;
+    if (maxdist < 0)
+        maxdist = DEFAULT_MAX_PAGE_DIST;
+
+    if ((dewa = (L_DEWARPA *)CALLOC(1, sizeof(L_DEWARPA))) == NULL)
+        return (L_DEWARPA *)ERROR_PTR("dewa not made", procName, NULL);
+    if ((dewa->dewarp = (L_DEWARP **)CALLOC(nptrs, sizeof(L_DEWARP *)))
+        == NULL) {
+        FREE(dewa);
+        return (L_DEWARPA *)ERROR_PTR("dewarp ptrs not made", procName, NULL);
+    }
+    dewa->nalloc = nptrs;
+    dewa->maxpage = -1;
+    dewa->maxdist = maxdist;
+    return dewa;
+}
+
+
+/*!
+ *  dewarpaDestroy()
+ *
+ *      Input:  &dewa (<will be set to null before returning>)
+ *      Return: void
+ */
+void
+dewarpaDestroy(L_DEWARPA  **pdewa)
+{
+l_int32     i;
+L_DEWARPA  *dewa;
+
+    PROCNAME("dewarpaDestroy");
+
+    if (pdewa == NULL) {
+        L_WARNING("ptr address is null!", procName);
+        return;
+    }
+    if ((dewa = *pdewa) == NULL)
+        return;
+
+    for (i = 0; i <= dewa->maxpage; i++)
+        dewarpDestroy(&dewa->dewarp[i]);
+    FREE(dewa->dewarp);
+    FREE(dewa);
+    *pdewa = NULL;
+    return;
+}
+
+
+/*!
+ *  dewarpaInsertDewarp()
+ *
+ *      Input:  dewa
+ *              dew (to be inserted; owned by dewa)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) The model is stored at the index of its page number.
+ *          Any other model already there is destroyed.  Inserting
+ *          the same model again does nothing.
+ *      (2) To save memory, strip the model with dewarpMinimize()
+ *          before inserting it.
+ */
+l_int32
+dewarpaInsertDewarp(L_DEWARPA  *dewa,
+                    L_DEWARP   *dew)
+{
+l_int32  pageno, n;
+
+    PROCNAME("dewarpaInsertDewarp");
+
+    if (!dewa)
+        return ERROR_INT("dewa not defined", procName, 1);
+    if (!dew)
+        return ERROR_INT("dew not defined", procName, 1);
+    if ((pageno = dew->pageno) < 0)
+        return ERROR_INT("invalid pageno", procName, 1);
+
+    if (pageno >= dewa->nalloc) {
+        n = dewa->nalloc;
+        while (pageno >= n)
+            n *= 2;
+        if ((dewa->dewarp = (L_DEWARP **)reallocNew((void **)&dewa->dewarp,
+                                 sizeof(L_DEWARP *) * dewa->nalloc,
+                                 sizeof(L_DEWARP *) * n)) == NULL)
+            return ERROR_INT("new ptr array not returned", procName, 1);
+        dewa->nalloc = n;
+    }
+
+    if (dewa->dewarp[pageno] != dew) {
+        dewarpDestroy(&dewa->dewarp[pageno]);
+        dewa->dewarp[pageno] = dew;
+    }
+    dewa->maxpage = L_MAX(dewa->maxpage, pageno);
+    return 0;
+}
+
+
+/*!
+ *  dewarpaGetDewarp()
+ *
+ *      Input:  dewa
+ *              pageno
+ *      Return: dew (the model built for @pageno, not a copy),
+ *              or null if there is none
+ */
+L_DEWARP *
+dewarpaGetDewarp(L_DEWARPA  *dewa,
+                 l_int32     pageno)
+{
+    PROCNAME("dewarpaGetDewarp");
+
+    if (!dewa)
+        return (L_DEWARP *)ERROR_PTR("dewa not defined", procName, NULL);
+    if (pageno < 0 || pageno > dewa->maxpage)
+        return NULL;
+    return dewa->dewarp[pageno];
+}
+
+
+/*!
+ *  dewarpaFindModel()
+ *
+ *      Input:  dewa
+ *              pageno
+ *              w, h (size of the image to be dewarped; 0 to skip
+ *                    the size check)
+ *      Return: dew (the nearest valid model, not a copy), or null
+ *              if there is none
+ *
+ *  Notes:
+ *      (1) The pages @pageno, @pageno - 2, @pageno + 2, @pageno - 4, ...
+ *          are searched, up to a distance of maxdist, and the first
+ *          valid model is returned.
+ *      (2) A model is valid if it was built successfully and its full
+ *          resolution disparity arrays cover an image of size w x h.
+ */
+L_DEWARP *
+dewarpaFindModel(L_DEWARPA  *dewa,
+                 l_int32     pageno,
+                 l_int32     w,
+                 l_int32     h)
+{
+l_int32    i, k, index, fw, fh, s, valid;
+L_DEWARP  *dew;
+
+    PROCNAME("dewarpaFindModel");
+
+    if (!dewa)
+        return (L_DEWARP *)ERROR_PTR("dewa not defined", procName, NULL);
+
+    for (i = 0; i <= dewa->maxdist; i += 2) {
+        for (k = 0; k < 2; k++) {
+            if (i == 0 && k == 1)
+                break;
+            index = (k == 0) ? pageno - i : pageno + i;
+            if (index < 0 || index > dewa->maxpage)
+                continue;
+            if ((dew = dewa->dewarp[index]) == NULL)
+                continue;
+            if (dew->success == 0 || !dew->sampvdispar)
+                continue;
+            if (w <= 0 || h <= 0)
+                return dew;
+
+                /* Check that the disparity arrays cover the image */
+            valid = TRUE;
+            s = dew->sampling;
+            fpixGetDimensions(dew->sampvdispar, &fw, &fh);
+            if (s * (fw - 1) + 1 < w || s * (fh - 1) + 1 < h)
+                valid = FALSE;
+            if (dew->applyhoriz && dew->samphdispar) {
+                fpixGetDimensions(dew->samphdispar, &fw, &fh);
+                if (s * (fw - 1) + 1 < w + dew->extraw ||
+                    s * (fh - 1) + 1 < h)
+                    valid = FALSE;
+            }
+            if (valid)
+                return dew;
+        }
+    }
+
+    return NULL;
+}
+
+
+/*!
+ *  dewarpaApplyDisparity()
+ *
+ *      Input:  dewa
+ *              pageno (of pixs)
+ *              pixs (image to be dewarped; 1, 8 or 32 bpp)
+ *              &pixd (<return> dewarped image)
+ *      Return: 0 if OK, 1 on error or if no valid model is found
+ *
+ *  Notes:
+ *      (1) This finds the nearest valid model with dewarpaFindModel(),
+ *          and applies it with pixApplySampledDisparity().  The model
+ *          is not changed, so it can be applied to any number of pages.
+ *      (2) If there is no valid model, this returns 1 and pixd is null;
+ *          the caller can then use pixs without dewarping.
+ */
+l_int32
+dewarpaApplyDisparity(L_DEWARPA  *dewa,
+                      l_int32     pageno,
+                      PIX        *pixs,
+                      PIX       **ppixd)
+{
+l_int32    w, h, hsampling;
+FPIX      *fpixh;
+L_DEWARP  *dew;
+
+    PROCNAME("dewarpaApplyDisparity");
+
+    if (!ppixd)
+        return ERROR_INT("&pixd not defined", procName, 1);
+    *ppixd = NULL;
+    if (!dewa)
+        return ERROR_INT("dewa not defined", procName, 1);
+    if (!pixs)
+        return ERROR_INT("pixs not defined", procName, 1);
+
+    pixGetDimensions(pixs, &w, &h, NULL);
+    if ((dew = dewarpaFindModel(dewa, pageno, w, h)) == NULL) {
+        L_INFO_INT("no valid model for page %d", procName, pageno);
+        return 1;
+    }
+
+    fpixh = NULL;
+    hsampling = dew->sampling;
+    if (dew->applyhoriz) {  /* use the full res array if it exists */
+        if (dew->fullhdispar) {
+            fpixh = dew->fullhdispar;
+            hsampling = 1;
+        }
+        else
+            fpixh = dew->samphdispar;
+    }
+    if ((*ppixd = pixApplySampledDisparity(pixs, dew->sampvdispar, fpixh,
+                                           dew->sampling, hsampling,
+                                           dew->extraw)) == NULL)
+        return ERROR_INT("pixd not made", procName, 1);
+    return 0;
+}
+
+
+/*----------------------------------------------------------------------*
+ *                 Serialized I/O of models for a book                  *
+ *----------------------------------------------------------------------*/
+/*!
+ *  dewarpaRead()
+ *
+ *      Input:  filename
+ *      Return: dewa, or null on error
+ */
+L_DEWARPA *
+dewarpaRead(const char  *filename)
+{
+FILE       *fp;
+L_DEWARPA  *dewa;
+
+    PROCNAME("dewarpaRead");
+
+    if (!filename)
+        return (L_DEWARPA *)ERROR_PTR("filename not defined", procName, NULL);
+    if ((fp = fopenReadStream(filename)) == NULL)
+        return (L_DEWARPA *)ERROR_PTR("stream not opened", procName, NULL);
+
+    if ((dewa = dewarpaReadStream(fp)) == NULL) {
+        fclose(fp);
+        return (L_DEWARPA *)ERROR_PTR("dewa not read", procName, NULL);
+    }
+
+    fclose(fp);
+    return dewa;
+}
+
+
+/*!
+ *  dewarpaReadStream()
+ *
+ *      Input:  stream
+ *      Return: dewa, or null on error
+ *
+ *  Notes:
+ *      (1) The models are read with dewarpReadStream(), so they are
+ *          minimized, with only the sampled disparity arrays.
+ */
+L_DEWARPA *
+dewarpaReadStream(FILE  *fp)
+{
+l_int32     i, version, maxdist, nmodels;
+L_DEWARP   *dew;
+L_DEWARPA  *dewa;
+
+    PROCNAME("dewarpaReadStream");
+
+    if (!fp)
+        return (L_DEWARPA *)ERROR_PTR("stream not defined", procName, NULL);
+
+    if (fscanf(fp, "\nDewarpa Version %d\n", &version) != 1)
+        return (L_DEWARPA *)ERROR_PTR("not a dewarpa file", procName, NULL);
+    if (version != DEWARPA_VERSION_NUMBER)
+        return (L_DEWARPA *)ERROR_PTR("invalid dewarpa version",
+                                      procName, NULL);
+    if (fscanf(fp, "maxdist = %d, nmodels = %d\n", &maxdist, &nmodels) != 2)
+        return (L_DEWARPA *)ERROR_PTR("read fail for maxdist+",
+                                      procName, NULL);
+
+    if ((dewa = dewarpaCreate(0, maxdist)) == NULL)
+        return (L_DEWARPA *)ERROR_PTR("dewa not made", procName, NULL);
+    for (i = 0; i < nmodels; i++) {
+        if ((dew = dewarpReadStream(fp)) == NULL) {
+            dewarpaDestroy(&dewa);
+            return (L_DEWARPA *)ERROR_PTR("dew not read", procName, NULL);
+        }
+        dewarpaInsertDewarp(dewa, dew);
+    }
+
+    return dewa;
+}
+
+
+/*!
+ *  dewarpaWrite()
+ *
+ *      Input:  filename
+ *              dewa
+ *      Return: 0 if OK, 1 on error
+ */
+l_int32
+dewarpaWrite(const char  *filename,
+             L_DEWARPA   *dewa)
+{
+FILE  *fp;
+
+    PROCNAME("dewarpaWrite");
+
+    if (!filename)
+        return ERROR_INT("filename not defined", procName, 1);
+    if (!dewa)
+        return ERROR_INT("dewa not defined", procName, 1);
+
+    if ((fp = fopenWriteStream(filename, "wb")) == NULL)
+        return ERROR_INT("stream not opened", procName, 1);
+    if (dewarpaWriteStream(fp, dewa)) {
+        fclose(fp);
+        return ERROR_INT("dewa not written to stream", procName, 1);
+    }
+    fclose(fp);
+
+    return 0;
+}
+
+
+/*!
+ *  dewarpaWriteStream()
+ *
+ *      Input:  stream (opened for "wb")
+ *              dewa
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) Only the models that were built successfully are written,
+ *          in order of page number.
+ */
+l_int32
+dewarpaWriteStream(FILE       *fp,
+                   L_DEWARPA  *dewa)
+{
+l_int32    i, nmodels;
+L_DEWARP  *dew;
+
+    PROCNAME("dewarpaWriteStream");
+
+    if (!fp)
+        return ERROR_INT("stream not defined", procName, 1);
+    if (!dewa)
+        return ERROR_INT("dewa not defined", procName, 1);
+
+    nmodels = 0;
+    for (i = 0; i <= dewa->maxpage; i++) {
+        dew = dewa->dewarp[i];
+        if (dew && dew->success && dew->sampvdispar)
+            nmodels++;
+    }
+
+    fprintf(fp, "\nDewarpa Version %d\n", DEWARPA_VERSION_NUMBER);
+    fprintf(fp, "maxdist = %d, nmodels = %d\n", dewa->maxdist, nmodels);
+    for (i = 0; i <= dewa->maxpage; i++) {
+        dew = dewa->dewarp[i];
+        if (dew && dew->success && dew->sampvdispar)
+            dewarpWriteStream(fp, dew);
+    }
+
+    return 0;
+}
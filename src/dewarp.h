@@ -29,9 +29,14 @@
  *     The sampled vertical disparity array is expanded to full resolution,
  *     using linear interpolation, from which it is trivially applied
  *     to the input image.
+ *
+ *     A second data structure holds the models for the pages of a
+ *     book, indexed by page number, so that a model built for one
+ *     page can be applied to nearby pages with the same parity.
  */
 
-#define  DEWARP_VERSION_NUMBER      1
+#define  DEWARP_VERSION_NUMBER      2
+#define  DEWARPA_VERSION_NUMBER     1
 
 struct L_Dewarp
 {
@@ -54,4 +59,16 @@ struct L_Dewarp
 };
 typedef struct L_Dewarp L_DEWARP;
 
+
+struct L_Dewarpa
+{
+    l_int32            nalloc;      /* size of dewarp ptr array; the      */
+                                    /* page number is the array index     */
+    l_int32            maxpage;     /* largest page number with a model   */
+    struct L_Dewarp  **dewarp;      /* array of ptrs to page models       */
+    l_int32            maxdist;     /* max distance (in pages) from a     */
+                                    /* page to the model applied to it    */
+};
+typedef struct L_Dewarpa L_DEWARPA;
+
 #endif  /* LEPTONICA_DEWARP_H */
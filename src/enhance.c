@@ -32,7 +32,8 @@
  *           NUMA    *numaEqualizeTRC()
  *
  *      Generic TRC mapper
- *           PIX     *pixTRCMap()
+ *           l_int32  pixTRCMap()
+ *           l_int32  pixTRCMapGeneral()
  *
  *      Unsharp-masking
  *           PIX     *pixUnsharpMasking()
@@ -41,6 +42,9 @@
  *           PIX     *pixUnsharpMaskingGrayFast()
  *           PIX     *pixUnsharpMaskingGray1D()
  *           PIX     *pixUnsharpMaskingGray2D()
+ *           static PIX      *pixUnsharpMaskingBlock()
+ *           static void      unsharpAddRow()
+ *           static void      unsharpBlurRow()
  *
  *      Hue and saturation modification
  *           PIX     *pixModifyHue()
@@ -106,6 +110,13 @@ static const l_float32  ENHANCE_SCALE_FACTOR = 5.;
     /* Default number of pixels sampled to determine histogram */
 static const l_int32  DEFAULT_HISTO_SAMPLES = 100000;
 
+static PIX *pixUnsharpMaskingBlock(PIX *pixs, l_int32 halfwidth,
+                                   l_float32 fract);
+static void unsharpAddRow(l_uint32 *csum, l_uint32 *line, l_int32 w,
+                          l_int32 d, l_int32 shift, l_int32 subtract);
+static void unsharpBlurRow(l_uint32 *csum, l_int32 *brow, l_int32 w,
+                           l_int32 h, l_int32 i, l_int32 wc, l_int32 hc);
+
 
 /*-------------------------------------------------------------*
  *         Gamma TRC (tone reproduction curve) mapping         *
@@ -275,7 +286,7 @@ NUMA    *nag;
  *  Notes:
  *      (1) See usage notes in pixGammaTRC().
  *      (2) This version saves the alpha channel.  It is only valid
- *          for 32 bpp (no colormap), and is a bit slower.
+ *          for 32 bpp (no colormap).
  */
 PIX *
 pixGammaTRCWithAlpha(PIX       *pixd,
@@ -285,7 +296,6 @@ pixGammaTRCWithAlpha(PIX       *pixd,
                      l_int32    maxval)
 {
 NUMA  *nag;
-PIX   *pixalpha;
 
     PROCNAME("pixGammaTRCWithAlpha");
 
@@ -303,17 +313,15 @@ PIX   *pixalpha;
     if (gamma == 1.0 && minval == 0 && maxval == 255)
         return pixCopy(pixd, pixs);
 
-    pixalpha = pixGetRGBComponent(pixs, L_ALPHA_CHANNEL);  /* save */
     if (!pixd)  /* start with a copy if not in-place */
         pixd = pixCopy(NULL, pixs);
 
+        /* pixTRCMapGeneral() leaves the alpha channel unchanged */
     if ((nag = numaGammaTRC(gamma, minval, maxval)) == NULL)
         return (PIX *)ERROR_PTR("nag not made", procName, pixd);
-    pixTRCMap(pixd, NULL, nag);
-    pixSetRGBComponent(pixd, pixalpha, L_ALPHA_CHANNEL);  /* restore */
+    pixTRCMapGeneral(pixd, NULL, nag, nag, nag);
 
     numaDestroy(&nag);
-    pixDestroy(&pixalpha);
     return pixd;
 }
 
@@ -594,7 +602,7 @@ pixEqualizeTRC(PIX       *pixd,
 	       l_int32    factor)
 {
 l_int32   d;
-NUMA     *na;
+NUMA     *na, *nar, *nag, *nab;
 PIX      *pixt, *pix8;
 PIXCMAP  *cmap;
 
@@ -632,25 +640,20 @@ PIXCMAP  *cmap;
         pixTRCMap(pixd, NULL, na);
         numaDestroy(&na);
     }
-    else {  /* 32 bpp */
+    else {  /* 32 bpp; map all three components in one pass */
         pix8 = pixGetRGBComponent(pixd, COLOR_RED);
-        na = numaEqualizeTRC(pix8, fract, factor);
-        pixTRCMap(pix8, NULL, na);
-        pixSetRGBComponent(pixd, pix8, COLOR_RED);
-        numaDestroy(&na);
+        nar = numaEqualizeTRC(pix8, fract, factor);
         pixDestroy(&pix8);
         pix8 = pixGetRGBComponent(pixd, COLOR_GREEN);
-        na = numaEqualizeTRC(pix8, fract, factor);
-        pixTRCMap(pix8, NULL, na);
-        pixSetRGBComponent(pixd, pix8, COLOR_GREEN);
-        numaDestroy(&na);
+        nag = numaEqualizeTRC(pix8, fract, factor);
         pixDestroy(&pix8);
         pix8 = pixGetRGBComponent(pixd, COLOR_BLUE);
-        na = numaEqualizeTRC(pix8, fract, factor);
-        pixTRCMap(pix8, NULL, na);
-        pixSetRGBComponent(pixd, pix8, COLOR_BLUE);
-        numaDestroy(&na);
+        nab = numaEqualizeTRC(pix8, fract, factor);
         pixDestroy(&pix8);
+        pixTRCMapGeneral(pixd, NULL, nar, nag, nab);
+        numaDestroy(&nar);
+        numaDestroy(&nag);
+        numaDestroy(&nab);
     }
 
     return pixd;
@@ -743,7 +746,7 @@ pixTRCMap(PIX   *pixs,
           PIX   *pixm,
           NUMA  *na)
 {
-l_int32    w, h, d, wm, hm, wpl, wplm, i, j, sval8, dval8;
+l_int32    w, h, d, wm, hm, wpl, wplm, i, j, k, nwords, sval8, dval8;
 l_int32   *tab;
 l_uint32   sval32, dval32;
 l_uint32  *data, *datam, *line, *linem;
@@ -771,9 +774,19 @@ l_uint32  *data, *datam, *line, *linem;
     data = pixGetData(pixs);
     if (!pixm) {
         if (d == 8) {
+                /* The same table is used for each byte, so we can map
+                 * the 4 pixels in a word without regard to byte order. */
+            nwords = w / 4;
             for (i = 0; i < h; i++) {
                 line = data + i * wpl;
-                for (j = 0; j < w; j++) {
+                for (k = 0; k < nwords; k++) {
+                    sval32 = line[k];
+                    line[k] = tab[sval32 >> 24] << 24 |
+                              tab[(sval32 >> 16) & 0xff] << 16 |
+                              tab[(sval32 >> 8) & 0xff] << 8 |
+                              tab[sval32 & 0xff];
+                }
+                for (j = 4 * nwords; j < w; j++) {
                     sval8 = GET_DATA_BYTE(line, j);
                     dval8 = tab[sval8];
                     SET_DATA_BYTE(line, j, dval8);
@@ -795,49 +808,134 @@ l_uint32  *data, *datam, *line, *linem;
         }
     }
     else {
+            /* Skip over each 32 pixel run where the mask is empty */
         datam = pixGetData(pixm);
         wplm = pixGetWpl(pixm);
         pixGetDimensions(pixm, &wm, &hm, NULL);
-        if (d == 8) {
-            for (i = 0; i < h; i++) {
-                if (i >= hm)
-                    break;
-                line = data + i * wpl;
-                linem = datam + i * wplm;
-                for (j = 0; j < w; j++) {
-                    if (j >= wm)
-                        break;
+        wm = L_MIN(w, wm);
+        hm = L_MIN(h, hm);
+        for (i = 0; i < hm; i++) {
+            line = data + i * wpl;
+            linem = datam + i * wplm;
+            for (k = 0; 32 * k < wm; k++) {
+                if (linem[k] == 0)
+                    continue;
+                for (j = 32 * k; j < 32 * k + 32 && j < wm; j++) {
                     if (GET_DATA_BIT(linem, j) == 0)
                         continue;
-                    sval8 = GET_DATA_BYTE(line, j);
-                    dval8 = tab[sval8];
-                    SET_DATA_BYTE(line, j, dval8);
+                    if (d == 8) {
+                        sval8 = GET_DATA_BYTE(line, j);
+                        dval8 = tab[sval8];
+                        SET_DATA_BYTE(line, j, dval8);
+                    }
+                    else {  /* d == 32 */
+                        sval32 = *(line + j);
+                        dval32 =
+                          tab[(sval32 >> L_RED_SHIFT) & 0xff] << L_RED_SHIFT |
+                          tab[(sval32 >> L_GREEN_SHIFT) & 0xff] << L_GREEN_SHIFT |
+                          tab[(sval32 >> L_BLUE_SHIFT) & 0xff] << L_BLUE_SHIFT;
+                        *(line + j) = dval32;
+                    }
                 }
             }
         }
-        else {  /* d == 32 */
-            for (i = 0; i < h; i++) {
-                if (i >= hm)
-                    break;
-                line = data + i * wpl;
-                linem = datam + i * wplm;
-                for (j = 0; j < w; j++) {
-                    if (j >= wm)
-                        break;
+    }
+
+    FREE(tab);
+    return 0;
+}
+
+
+/*!
+ *  pixTRCMapGeneral()
+ *
+ *      Input:  pixs (32 bpp rgb; not colormapped)
+ *              pixm (<optional> 1 bpp mask)
+ *              nar, nag, nab (mapping arrays for each component)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This operation is in-place on pixs.
+ *      (2) Each of the r,g,b components is mapped with its own array,
+ *          all in a single pass over the image.  The arrays are of
+ *          size 256, and map the input index into values in [0, 255].
+ *      (3) If defined, the optional 1 bpp mask pixm has its origin
+ *          aligned with pixs, and the map functions are applied only
+ *          to pixels in pixs under the fg of pixm.
+ *      (4) Unlike pixTRCMap(), this saves the alpha channel.
+ */
+l_int32
+pixTRCMapGeneral(PIX   *pixs,
+                 PIX   *pixm,
+                 NUMA  *nar,
+                 NUMA  *nag,
+                 NUMA  *nab)
+{
+l_int32    w, h, wm, hm, wpl, wplm, i, j, k;
+l_int32   *tabr, *tabg, *tabb;
+l_uint32   sval32;
+l_uint32  *data, *datam, *line, *linem;
+
+    PROCNAME("pixTRCMapGeneral");
+
+    if (!pixs || pixGetDepth(pixs) != 32)
+        return ERROR_INT("pixs undefined or not 32 bpp", procName, 1);
+    if (pixm && pixGetDepth(pixm) != 1)
+        return ERROR_INT("pixm not 1 bpp", procName, 1);
+    if (!nar || !nag || !nab)
+        return ERROR_INT("na{r,g,b} not all defined", procName, 1);
+    if (numaGetCount(nar) != 256 || numaGetCount(nag) != 256 ||
+        numaGetCount(nab) != 256)
+        return ERROR_INT("na{r,g,b} not all of size 256", procName, 1);
+
+    tabr = numaGetIArray(nar);
+    tabg = numaGetIArray(nag);
+    tabb = numaGetIArray(nab);
+    pixGetDimensions(pixs, &w, &h, NULL);
+    wpl = pixGetWpl(pixs);
+    data = pixGetData(pixs);
+    if (!pixm) {
+        for (i = 0; i < h; i++) {
+            line = data + i * wpl;
+            for (j = 0; j < w; j++) {
+                sval32 = line[j];
+                line[j] =
+                    tabr[(sval32 >> L_RED_SHIFT) & 0xff] << L_RED_SHIFT |
+                    tabg[(sval32 >> L_GREEN_SHIFT) & 0xff] << L_GREEN_SHIFT |
+                    tabb[(sval32 >> L_BLUE_SHIFT) & 0xff] << L_BLUE_SHIFT |
+                    (sval32 & (0xff << L_ALPHA_SHIFT));
+            }
+        }
+    }
+    else {
+        datam = pixGetData(pixm);
+        wplm = pixGetWpl(pixm);
+        pixGetDimensions(pixm, &wm, &hm, NULL);
+        wm = L_MIN(w, wm);
+        hm = L_MIN(h, hm);
+        for (i = 0; i < hm; i++) {
+            line = data + i * wpl;
+            linem = datam + i * wplm;
+            for (k = 0; 32 * k < wm; k++) {
+                if (linem[k] == 0)
+                    continue;
+                for (j = 32 * k; j < 32 * k + 32 && j < wm; j++) {
                     if (GET_DATA_BIT(linem, j) == 0)
                         continue;
-                    sval32 = *(line + j);
-                    dval32 =
-                        tab[(sval32 >> L_RED_SHIFT) & 0xff] << L_RED_SHIFT |
-                        tab[(sval32 >> L_GREEN_SHIFT) & 0xff] << L_GREEN_SHIFT |
-                        tab[(sval32 >> L_BLUE_SHIFT) & 0xff] << L_BLUE_SHIFT;
-                    *(line + j) = dval32;
+                    sval32 = line[j];
+                    line[j] =
+                      tabr[(sval32 >> L_RED_SHIFT) & 0xff] << L_RED_SHIFT |
+                      tabg[(sval32 >> L_GREEN_SHIFT) & 0xff] << L_GREEN_SHIFT |
+                      tabb[(sval32 >> L_BLUE_SHIFT) & 0xff] << L_BLUE_SHIFT |
+                      (sval32 & (0xff << L_ALPHA_SHIFT));
                 }
             }
         }
     }
 
-    FREE(tab);
+    FREE(tabr);
+    FREE(tabg);
+    FREE(tabb);
     return 0;
 }
 
@@ -867,8 +965,7 @@ pixUnsharpMasking(PIX       *pixs,
                   l_int32    halfwidth,
                   l_float32  fract)
 {
-l_int32  d;
-PIX     *pixt, *pixd, *pixr, *pixrs, *pixg, *pixgs, *pixb, *pixbs;
+PIX  *pixt, *pixd;
 
     PROCNAME("pixUnsharpMasking");
 
@@ -886,25 +983,8 @@ PIX     *pixt, *pixd, *pixr, *pixrs, *pixg, *pixgs, *pixb, *pixbs;
     if ((pixt = pixConvertTo8Or32(pixs, 0, 1)) == NULL)
         return (PIX *)ERROR_PTR("pixt not made", procName, NULL);
 
-        /* Sharpen */
-    d = pixGetDepth(pixt);
-    if (d == 8)
-        pixd = pixUnsharpMaskingGray(pixt, halfwidth, fract);
-    else {  /* d == 32 */
-        pixr = pixGetRGBComponent(pixs, COLOR_RED);
-        pixrs = pixUnsharpMaskingGray(pixr, halfwidth, fract);
-        pixDestroy(&pixr);
-        pixg = pixGetRGBComponent(pixs, COLOR_GREEN);
-        pixgs = pixUnsharpMaskingGray(pixg, halfwidth, fract);
-        pixDestroy(&pixg);
-        pixb = pixGetRGBComponent(pixs, COLOR_BLUE);
-        pixbs = pixUnsharpMaskingGray(pixb, halfwidth, fract);
-        pixDestroy(&pixb);
-        pixd = pixCreateRGBImage(pixrs, pixgs, pixbs);
-        pixDestroy(&pixrs);
-        pixDestroy(&pixgs);
-        pixDestroy(&pixbs);
-    }
+        /* Sharpen all components together in a single pass */
+    pixd = pixUnsharpMaskingBlock(pixt, halfwidth, fract);
 
     pixDestroy(&pixt);
     return pixd;
@@ -933,8 +1013,6 @@ pixUnsharpMaskingGray(PIX       *pixs,
                       l_float32  fract)
 {
 l_int32  w, h, d;
-PIX     *pixc, *pixd;
-PIXACC  *pixacc;
 
     PROCNAME("pixUnsharpMaskingGray");
 
@@ -951,41 +1029,294 @@ PIXACC  *pixacc;
         return pixUnsharpMaskingGrayFast(pixs, halfwidth, fract,
                                          L_BOTH_DIRECTIONS);
 
-    if ((pixc = pixBlockconvGray(pixs, NULL, halfwidth, halfwidth)) == NULL)
-        return (PIX *)ERROR_PTR("pixc not made", procName, NULL);
-
-        /* Steps:
-         *    (1) edge image is pixs - pixc  (this is highpass part)
-         *    (2) multiply edge image by fract
-         *    (3) add fraction of edge to pixs
-         *
-         * To show how this is done with both interfaces to arithmetic
-         * on integer Pix, here is the implementation in the lower-level
-         * function calls:
-         *    pixt = pixInitAccumulate(w, h, 0x10000000)) == NULL)
-         *    pixAccumulate(pixt, pixs, L_ARITH_ADD);
-         *    pixAccumulate(pixt, pixc, L_ARITH_SUBTRACT);
-         *    pixMultConstAccumulate(pixt, fract, 0x10000000);
-         *    pixAccumulate(pixt, pixs, L_ARITH_ADD);
-         *    pixd = pixFinalAccumulate(pixt, 0x10000000, 8)) == NULL)
-         *    pixDestroy(&pixt);
-         *
-         * The code below does the same thing using the Pixacc accumulator,
-         * hiding the details of the offset that is needed for subtraction.
-         */
-    pixacc = pixaccCreate(w, h, 1);
-    pixaccAdd(pixacc, pixs);
-    pixaccSubtract(pixacc, pixc);
-    pixaccMultConst(pixacc, fract);
-    pixaccAdd(pixacc, pixs);
-    pixd = pixaccFinal(pixacc, 8);
-    pixaccDestroy(&pixacc);
-
-    pixDestroy(&pixc);
+    return pixUnsharpMaskingBlock(pixs, halfwidth, fract);
+}
+
+
+/*!
+ *  pixUnsharpMaskingBlock()
+ *
+ *      Input:  pixs (8 bpp gray or 32 bpp rgb; no colormap)
+ *              halfwidth  ("half-width" of smoothing filter)
+ *              fract  (fraction of edge added back into image)
+ *      Return: pixd, or null on error
+ *
+ *  Notes:
+ *      (1) This gives the same result as computing the block convolution
+ *          pixc = pixBlockconvGray(pixs, NULL, halfwidth, halfwidth)
+ *          for each component, and then setting each pixel to
+ *              pixs + fract * (pixs - pixc)
+ *          with the same rounding and clipping as the Pixacc functions.
+ *      (2) It is done in a single pass over the image, without making
+ *          the accumulator, the convolved image, or any of the separate
+ *          component images.  For each component, the column sums over
+ *          the current vertical window are held in an array, and are
+ *          updated by adding the row that enters the window and
+ *          subtracting the row that leaves it.  Each row of the
+ *          convolution is then found with a running sum along the row.
+ *      (3) For 32 bpp, the alpha component of pixd is set to 0,
+ *          as with pixCreateRGBImage().
+ */
+static PIX *
+pixUnsharpMaskingBlock(PIX       *pixs,
+                       l_int32    halfwidth,
+                       l_float32  fract)
+{
+l_int32    w, h, d, wc, hc, nc, wpls, wpld, i, j, k, ilo, ihi, ival;
+l_int32    sval, dval, rval, gval, bval;
+l_int32    shift[3];
+l_int32   *brow[3];
+l_uint32  *csum[3];
+l_uint32  *datas, *datad, *lines, *lined;
+PIX       *pixd;
+
+    PROCNAME("pixUnsharpMaskingBlock");
+
+    pixGetDimensions(pixs, &w, &h, &d);
+    wc = L_MIN(halfwidth, (w - 1) / 2);
+    hc = L_MIN(halfwidth, (h - 1) / 2);
+    if (wc == 0 && hc == 0)  /* the convolution is a no-op */
+        return pixCopy(NULL, pixs);
+
+    nc = (d == 8) ? 1 : 3;
+    shift[0] = L_RED_SHIFT;
+    shift[1] = L_GREEN_SHIFT;
+    shift[2] = L_BLUE_SHIFT;
+    for (k = 0; k < 3; k++) {
+        csum[k] = NULL;
+        brow[k] = NULL;
+    }
+    pixd = pixCreateTemplate(pixs);
+    for (k = 0; k < nc; k++) {
+        csum[k] = (l_uint32 *)CALLOC(w, sizeof(l_uint32));
+        brow[k] = (l_int32 *)CALLOC(w, sizeof(l_int32));
+        if (!csum[k] || !brow[k])
+            pixDestroy(&pixd);
+    }
+    if (!pixd) {
+        L_ERROR("pixd or arrays not made", procName);
+        goto cleanup;
+    }
+
+    datas = pixGetData(pixs);
+    wpls = pixGetWpl(pixs);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+
+        /* As in blockconvLow(), the window for row i covers the rows
+         * from L_MAX(i - hc, 1) to L_MIN(i + hc, h - 1). */
+    ilo = 1;
+    ihi = L_MIN(hc, h - 1);
+    for (ival = ilo; ival <= ihi; ival++) {
+        for (k = 0; k < nc; k++)
+            unsharpAddRow(csum[k], datas + ival * wpls, w, d, shift[k], 0);
+    }
+    for (i = 0; i < h; i++) {
+        if (i - hc > ilo) {  /* row ilo leaves the window */
+            for (k = 0; k < nc; k++)
+                unsharpAddRow(csum[k], datas + ilo * wpls, w, d,
+                              shift[k], 1);
+            ilo++;
+        }
+        if (i + hc < h && i + hc > ihi) {  /* row i + hc enters */
+            ihi = i + hc;
+            for (k = 0; k < nc; k++)
+                unsharpAddRow(csum[k], datas + ihi * wpls, w, d,
+                              shift[k], 0);
+        }
+        for (k = 0; k < nc; k++)
+            unsharpBlurRow(csum[k], brow[k], w, h, i, wc, hc);
+
+            /* Add back the fraction of the edge image */
+        lines = datas + i * wpls;
+        lined = datad + i * wpld;
+        if (d == 8) {
+            for (j = 0; j < w; j++) {
+                sval = GET_DATA_BYTE(lines, j);
+                dval = sval + (l_int32)((sval - brow[0][j]) * fract);
+                dval = L_MAX(0, L_MIN(255, dval));
+                SET_DATA_BYTE(lined, j, dval);
+            }
+        }
+        else {  /* d == 32 */
+            for (j = 0; j < w; j++) {
+                sval = (lines[j] >> L_RED_SHIFT) & 0xff;
+                rval = sval + (l_int32)((sval - brow[0][j]) * fract);
+                rval = L_MAX(0, L_MIN(255, rval));
+                sval = (lines[j] >> L_GREEN_SHIFT) & 0xff;
+                gval = sval + (l_int32)((sval - brow[1][j]) * fract);
+                gval = L_MAX(0, L_MIN(255, gval));
+                sval = (lines[j] >> L_BLUE_SHIFT) & 0xff;
+                bval = sval + (l_int32)((sval - brow[2][j]) * fract);
+                bval = L_MAX(0, L_MIN(255, bval));
+                lined[j] = (rval << L_RED_SHIFT) | (gval << L_GREEN_SHIFT) |
+                           (bval << L_BLUE_SHIFT);
+            }
+        }
+    }
+
+cleanup:
+    for (k = 0; k < nc; k++) {
+        FREE(csum[k]);
+        FREE(brow[k]);
+    }
     return pixd;
 }
 
 
+/*!
+ *  unsharpAddRow()
+ *
+ *      Input:  csum (array of column sums)
+ *              line (raster line of 8 or 32 bpp src)
+ *              w (width)
+ *              d (depth of src)
+ *              shift (of the component, for 32 bpp)
+ *              subtract (1 to subtract the line; 0 to add it)
+ *      Return: void
+ */
+static void
+unsharpAddRow(l_uint32  *csum,
+              l_uint32  *line,
+              l_int32    w,
+              l_int32    d,
+              l_int32    shift,
+              l_int32    subtract)
+{
+l_int32  j;
+
+    if (d == 8) {
+        if (subtract) {
+            for (j = 0; j < w; j++)
+                csum[j] -= GET_DATA_BYTE(line, j);
+        }
+        else {
+            for (j = 0; j < w; j++)
+                csum[j] += GET_DATA_BYTE(line, j);
+        }
+    }
+    else {  /* d == 32 */
+        if (subtract) {
+            for (j = 0; j < w; j++)
+                csum[j] -= (line[j] >> shift) & 0xff;
+        }
+        else {
+            for (j = 0; j < w; j++)
+                csum[j] += (line[j] >> shift) & 0xff;
+        }
+    }
+    return;
+}
+
+
+/*!
+ *  unsharpBlurRow()
+ *
+ *      Input:  csum (column sums over the vertical window for row i)
+ *              brow (<return> row i of the block convolution)
+ *              w, h (image size)
+ *              i (row)
+ *              wc, hc (half-width and half-height of the block)
+ *      Return: void
+ *
+ *  Notes:
+ *      (1) This makes row i of the block convolution from the column
+ *          sums, using the same arithmetic, including the rescaling of
+ *          pixels near the boundary, as blockconvLow().
+ */
+static void
+unsharpBlurRow(l_uint32  *csum,
+               l_int32   *brow,
+               l_int32    w,
+               l_int32    h,
+               l_int32    i,
+               l_int32    wc,
+               l_int32    hc)
+{
+l_int32    j, jlo, jhi, wn, hn, fwc, fhc, wmwc, hmhc;
+l_uint32   sum, val;
+l_float32  norm, normh, normw;
+
+    fwc = 2 * wc + 1;
+    fhc = 2 * hc + 1;
+    wmwc = w - wc;
+    hmhc = h - hc;
+    norm = 1. / (fwc * fhc);
+
+        /* The window for column j covers the columns
+         * from L_MAX(j - wc, 1) to L_MIN(j + wc, w - 1). */
+    jlo = 1;
+    jhi = L_MIN(wc, w - 1);
+    sum = 0;
+    for (j = jlo; j <= jhi; j++)
+        sum += csum[j];
+    for (j = 0; j < w; j++) {
+        if (j - wc > jlo)
+            sum -= csum[jlo++];
+        if (j + wc < w && j + wc > jhi)
+            sum += csum[++jhi];
+        brow[j] = (l_uint8)(norm * sum + 0.5);
+    }
+
+        /* Fix normalization for boundary pixels */
+    if (i <= hc) {  /* first hc + 1 lines */
+        hn = hc + i;
+        normh = (l_float32)fhc / (l_float32)hn;
+        for (j = 0; j <= wc; j++) {
+            wn = wc + j;
+            normw = (l_float32)fwc / (l_float32)wn;
+            val = brow[j];
+            brow[j] = (l_uint8)L_MIN(val * normh * normw, 255);
+        }
+        for (j = wc + 1; j < wmwc; j++) {
+            val = brow[j];
+            brow[j] = (l_uint8)L_MIN(val * normh, 255);
+        }
+        for (j = wmwc; j < w; j++) {
+            wn = wc + w - j;
+            normw = (l_float32)fwc / (l_float32)wn;
+            val = brow[j];
+            brow[j] = (l_uint8)L_MIN(val * normh * normw, 255);
+        }
+    }
+    if (i >= hmhc) {  /* last hc lines */
+        hn = hc + h - i;
+        normh = (l_float32)fhc / (l_float32)hn;
+        for (j = 0; j <= wc; j++) {
+            wn = wc + j;
+            normw = (l_float32)fwc / (l_float32)wn;
+            val = brow[j];
+            brow[j] = (l_uint8)L_MIN(val * normh * normw, 255);
+        }
+        for (j = wc + 1; j < wmwc; j++) {
+            val = brow[j];
+            brow[j] = (l_uint8)L_MIN(val * normh, 255);
+        }
+        for (j = wmwc; j < w; j++) {
+            wn = wc + w - j;
+            normw = (l_float32)fwc / (l_float32)wn;
+            val = brow[j];
+            brow[j] = (l_uint8)L_MIN(val * normh * normw, 255);
+        }
+    }
+    if (i > hc && i < hmhc) {  /* intermediate lines */
+        for (j = 0; j <= wc; j++) {
+            wn = wc + j;
+            normw = (l_float32)fwc / (l_float32)wn;
+            val = brow[j];
+            brow[j] = (l_uint8)L_MIN(val * normw, 255);
+        }
+        for (j = wmwc; j < w; j++) {
+            wn = wc + w - j;
+            normw = (l_float32)fwc / (l_float32)wn;
+            val = brow[j];
+            brow[j] = (l_uint8)L_MIN(val * normw, 255);
+        }
+    }
+    return;
+}
+
+
 /*!
  *  pixUnsharpMaskingFast()
  *
@@ -1054,13 +1385,13 @@ PIX     *pixt, *pixd, *pixr, *pixrs, *pixg, *pixgs, *pixb, *pixbs;
     if (d == 8)
         pixd = pixUnsharpMaskingGrayFast(pixt, halfwidth, fract, direction);
     else {  /* d == 32 */
-        pixr = pixGetRGBComponent(pixs, COLOR_RED);
+        pixr = pixGetRGBComponent(pixt, COLOR_RED);
         pixrs = pixUnsharpMaskingGrayFast(pixr, halfwidth, fract, direction);
         pixDestroy(&pixr);
-        pixg = pixGetRGBComponent(pixs, COLOR_GREEN);
+        pixg = pixGetRGBComponent(pixt, COLOR_GREEN);
         pixgs = pixUnsharpMaskingGrayFast(pixg, halfwidth, fract, direction);
         pixDestroy(&pixg);
-        pixb = pixGetRGBComponent(pixs, COLOR_BLUE);
+        pixb = pixGetRGBComponent(pixt, COLOR_BLUE);
         pixbs = pixUnsharpMaskingGrayFast(pixb, halfwidth, fract, direction);
         pixDestroy(&pixb);
         pixd = pixCreateRGBImage(pixrs, pixgs, pixbs);
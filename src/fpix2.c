@@ -176,8 +176,8 @@ fpixConvertToPix(FPIX    *fpixs,
                  l_int32  negvals,
                  l_int32  errorflag)
 {
-l_int32     w, h, i, j, wpls, wpld, maxval;
-l_uint32    vald;
+l_int32     w, h, i, j, wpls, wpld;
+l_uint32    vald, maxval;
 l_float32   val;
 l_float32  *datas, *lines;
 l_uint32   *datad, *lined;
@@ -212,7 +212,10 @@ PIX        *pixd;
             if (outdepth == 32) break;
         }
     }
-    maxval = (1 << outdepth) - 1;
+    if (outdepth == 32)
+        maxval = 0xffffffff;
+    else
+        maxval = (1 << outdepth) - 1;
 
         /* Gather statistics if @errorflag = TRUE */
     if (errorflag) {
@@ -244,16 +247,16 @@ PIX        *pixd;
         lined = datad + i * wpld;
         for (j = 0; j < w; j++) {
             val = lines[j];
-            if (val >= 0.0)
-                vald = (l_uint32)(val + 0.5);
-            else {  /* val < 0.0 */
+            if (val < 0.0) {
                 if (negvals == L_CLIP_TO_ZERO)
-                    vald = 0;
+                    val = 0.0;
                 else
-                    vald = (l_uint32)(-val + 0.5);
+                    val = -val;
             }
-            if (vald > maxval)
+            if (val >= (l_float32)maxval)  /* avoid overflow in the cast */
                 vald = maxval;
+            else
+                vald = (l_uint32)(val + 0.5);
             if (outdepth == 8)
                 SET_DATA_BYTE(lined, j, vald);
             else if (outdepth == 16)
@@ -18,14 +18,19 @@
  *
  *    Read gif from file
  *          PIX        *pixReadStreamGif()
+ *          static PIX *gifToPix()
  *          static PIX *pixInterlaceGIF()
+ *          l_int32     sreadHeaderGif()
  *
  *    Write gif to file
  *          l_int32     pixWriteStreamGif()
+ *          static l_int32  pixToGif()
  *
- *    Read/write from/to memory (see warning)
+ *    Read/write from/to memory
  *          PIX        *pixReadMemGif()
  *          l_int32     pixWriteMemGif()
+ *          static l_int32  gifReadFunc()
+ *          static l_int32  gifWriteFunc()
  *     
  *    This uses the gif library, version 4.1.6.  Do not use 4.1.4.
  *
@@ -52,6 +57,24 @@
 
 #include "gif_lib.h"
 
+    /* Memory buffer for reading and writing gif data in memory.
+     * For reading, the data is not owned; for writing, the data
+     * is grown by doubling as the encoder fills it. */
+struct L_GifBuffer {
+    l_uint8  *data;      /* gif data                                 */
+    size_t    size;      /* number of bytes of data                  */
+    size_t    nalloc;    /* allocated bytes (for writing only)       */
+    size_t    pos;       /* current read position (for reading only) */
+};
+typedef struct L_GifBuffer  L_GIF_BUFFER;
+
+static PIX * gifToPix(GifFileType *gif);
+static l_int32 pixToGif(PIX *pix, GifFileType *gif);
+static l_int32 gifReadFunc(GifFileType *gif, GifByteType *dest,
+                           l_int32 bytesToRead);
+static l_int32 gifWriteFunc(GifFileType *gif, const GifByteType *src,
+                            l_int32 bytesToWrite);
+
     /* GIF supports 4-way horizontal interlacing */
 static PIX * pixInterlaceGIF(PIX  *pixs);
 static const l_int32 InterlacedOffset[] = {0, 4, 2, 1};
@@ -70,14 +93,8 @@ static const l_int32 InterlacedJumps[] = {8, 8, 4, 2};
 PIX *
 pixReadStreamGif(FILE  *fp)
 {
-l_int32          fd, wpl, i, j, w, h, d, cindex, ncolors;
-l_int32          rval, gval, bval;
-l_uint32        *data, *line;
-GifFileType     *gif;
-PIX             *pixd, *pixdi;
-PIXCMAP         *cmap;
-ColorMapObject  *gif_cmap;
-SavedImage       si;
+l_int32       fd;
+GifFileType  *gif;
 
     PROCNAME("pixReadStreamGif");
 
@@ -93,6 +110,33 @@ SavedImage       si;
         return (PIX *)ERROR_PTR("invalid file or file not found",
                                 procName, NULL);
 
+    return gifToPix(gif);
+}
+
+
+/*!
+ *  gifToPix()
+ *
+ *      Input:  gif (opened gif stream)
+ *      Return: pix, or null on error
+ *
+ *  Notes:
+ *      (1) This decodes the first image in the gif stream, which can
+ *          be opened on a file or on memory.  It closes the stream.
+ */
+static PIX *
+gifToPix(GifFileType  *gif)
+{
+l_int32          wpl, i, j, w, h, d, cindex, ncolors;
+l_int32          rval, gval, bval;
+l_uint32        *data, *line;
+PIX             *pixd, *pixdi;
+PIXCMAP         *cmap;
+ColorMapObject  *gif_cmap;
+SavedImage       si;
+
+    PROCNAME("gifToPix");
+
         /* Read all the data, but use only the first image found */
     if (DGifSlurp(gif) != GIF_OK) {
         DGifCloseFile(gif);
@@ -140,8 +184,10 @@ SavedImage       si;
         d = 4;
     else
         d = 8;
-    if ((cmap = pixcmapCreate(d)) == NULL)
+    if ((cmap = pixcmapCreate(d)) == NULL) {
+        DGifCloseFile(gif);
         return (PIX *)ERROR_PTR("cmap creation failed", procName, NULL);
+    }
 
     for (cindex = 0; cindex < ncolors; cindex++) {
         rval = gif_cmap->Colors[cindex].Red;
@@ -222,6 +268,93 @@ PIX       *pixd;
 }
 
 
+/*!
+ *  sreadHeaderGif()
+ *
+ *      Input:  data (gif file data)
+ *              size (of data, in bytes)
+ *              &width (<return>)
+ *              &height (<return>)
+ *              &bps (<return>, bits/sample)
+ *              &spp (<return>, samples/pixel)
+ *              &iscmap (<optional return>; input NULL to ignore)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This walks the gif blocks up to the descriptor of the first
+ *          image, without decoding anything, and returns the values
+ *          for the pix that gifToPix() would make.  The depth is
+ *          determined by the size of the colormap for that image.
+ *      (2) Gif images always have a colormap, so iscmap is returned as 1.
+ */
+l_int32
+sreadHeaderGif(const l_uint8  *data,
+               size_t          size,
+               l_int32        *pwidth,
+               l_int32        *pheight,
+               l_int32        *pbps,
+               l_int32        *pspp,
+               l_int32        *piscmap)
+{
+l_int32  ncolors, w, h;
+size_t   pos;
+
+    PROCNAME("sreadHeaderGif");
+
+    if (!data)
+        return ERROR_INT("data not defined", procName, 1);
+    if (!pwidth || !pheight || !pbps || !pspp)
+        return ERROR_INT("input ptr(s) not defined", procName, 1);
+    *pwidth = *pheight = *pbps = *pspp = 0;
+    if (piscmap)
+      *piscmap = 0;
+    if (size < 13 || strncmp((const char *)data, "GIF8", 4) != 0)
+        return ERROR_INT("not a valid gif file", procName, 1);
+
+        /* Logical screen descriptor, followed by the global colormap */
+    ncolors = 0;
+    pos = 13;
+    if (data[10] & 0x80) {
+        ncolors = 1 << ((data[10] & 0x07) + 1);
+        pos += 3 * ncolors;
+    }
+
+        /* Skip extension blocks until the first image descriptor */
+    while (pos < size && data[pos] == 0x21) {
+        pos += 2;  /* introducer and label */
+        while (pos < size && data[pos] != 0)  /* data sub-blocks */
+            pos += data[pos] + 1;
+        pos++;  /* block terminator */
+    }
+    if (pos + 10 > size || data[pos] != 0x2c)
+        return ERROR_INT("no image found in gif", procName, 1);
+
+    w = data[pos + 5] | (data[pos + 6] << 8);
+    h = data[pos + 7] | (data[pos + 8] << 8);
+    if (data[pos + 9] & 0x80)  /* private colormap for this image */
+        ncolors = 1 << ((data[pos + 9] & 0x07) + 1);
+    if (w <= 0 || h <= 0)
+        return ERROR_INT("invalid image dimensions", procName, 1);
+    if (ncolors == 0)
+        return ERROR_INT("color map is missing", procName, 1);
+
+    *pwidth = w;
+    *pheight = h;
+    if (ncolors <= 2)
+        *pbps = 1;
+    else if (ncolors <= 4)
+        *pbps = 2;
+    else if (ncolors <= 16)
+        *pbps = 4;
+    else
+        *pbps = 8;
+    *pspp = 1;
+    if (piscmap)
+        *piscmap = 1;
+    return 0;
+}
+
+
 /*---------------------------------------------------------------------*
  *                         Writing gif to file                         *
  *---------------------------------------------------------------------*/
@@ -244,15 +377,8 @@ l_int32
 pixWriteStreamGif(FILE  *fp,
                   PIX   *pix)
 {
-char            *text;
-l_int32          fd, wpl, i, j, w, h, d, ncolor, rval, gval, bval;
-l_int32          gif_ncolor = 0;
-l_uint32        *data, *line;
-PIX             *pixd;
-PIXCMAP         *cmap;
-GifFileType     *gif;
-ColorMapObject  *gif_cmap;
-GifByteType     *gif_line;
+l_int32       fd;
+GifFileType  *gif;
 
     PROCNAME("pixWriteStreamGif");
 
@@ -265,6 +391,41 @@ GifByteType     *gif_line;
     if ((fd = fileno(fp)) < 0)
         return ERROR_INT("invalid file descriptor", procName, 1);
 
+        /* Get the gif file handle */
+    if ((gif = EGifOpenFileHandle(fd)) == NULL)
+        return ERROR_INT("failed to create GIF image handle", procName, 1);
+
+    return pixToGif(pix, gif);
+}
+
+
+/*!
+ *  pixToGif()
+ *
+ *      Input:  pix (1, 2, 4, 8, 16 or 32 bpp)
+ *              gif (opened gif stream)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This encodes the pix to the gif stream, which can be
+ *          opened on a file or on memory.  It closes the stream.
+ *      (2) See pixWriteStreamGif() for usage.
+ */
+static l_int32
+pixToGif(PIX          *pix,
+         GifFileType  *gif)
+{
+char            *text;
+l_int32          wpl, i, j, w, h, d, ncolor, rval, gval, bval;
+l_int32          gif_ncolor = 0;
+l_uint32        *data, *line;
+PIX             *pixd;
+PIXCMAP         *cmap;
+ColorMapObject  *gif_cmap;
+GifByteType     *gif_line;
+
+    PROCNAME("pixToGif");
+
     d = pixGetDepth(pix);
     if (d == 32) {
         pixd = pixConvertRGBToColormap(pix, 1);
@@ -282,12 +443,15 @@ GifByteType     *gif_line;
         }
     }
 
-    if (!pixd)
+    if (!pixd) {
+        EGifCloseFile(gif);
         return ERROR_INT("failed to convert image to indexed", procName, 1);
+    }
     d = pixGetDepth(pixd);
 
     if ((cmap = pixGetColormap(pixd)) == NULL) {
         pixDestroy(&pixd);
+        EGifCloseFile(gif);
         return ERROR_INT("cmap is missing", procName, 1);
     }
 
@@ -301,12 +465,14 @@ GifByteType     *gif_line;
     }
     if (gif_ncolor < 1) {
         pixDestroy(&pixd);
+        EGifCloseFile(gif);
         return ERROR_INT("number of colors is invalid", procName, 1);
     }
 
         /* Save the cmap colors in a gif_cmap */
     if ((gif_cmap = MakeMapObject(gif_ncolor, NULL)) == NULL) {
         pixDestroy(&pixd);
+        EGifCloseFile(gif);
         return ERROR_INT("failed to create GIF color map", procName, 1);
     }
     for (i = 0; i < gif_ncolor; i++) {
@@ -315,6 +481,7 @@ GifByteType     *gif_line;
             if (pixcmapGetColor(cmap, i, &rval, &gval, &bval) != 0) {
                 pixDestroy(&pixd);
                 FreeMapObject(gif_cmap);
+                EGifCloseFile(gif);
                 return ERROR_INT("failed to get color from color map",
                                  procName, 1);
             }
@@ -325,13 +492,6 @@ GifByteType     *gif_line;
         gif_cmap->Colors[i].Blue = bval;
     }
 
-        /* Get the gif file handle */
-    if ((gif = EGifOpenFileHandle(fd)) == NULL) {
-        pixDestroy(&pixd);
-        FreeMapObject(gif_cmap);
-        return ERROR_INT("failed to create GIF image handle", procName, 1);
-    }
-
     pixGetDimensions(pixd, &w, &h, NULL);
     if (EGifPutScreenDesc(gif, w, h, gif_cmap->BitsPerPixel, 0, gif_cmap)
         != GIF_OK) {
@@ -403,7 +563,8 @@ GifByteType     *gif_line;
 
     FREE(gif_line);
     pixDestroy(&pixd);
-    EGifCloseFile(gif);
+    if (EGifCloseFile(gif) != GIF_OK)
+        return ERROR_INT("failed to close gif stream", procName, 1);
     return 0;
 }
 
@@ -419,46 +580,30 @@ GifByteType     *gif_line;
  *      Return: pix, or null on error
  *
  *  Notes:
- *      (1) Of course, we are cheating here -- writing the data out
- *          to file and then reading it back in as a gif format.
- *      (2) This should not be assumed to be safe from a sophisticated
- *          attack, even though we have attempted to make the filename
- *          difficult to guess by embedding the process number and the
- *          current time in microseconds.  The best way to handle
- *          temporary files is to use file descriptors (capabilities)
- *          or file handles.  However, I know of no way to do this
- *          for gif files because of the way that libgif handles the
- *          file descriptors.  The canonical approach would be to do this:
- *              char templ[] = "hiddenfilenameXXXXXX";
- *              l_int32 fd = mkstemp(templ);
- *              FILE *fp = fdopen(fd, "w+b");
- *              fwrite(data, 1, size, fp);
- *              rewind(fp);
- *              Pix *pix = pixReadStreamGif(fp);
- *          but this fails because fp is in a bad state after writing.
+ *      (1) The gif library reads the data directly from memory,
+ *          through gifReadFunc().  No temporary file is used.
  */
 PIX *
 pixReadMemGif(const l_uint8  *cdata,
               size_t          size)
 {
-char     *tname;
-l_uint8  *data;
-PIX      *pix;
+GifFileType   *gif;
+L_GIF_BUFFER   buffer;
 
     PROCNAME("pixReadMemGif");
 
     if (!cdata)
         return (PIX *)ERROR_PTR("cdata not defined", procName, NULL);
 
-    data = (l_uint8 *)cdata;  /* we're really not going to change this */
-    tname = genTempFilename("/tmp/", "mem.gif", 1, 1);
-    l_binaryWrite(tname, "w", data, size);
-    pix = pixRead(tname);
-    remove(tname);
-    FREE(tname);
-    if (!pix)
-        return (PIX *)ERROR_PTR("pix not read", procName, NULL);
-    return pix;
+    buffer.data = (l_uint8 *)cdata;  /* we're really not going to change this */
+    buffer.size = size;
+    buffer.nalloc = 0;
+    buffer.pos = 0;
+    if ((gif = DGifOpen((void *)&buffer, gifReadFunc)) == NULL)
+        return (PIX *)ERROR_PTR("could not open gif stream from memory",
+                                procName, NULL);
+
+    return gifToPix(gif);
 }
 
 
@@ -471,39 +616,119 @@ PIX      *pix;
  *      Return: 0 if OK, 1 on error
  *
  *  Notes:
- *      (1) See comments in pixReadMemGif()
+ *      (1) The gif library writes the data directly to a memory
+ *          buffer, through gifWriteFunc().  No temporary file is used.
  */
 l_int32
 pixWriteMemGif(l_uint8  **pdata,
                size_t    *psize,
                PIX       *pix)
 {
-char     *tname;
-l_uint8  *data;
-size_t    nbytes;
+GifFileType   *gif;
+L_GIF_BUFFER   buffer;
 
     PROCNAME("pixWriteMemGif");
 
     if (!pdata)
         return ERROR_INT("&data not defined", procName, 1 );
+    *pdata = NULL;
     if (!psize)
         return ERROR_INT("&size not defined", procName, 1 );
+    *psize = 0;
     if (!pix)
         return ERROR_INT("&pix not defined", procName, 1 );
 
-    tname = genTempFilename("/tmp/", "mem.gif", 1, 1);
-    pixWrite(tname, pix, IFF_GIF);
-    data = l_binaryRead(tname, &nbytes);
-    remove(tname);
-    FREE(tname);
-    if (!data)
-        return ERROR_INT("data not returned", procName, 1 );
-    *pdata = data;
-    *psize = nbytes;
+    buffer.nalloc = 4096;
+    if ((buffer.data = (l_uint8 *)MALLOC(buffer.nalloc)) == NULL)
+        return ERROR_INT("buffer not made", procName, 1);
+    buffer.size = 0;
+    buffer.pos = 0;
+    if ((gif = EGifOpen((void *)&buffer, gifWriteFunc)) == NULL) {
+        FREE(buffer.data);
+        return ERROR_INT("could not open gif stream to memory", procName, 1);
+    }
+
+    if (pixToGif(pix, gif)) {
+        FREE(buffer.data);
+        return ERROR_INT("gif data not made", procName, 1);
+    }
+
+    *pdata = buffer.data;
+    *psize = buffer.size;
     return 0;
 }
 
 
+/*!
+ *  gifReadFunc()
+ *
+ *      Input:  gif (gif stream opened with DGifOpen())
+ *              dest (buffer for the data that is read)
+ *              bytesToRead
+ *      Return: number of bytes read
+ *
+ *  Notes:
+ *      (1) This is the giflib InputFunc for reading from memory.
+ *          The L_GIF_BUFFER is in the UserData field.
+ */
+static l_int32
+gifReadFunc(GifFileType  *gif,
+            GifByteType  *dest,
+            l_int32       bytesToRead)
+{
+l_int32        nbytes;
+L_GIF_BUFFER  *buffer;
+
+    buffer = (L_GIF_BUFFER *)gif->UserData;
+    nbytes = L_MIN(bytesToRead, (l_int32)(buffer->size - buffer->pos));
+    if (nbytes <= 0)
+        return 0;
+    memcpy(dest, buffer->data + buffer->pos, nbytes);
+    buffer->pos += nbytes;
+    return nbytes;
+}
+
+
+/*!
+ *  gifWriteFunc()
+ *
+ *      Input:  gif (gif stream opened with EGifOpen())
+ *              src (data to be written)
+ *              bytesToWrite
+ *      Return: number of bytes written
+ *
+ *  Notes:
+ *      (1) This is the giflib OutputFunc for writing to memory.
+ *          The L_GIF_BUFFER is in the UserData field, and its data
+ *          array is doubled in size as required.
+ */
+static l_int32
+gifWriteFunc(GifFileType        *gif,
+             const GifByteType  *src,
+             l_int32             bytesToWrite)
+{
+size_t         nalloc;
+l_uint8       *newdata;
+L_GIF_BUFFER  *buffer;
+
+    PROCNAME("gifWriteFunc");
+
+    buffer = (L_GIF_BUFFER *)gif->UserData;
+    if (bytesToWrite <= 0)
+        return 0;
+    if (buffer->size + bytesToWrite > buffer->nalloc) {
+        nalloc = L_MAX(2 * buffer->nalloc, buffer->size + bytesToWrite);
+        if ((newdata = (l_uint8 *)REALLOC(buffer->data, nalloc)) == NULL)
+            return ERROR_INT("buffer not reallocated", procName, 0);
+        buffer->data = newdata;
+        buffer->nalloc = nalloc;
+    }
+    memcpy(buffer->data + buffer->size, src, bytesToWrite);
+    buffer->size += bytesToWrite;
+    return bytesToWrite;
+}
+
+
 /* -----------------------------------------------------------------*/
 #endif    /* HAVE_LIBGIF || HAVE_LIBUNGIF  */
 /* -----------------------------------------------------------------*/
@@ -34,6 +34,13 @@ PIX * pixReadStreamGif(FILE *fp)
     return (PIX * )ERROR_PTR("function not present", "pixReadStreamGif", NULL);
 }
 
+l_int32 sreadHeaderGif(const l_uint8 *data, size_t size, l_int32 *pwidth,
+                       l_int32 *pheight, l_int32 *pbps, l_int32 *pspp,
+                       l_int32 *piscmap)
+{
+    return ERROR_INT("function not present", "sreadHeaderGif", 1);
+}
+
 l_int32 pixWriteStreamGif(FILE *fp, PIX *pix)
 {
     return ERROR_INT("function not present", "pixWriteStreamGif", 1);
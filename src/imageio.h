@@ -149,5 +149,30 @@ struct L_Pdf_Data
 typedef struct L_Pdf_Data  L_PDF_DATA;
 
 
+/* -------------------- Streaming multi-page pdf writer ------------------- */
+/*
+ *  This writes a multi-page pdf to a file stream one page at a time.
+ *  Only the object locations are kept; the page data is written out
+ *  as soon as it is generated.  The locations are stored as size_t,
+ *  because they can exceed the exact range of a float in a numa, and
+ *  the range of an l_int32 for very large documents.
+ */
+struct L_Pdf_Writer
+{
+    FILE              *fp;           /* output stream                       */
+    char              *fileout;      /* name of output file                 */
+    char              *title;        /* optional title for pdf              */
+    l_int32            npages;       /* number of pages written             */
+    l_int32            nobj;         /* next object number to assign        */
+    size_t             offset;       /* number of bytes written             */
+    size_t            *objloc;       /* location of each pdf object         */
+    l_int32            nloc;         /* number of object locations          */
+    l_int32            nalloc;       /* size of allocated objloc array      */
+    struct Numa       *napage;       /* object number of each Page object   */
+    l_int32            error;        /* set to 1 if a write fails           */
+};
+typedef struct L_Pdf_Writer  L_PDF_WRITER;
+
+
 #endif  /* LEPTONICA_IMAGEIO_H */
 
@@ -37,6 +37,21 @@
  *    Setting special flag(s)
  *          void             l_jpegSetNoChromaSampling()
  *
+ *    Static decompression helpers
+ *          static PIX      *pixReadJpegDecompress()
+ *          static l_int32   jpegReadHeader()
+ *          static void      jpeg_memsrc_set()
+ *          static void      jpeg_memsrc_init()
+ *          static boolean   jpeg_memsrc_fill()
+ *          static void      jpeg_memsrc_skip()
+ *          static void      jpeg_memsrc_term()
+ *
+ *    Static compression helpers
+ *          static l_int32   pixWriteJpegCompress()
+ *          static void      jpeg_memdest_init()
+ *          static boolean   jpeg_memdest_empty()
+ *          static void      jpeg_memdest_term()
+ *
  *    Static system helpers
  *          static void      jpeg_error_do_not_exit()
  *          static l_uint8   jpeg_getc()
@@ -102,7 +117,45 @@
 
 static void jpeg_error_do_not_exit(j_common_ptr cinfo);
 static l_uint8 jpeg_getc(j_decompress_ptr cinfo);
-static jmp_buf jpeg_jmpbuf;
+
+    /* Per-call data for the jpeg library callbacks, held in the
+     * client_data field of cinfo.  Keeping the jmp_buf here rather
+     * than in a static makes the jpeg functions reentrant. */
+struct L_JpegCallbackData {
+    jmp_buf    jmpbuf;    /* for the error handler, on exit from the lib */
+    l_uint8   *comment;   /* for the jpeg comment callback               */
+};
+typedef struct L_JpegCallbackData  L_JPEG_CALLBACK_DATA;
+
+    /* Destination manager for compressing directly to memory.
+     * The buffer is grown by doubling as the compressor fills it. */
+struct L_JpegMemDest {
+    struct jpeg_destination_mgr  pub;       /* public fields             */
+    l_uint8                     *buffer;    /* start of output buffer    */
+    size_t                       bufsize;   /* allocated size of buffer  */
+    size_t                       nbytes;    /* bytes written at the end  */
+};
+typedef struct L_JpegMemDest  L_JPEG_MEMDEST;
+
+static l_int32 pixWriteJpegCompress(PIX *pix, l_int32 quality,
+                                    l_int32 progressive, FILE *fp,
+                                    L_JPEG_MEMDEST *memdest);
+static PIX *pixReadJpegDecompress(FILE *fp, const l_uint8 *cdata,
+                                  size_t size, l_int32 cmflag,
+                                  l_int32 reduction, l_int32 *pnwarn,
+                                  l_int32 hint);
+static l_int32 jpegReadHeader(FILE *fp, const l_uint8 *cdata, size_t size,
+                              l_int32 *pw, l_int32 *ph, l_int32 *pspp,
+                              l_int32 *pycck, l_int32 *pcmyk);
+static void jpeg_memsrc_set(j_decompress_ptr cinfo, const l_uint8 *cdata,
+                            size_t size);
+static void jpeg_memsrc_init(j_decompress_ptr cinfo);
+static boolean jpeg_memsrc_fill(j_decompress_ptr cinfo);
+static void jpeg_memsrc_skip(j_decompress_ptr cinfo, long nbytes);
+static void jpeg_memsrc_term(j_decompress_ptr cinfo);
+static void jpeg_memdest_init(j_compress_ptr cinfo);
+static boolean jpeg_memdest_empty(j_compress_ptr cinfo);
+static void jpeg_memdest_term(j_compress_ptr cinfo);
 
     /* Note: 'boolean' is defined in jmorecfg.h.  We use it explicitly
      * here because for windows where __MINGW32__ is defined,
@@ -207,6 +260,45 @@ pixReadStreamJpeg(FILE     *fp,
                   l_int32   reduction,
                   l_int32  *pnwarn,
                   l_int32   hint)
+{
+    PROCNAME("pixReadStreamJpeg");
+
+    if (!fp)
+        return (PIX *)ERROR_PTR("fp not defined", procName, NULL);
+    rewind(fp);
+
+    return pixReadJpegDecompress(fp, NULL, 0, cmflag, reduction,
+                                 pnwarn, hint);
+}
+
+
+/*!
+ *  pixReadJpegDecompress()
+ *
+ *      Input:  fp (<optional> input stream)
+ *              cdata (<optional> jpeg-encoded data; use if fp is null)
+ *              size (of cdata)
+ *              colormap flag (0 means return RGB image if color;
+ *                             1 means create colormap and return 8 bpp
+ *                               palette image if color)
+ *              reduction (scaling factor: 1, 2, 4 or 8)
+ *              &pnwarn (<optional return> number of warnings)
+ *              hint: (a bitwise OR of L_HINT_* values); use 0 for no hints
+ *      Return: pix, or null on error
+ *
+ *  Notes:
+ *      (1) This does the work for pixReadStreamJpeg() and
+ *          pixReadMemJpeg().  If @fp is null, the jpeg library reads
+ *          directly from @cdata.
+ */
+static PIX *
+pixReadJpegDecompress(FILE           *fp,
+                      const l_uint8  *cdata,
+                      size_t          size,
+                      l_int32         cmflag,
+                      l_int32         reduction,
+                      l_int32        *pnwarn,
+                      l_int32         hint)
 {
 l_uint8                        cyan, yellow, magenta, black, white;
 l_int32                        rval, gval, bval;
@@ -219,12 +311,12 @@ PIX                           *pix;
 PIXCMAP                       *cmap;
 struct jpeg_decompress_struct  cinfo;
 struct jpeg_error_mgr          jerr;
-l_uint8                       *comment = NULL;
+L_JPEG_CALLBACK_DATA           cb_data;
 
-    PROCNAME("pixReadStreamJpeg");
+    PROCNAME("pixReadJpegDecompress");
 
-    if (!fp)
-        return (PIX *)ERROR_PTR("fp not defined", procName, NULL);
+    if (!fp && !cdata)
+        return (PIX *)ERROR_PTR("no source", procName, NULL);
     if (pnwarn)
         *pnwarn = 0;  /* init */
     if (cmflag != 0 && cmflag != 1)
@@ -235,10 +327,9 @@ l_uint8                       *comment = NULL;
     if (BITS_IN_JSAMPLE != 8)  /* set in jmorecfg.h */
         return (PIX *)ERROR_PTR("BITS_IN_JSAMPLE != 8", procName, NULL);
 
-    rewind(fp);
-
     pix = NULL;  /* init */
-    if (setjmp(jpeg_jmpbuf)) {
+    cb_data.comment = NULL;
+    if (setjmp(cb_data.jmpbuf)) {
         pixDestroy(&pix);
         FREE(rowbuffer);
         return (PIX *)ERROR_PTR("internal jpeg error", procName, NULL);
@@ -247,12 +338,15 @@ l_uint8                       *comment = NULL;
     rowbuffer = NULL;
     cinfo.err = jpeg_std_error(&jerr);
     jerr.error_exit = jpeg_error_do_not_exit; /* catch error; do not exit! */
+    cinfo.client_data = (void *)&cb_data;
 
     jpeg_create_decompress(&cinfo);
 
-    cinfo.client_data = &comment;
     jpeg_set_marker_processor(&cinfo, JPEG_COM, jpeg_comment_callback);
-    jpeg_stdio_src(&cinfo, fp);
+    if (fp)
+        jpeg_stdio_src(&cinfo, fp);
+    else
+        jpeg_memsrc_set(&cinfo, cdata, size);
     jpeg_read_header(&cinfo, TRUE);
     cinfo.scale_denom = reduction;
     cinfo.scale_num = 1;
@@ -267,7 +361,7 @@ l_uint8                       *comment = NULL;
     ycck = (cinfo.jpeg_color_space == JCS_YCCK && spp == 4 && cmflag == 0);
     cmyk = (cinfo.jpeg_color_space == JCS_CMYK && spp == 4 && cmflag == 0);
     if (spp != 1 && spp != 3 && !ycck && !cmyk) {
-        if (comment) FREE(comment);
+        if (cb_data.comment) FREE(cb_data.comment);
         return (PIX *)ERROR_PTR("spp must be 1 or 3, or YCCK or CMYK",
                                 procName, NULL);
     }
@@ -280,15 +374,15 @@ l_uint8                       *comment = NULL;
         pix = pixCreate(w, h, 8);
     }
     if (!rowbuffer || !pix) {
-        if (comment) FREE(comment);
+        if (cb_data.comment) FREE(cb_data.comment);
 	if (rowbuffer) FREE(rowbuffer);
 	pixDestroy(&pix);
         return (PIX *)ERROR_PTR("rowbuffer or pix not made", procName, NULL);
     }
 
-    if (comment) {
-        pixSetText(pix, (char *)comment);
-	FREE(comment);
+    if (cb_data.comment) {
+        pixSetText(pix, (char *)cb_data.comment);
+	FREE(cb_data.comment);
     }
 
     if (spp == 1)  /* Grayscale or colormapped */
@@ -451,9 +545,7 @@ freadHeaderJpeg(FILE     *fp,
                 l_int32  *pycck,
                 l_int32  *pcmyk)
 {
-l_int32                        spp;
-struct jpeg_decompress_struct  cinfo;
-struct jpeg_error_mgr          jerr;
+l_int32  ret;
 
     PROCNAME("freadHeaderJpeg");
 
@@ -462,14 +554,58 @@ struct jpeg_error_mgr          jerr;
     if (!pw && !ph && !pspp && !pycck && !pcmyk)
         return ERROR_INT("no results requested", procName, 1);
 
-    if (setjmp(jpeg_jmpbuf))
+    rewind(fp);
+    ret = jpegReadHeader(fp, NULL, 0, pw, ph, pspp, pycck, pcmyk);
+    rewind(fp);
+    return ret;
+}
+
+
+/*!
+ *  jpegReadHeader()
+ *
+ *      Input:  fp (<optional> input stream)
+ *              cdata (<optional> jpeg-encoded data; use if fp is null)
+ *              size (of cdata)
+ *              &w (<optional return>)
+ *              &h (<optional return>)
+ *              &spp (<optional return>, samples/pixel)
+ *              &ycck (<optional return>, 1 if ycck color space; 0 otherwise)
+ *              &cmyk (<optional return>, 1 if cmyk color space; 0 otherwise)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This does the work for freadHeaderJpeg() and
+ *          readHeaderMemJpeg().
+ */
+static l_int32
+jpegReadHeader(FILE           *fp,
+               const l_uint8  *cdata,
+               size_t          size,
+               l_int32        *pw,
+               l_int32        *ph,
+               l_int32        *pspp,
+               l_int32        *pycck,
+               l_int32        *pcmyk)
+{
+l_int32                        spp;
+struct jpeg_decompress_struct  cinfo;
+struct jpeg_error_mgr          jerr;
+L_JPEG_CALLBACK_DATA           cb_data;
+
+    PROCNAME("jpegReadHeader");
+
+    if (setjmp(cb_data.jmpbuf))
         return ERROR_INT("internal jpeg error", procName, 1);
 
-    rewind(fp);
     cinfo.err = jpeg_std_error(&jerr);
     jerr.error_exit = jpeg_error_do_not_exit; /* catch error; do not exit! */
+    cinfo.client_data = (void *)&cb_data;
     jpeg_create_decompress(&cinfo);
-    jpeg_stdio_src(&cinfo, fp);
+    if (fp)
+        jpeg_stdio_src(&cinfo, fp);
+    else
+        jpeg_memsrc_set(&cinfo, cdata, size);
     jpeg_read_header(&cinfo, TRUE);
     jpeg_calc_output_dimensions(&cinfo);
 
@@ -483,7 +619,6 @@ struct jpeg_error_mgr          jerr;
         (cinfo.jpeg_color_space == JCS_CMYK && spp == 4);
 
     jpeg_destroy_decompress(&cinfo);
-    rewind(fp);
     return 0;
 }
 
@@ -507,6 +642,7 @@ fgetJpegResolution(FILE     *fp,
 {
 struct jpeg_decompress_struct  cinfo;
 struct jpeg_error_mgr          jerr;
+L_JPEG_CALLBACK_DATA           cb_data;
 
     PROCNAME("fgetJpegResolution");
 
@@ -516,12 +652,13 @@ struct jpeg_error_mgr          jerr;
     if (!fp)
         return ERROR_INT("stream not opened", procName, 1);
 
-    if (setjmp(jpeg_jmpbuf))
+    if (setjmp(cb_data.jmpbuf))
         return ERROR_INT("internal jpeg error", procName, 1);
 
     rewind(fp);
     cinfo.err = jpeg_std_error(&jerr);
     jerr.error_exit = jpeg_error_do_not_exit;
+    cinfo.client_data = (void *)&cb_data;
     jpeg_create_decompress(&cinfo);
     jpeg_stdio_src(&cinfo, fp);
     jpeg_read_header(&cinfo, TRUE);
@@ -623,6 +760,44 @@ pixWriteStreamJpeg(FILE    *fp,
                    PIX     *pix,
                    l_int32  quality,
                    l_int32  progressive)
+{
+    PROCNAME("pixWriteStreamJpeg");
+
+    if (!fp)
+        return ERROR_INT("stream not open", procName, 1);
+    if (!pix)
+        return ERROR_INT("pix not defined", procName, 1);
+    rewind(fp);
+
+    return pixWriteJpegCompress(pix, quality, progressive, fp, NULL);
+}
+
+
+/*---------------------------------------------------------------------*
+ *                      Static jpeg compression                        *
+ *---------------------------------------------------------------------*/
+/*!
+ *  pixWriteJpegCompress()
+ *
+ *      Input:  pix  (8 or 32 bpp)
+ *              quality  (1 - 100; 75 is default value; 0 is also default)
+ *              progressive (0 for baseline sequential; 1 for progressive)
+ *              fp (<optional> output stream)
+ *              memdest (<optional> memory destination; use if fp is null)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This does the work for pixWriteStreamJpeg() and
+ *          pixWriteMemJpeg().  Exactly one of @fp and @memdest is used.
+ *      (2) On error, the caller must free any data accumulated
+ *          in @memdest.
+ */
+static l_int32
+pixWriteJpegCompress(PIX                 *pix,
+                     l_int32              quality,
+                     l_int32              progressive,
+                     FILE                *fp,
+                     L_JPEG_MEMDEST      *memdest)
 {
 l_uint8                      byteval;
 l_int32                      xres, yres;
@@ -634,17 +809,17 @@ JSAMPROW                     rowbuffer;
 PIXCMAP                     *cmap;
 struct jpeg_compress_struct  cinfo;
 struct jpeg_error_mgr        jerr;
+L_JPEG_CALLBACK_DATA         cb_data;
 const char                  *text;
 
-    PROCNAME("pixWriteStreamJpeg");
+    PROCNAME("pixWriteJpegCompress");
 
-    if (!fp)
-        return ERROR_INT("stream not open", procName, 1);
     if (!pix)
         return ERROR_INT("pix not defined", procName, 1);
-    rewind(fp);
+    if (!fp && !memdest)
+        return ERROR_INT("no destination", procName, 1);
 
-    if (setjmp(jpeg_jmpbuf)) {
+    if (setjmp(cb_data.jmpbuf)) {
         FREE(rowbuffer);
         if (colorflg == 1) {
             FREE(rmap);
@@ -677,8 +852,12 @@ const char                  *text;
     cinfo.err = jpeg_std_error(&jerr);
     jerr.error_exit = jpeg_error_do_not_exit; /* catch error; do not exit! */
 
+    cinfo.client_data = (void *)&cb_data;
     jpeg_create_compress(&cinfo);
-    jpeg_stdio_dest(&cinfo, fp);
+    if (fp)
+        jpeg_stdio_dest(&cinfo, fp);
+    else
+        cinfo.dest = &memdest->pub;
 
     cinfo.image_width  = w;
     cinfo.image_height = h;
@@ -792,11 +971,6 @@ const char                  *text;
 /*---------------------------------------------------------------------*
  *                         Read/write to memory                        *
  *---------------------------------------------------------------------*/
-#if HAVE_FMEMOPEN
-
-extern FILE *open_memstream(char **data, size_t *size);
-extern FILE *fmemopen(void *data, size_t size, const char *mode);
-
 /*!
  *  pixReadMemJpeg()
  *
@@ -811,8 +985,9 @@ extern FILE *fmemopen(void *data, size_t size, const char *mode);
  *      Return: pix, or null on error
  *
  *  Notes:
- *      (1) The @size byte of @data must be a null character.
- *      (2) See pixReadJpeg() for usage.
+ *      (1) See pixReadJpeg() for usage.
+ *      (2) The jpeg library reads directly from @cdata, using our own
+ *          source manager.  No file stream (or fmemopen()) is required.
  */
 PIX *
 pixReadMemJpeg(const l_uint8  *cdata,
@@ -822,20 +997,17 @@ pixReadMemJpeg(const l_uint8  *cdata,
                l_int32        *pnwarn,
                l_int32         hint)
 {
-l_uint8  *data;
-FILE     *fp;
-PIX      *pix;
+PIX  *pix;
 
     PROCNAME("pixReadMemJpeg");
 
     if (!cdata)
         return (PIX *)ERROR_PTR("cdata not defined", procName, NULL);
 
-    data = (l_uint8 *)cdata;  /* we're really not going to change this */
-    if ((fp = fmemopen(data, size, "r")) == NULL)
-        return (PIX *)ERROR_PTR("stream not opened", procName, NULL);
-    pix = pixReadStreamJpeg(fp, cmflag, reduction, pnwarn, hint);
-    fclose(fp);
+    pix = pixReadJpegDecompress(NULL, cdata, size, cmflag, reduction,
+                                pnwarn, hint);
+    if (!pix)
+        return (PIX *)ERROR_PTR("pix not read", procName, NULL);
     return pix;
 }
 
@@ -861,10 +1033,6 @@ readHeaderMemJpeg(const l_uint8  *cdata,
                   l_int32        *pycck,
                   l_int32        *pcmyk)
 {
-l_uint8  *data;
-l_int32   ret;
-FILE     *fp;
-
     PROCNAME("readHeaderMemJpeg");
 
     if (!cdata)
@@ -872,12 +1040,7 @@ FILE     *fp;
     if (!pw && !ph && !pspp && !pycck && !pcmyk)
         return ERROR_INT("no results requested", procName, 1);
 
-    data = (l_uint8 *)cdata;  /* we're really not going to change this */
-    if ((fp = fmemopen(data, size, "r")) == NULL)
-        return ERROR_INT("stream not opened", procName, 1);
-    ret = freadHeaderJpeg(fp, pw, ph, pspp, pycck, pcmyk);
-    fclose(fp);
-    return ret;
+    return jpegReadHeader(NULL, cdata, size, pw, ph, pspp, pycck, pcmyk);
 }
 
 
@@ -894,6 +1057,9 @@ FILE     *fp;
  *  Notes:
  *      (1) See pixWriteStreamJpeg() for usage.  This version writes to
  *          memory instead of to a file stream.
+ *      (2) The compressed data is written directly to a memory buffer
+ *          by the jpeg library, using our own destination manager.
+ *          No file stream (or open_memstream()) is required.
  */
 l_int32
 pixWriteMemJpeg(l_uint8  **pdata,
@@ -902,178 +1068,178 @@ pixWriteMemJpeg(l_uint8  **pdata,
                 l_int32    quality,
                 l_int32    progressive)
 {
-l_int32  ret;
-FILE    *fp;
+l_int32         ret;
+L_JPEG_MEMDEST  memdest;
 
     PROCNAME("pixWriteMemJpeg");
 
     if (!pdata)
         return ERROR_INT("&data not defined", procName, 1 );
+    *pdata = NULL;
     if (!psize)
         return ERROR_INT("&size not defined", procName, 1 );
+    *psize = 0;
     if (!pix)
         return ERROR_INT("&pix not defined", procName, 1 );
 
-    if ((fp = open_memstream((char **)pdata, psize)) == NULL)
-        return ERROR_INT("stream not opened", procName, 1);
-    ret = pixWriteStreamJpeg(fp, pix, quality, progressive);
-    fclose(fp);
-    return ret;
-}
-
+    memset(&memdest, 0, sizeof(L_JPEG_MEMDEST));
+    memdest.pub.init_destination = jpeg_memdest_init;
+    memdest.pub.empty_output_buffer = jpeg_memdest_empty;
+    memdest.pub.term_destination = jpeg_memdest_term;
+    ret = pixWriteJpegCompress(pix, quality, progressive, NULL, &memdest);
+    if (ret) {
+        if (memdest.buffer) FREE(memdest.buffer);
+        return ERROR_INT("jpeg data not made", procName, 1);
+    }
 
-#else  /* fmemopen() and open_memstream() are not available */
+    *pdata = memdest.buffer;
+    *psize = memdest.nbytes;
+    return 0;
+}
 
 
+/*---------------------------------------------------------------------*
+ *                     Setting special write flag                      *
+ *---------------------------------------------------------------------*/
 /*!
- *  pixReadMemJpeg()
- *
- *      Input:  cdata (const; jpeg-encoded)
- *              size (of data)
- *              colormap flag (0 means return RGB image if color;
- *                             1 means create colormap and return 8 bpp
- *                               palette image if color)
- *              reduction (scaling factor: 1, 2, 4 or 8)
- *              &pnwarn (<optional return> number of warnings)
- *              hint (bitwise OR of L_HINT_* values; use 0 for no hint)
- *      Return: pix, or null on error
+ *  l_jpegSetNoChromaSampling()
  *
- *  Notes:
- *      (1) We are cheating here -- writing the data out
- *          to file in jpeg format and then reading it back.
+ *      Input:  flag (0 for standard 2x2 chroma subsampling)
+ *                    1 for no chroma subsampling (high quality))
+ *      Return: void
  */
-PIX *
-pixReadMemJpeg(const l_uint8  *cdata,
-               size_t          size,
-               l_int32         cmflag,
-               l_int32         reduction,
-               l_int32        *pnwarn,
-               l_int32         hint)
+void
+l_jpegSetNoChromaSampling(l_int32  flag)
 {
-char     *tname;
-l_uint8  *data;
-FILE     *fp;
-PIX      *pix;
-
-    PROCNAME("pixReadMemJpeg");
-
-    if (!cdata)
-        return (PIX *)ERROR_PTR("cdata not defined", procName, NULL);
-
-    data = (l_uint8 *)cdata;  /* we're really not going to change this */
-    tname = genTempFilename("/tmp/", "mem.jpg", 1, 1);
-    l_binaryWrite(tname, "w", data, size);
-    if ((fp = fopenReadStream(tname)) == NULL)
-        return (PIX *)ERROR_PTR("stream not opened", procName, NULL);
-    pix = pixReadStreamJpeg(fp, cmflag, reduction, pnwarn, hint);
-    fclose(fp);
-    remove(tname);
-    FREE(tname);
-    if (!pix)
-        return (PIX *)ERROR_PTR("pix not read", procName, NULL);
-    return pix;
+    var_JPEG_NO_CHROMA_SAMPLING = flag;
 }
 
 
-/*!
- *  readHeaderMemJpeg()
- *
- *      Input:  cdata (const; jpeg-encoded)
- *              size (of data)
- *              &w (<optional return>)
- *              &h (<optional return>)
- *              &spp (<optional return>, samples/pixel)
- *              &ycck (<optional return>, 1 if ycck color space; 0 otherwise)
- *              &cmyk (<optional return>, 1 if cmyk color space; 0 otherwise)
- *      Return: 0 if OK, 1 on error
- *
- *  Notes:
- *      (1) Parse the jpeg string without without jpeg library calls.
- */
-l_int32
-readHeaderMemJpeg(const l_uint8  *cdata,
-                  size_t          size,
-                  l_int32        *pw,
-                  l_int32        *ph,
-                  l_int32        *pspp,
-                  l_int32        *pycck,
-                  l_int32        *pcmyk)
+/*---------------------------------------------------------------------*
+ *                    Static memory source manager                     *
+ *---------------------------------------------------------------------*/
+    /* Make the jpeg library read directly from the compressed data.
+     * The source manager is allocated in the permanent pool, so it
+     * is freed when the decompress struct is destroyed. */
+static void
+jpeg_memsrc_set(j_decompress_ptr  cinfo,
+                const l_uint8    *cdata,
+                size_t            size)
 {
-    PROCNAME("readHeaderMemJpeg");
-
-    if (!cdata)
-        return ERROR_INT("cdata not defined", procName, 1);
-
-    if (pycck) *pycck = 0;
-    if (pcmyk) *pcmyk = 0;
-    return extractJpegDataFromArray(cdata, size, pw, ph, NULL, pspp);
+struct jpeg_source_mgr  *src;
+
+    src = (struct jpeg_source_mgr *)(*cinfo->mem->alloc_small)
+              ((j_common_ptr)cinfo, JPOOL_PERMANENT,
+               sizeof(struct jpeg_source_mgr));
+    src->init_source = jpeg_memsrc_init;
+    src->fill_input_buffer = jpeg_memsrc_fill;
+    src->skip_input_data = jpeg_memsrc_skip;
+    src->resync_to_restart = jpeg_resync_to_restart;  /* default */
+    src->term_source = jpeg_memsrc_term;
+    src->next_input_byte = (const JOCTET *)cdata;
+    src->bytes_in_buffer = size;
+    cinfo->src = src;
+    return;
 }
 
-
-/*!
- *  pixWriteMemJpeg()
- *
- *      Input:  &data (<return> data of jpeg compressed image)
- *              &size (<return> size of returned data)
- *              pix
- *              quality  (1 - 100; 75 is default value; 0 is also default)
- *              progressive (0 for baseline sequential; 1 for progressive)
- *      Return: 0 if OK, 1 on error
- *
- *  Notes:
- *      (1) We are cheating here -- writing the data out
- *          to file in jpeg format and then reading it back.
- */
-l_int32
-pixWriteMemJpeg(l_uint8  **pdata,
-                size_t    *psize,
-                PIX       *pix,
-                l_int32    quality,
-                l_int32    progressive)
+    /* All the data is in the buffer from the start: nothing to do */
+static void
+jpeg_memsrc_init(j_decompress_ptr cinfo)
 {
-char     *tname;
-l_uint8  *data;
-size_t    nbytes;
+    return;
+}
 
-    PROCNAME("pixWriteMemJpeg");
+    /* This is only called if the library runs off the end of the data.
+     * As in the stdio source manager, insert a fake EOI marker, so that
+     * the library will return what it has for a truncated file. */
+static boolean
+jpeg_memsrc_fill(j_decompress_ptr cinfo)
+{
+static const JOCTET  eoi[2] = {0xff, JPEG_EOI};
 
-    if (!pdata)
-        return ERROR_INT("&data not defined", procName, 1 );
-    if (!psize)
-        return ERROR_INT("&size not defined", procName, 1 );
-    if (!pix)
-        return ERROR_INT("&pix not defined", procName, 1 );
+    PROCNAME("jpeg_memsrc_fill");
 
-    tname = genTempFilename("/tmp/", "mem.jpg", 1, 1);
-    pixWriteJpeg(tname, pix, quality, progressive);
-    data = l_binaryRead(tname, &nbytes);
-    remove(tname);
-    FREE(tname);
-    if (!data)
-        return ERROR_INT("data not returned", procName, 1 );
-    *pdata = data;
-    *psize = nbytes;
-    return 0;
+    L_WARNING("premature end of jpeg data", procName);
+    cinfo->src->next_input_byte = eoi;
+    cinfo->src->bytes_in_buffer = 2;
+    return TRUE;
 }
 
-#endif  /* HAVE_FMEMOPEN */
+static void
+jpeg_memsrc_skip(j_decompress_ptr  cinfo,
+                 long              nbytes)
+{
+struct jpeg_source_mgr  *src;
+
+    if (nbytes <= 0)
+        return;
+    src = cinfo->src;
+    if ((size_t)nbytes > src->bytes_in_buffer) {
+        jpeg_memsrc_fill(cinfo);
+        return;
+    }
+    src->next_input_byte += nbytes;
+    src->bytes_in_buffer -= nbytes;
+    return;
+}
 
+static void
+jpeg_memsrc_term(j_decompress_ptr cinfo)
+{
+    return;
+}
 
 
 /*---------------------------------------------------------------------*
- *                     Setting special write flag                      *
+ *                  Static memory destination manager                  *
  *---------------------------------------------------------------------*/
-/*!
- *  l_jpegSetNoChromaSampling()
- *
- *      Input:  flag (0 for standard 2x2 chroma subsampling)
- *                    1 for no chroma subsampling (high quality))
- *      Return: void
- */
-void
-l_jpegSetNoChromaSampling(l_int32  flag)
+    /* Allocate the initial output buffer.  This is called by
+     * jpeg_start_compress(). */
+static void
+jpeg_memdest_init(j_compress_ptr cinfo)
 {
-    var_JPEG_NO_CHROMA_SAMPLING = flag;
+L_JPEG_MEMDEST  *dest;
+
+    dest = (L_JPEG_MEMDEST *)cinfo->dest;
+    dest->bufsize = 4096 + (size_t)cinfo->image_width *
+                    cinfo->image_height * cinfo->input_components / 8;
+    if ((dest->buffer = (l_uint8 *)MALLOC(dest->bufsize)) == NULL)
+        (*cinfo->err->error_exit)((j_common_ptr)cinfo);
+    dest->pub.next_output_byte = dest->buffer;
+    dest->pub.free_in_buffer = dest->bufsize;
+    return;
+}
+
+    /* The buffer is full: double its size.  Unlike a file destination,
+     * nothing is flushed, so the entire buffer is always valid. */
+static boolean
+jpeg_memdest_empty(j_compress_ptr cinfo)
+{
+size_t           oldsize;
+l_uint8         *newbuf;
+L_JPEG_MEMDEST  *dest;
+
+    dest = (L_JPEG_MEMDEST *)cinfo->dest;
+    oldsize = dest->bufsize;
+    if ((newbuf = (l_uint8 *)REALLOC(dest->buffer, 2 * oldsize)) == NULL)
+        (*cinfo->err->error_exit)((j_common_ptr)cinfo);
+    dest->buffer = newbuf;
+    dest->bufsize = 2 * oldsize;
+    dest->pub.next_output_byte = dest->buffer + oldsize;
+    dest->pub.free_in_buffer = oldsize;
+    return TRUE;
+}
+
+    /* Record the number of bytes written.  This is called by
+     * jpeg_finish_compress(). */
+static void
+jpeg_memdest_term(j_compress_ptr cinfo)
+{
+L_JPEG_MEMDEST  *dest;
+
+    dest = (L_JPEG_MEMDEST *)cinfo->dest;
+    dest->nbytes = dest->bufsize - dest->pub.free_in_buffer;
+    return;
 }
 
 
@@ -1087,9 +1253,12 @@ l_jpegSetNoChromaSampling(l_int32  flag)
 static void
 jpeg_error_do_not_exit(j_common_ptr cinfo)
 {
+L_JPEG_CALLBACK_DATA  *pcb_data;
+
+    pcb_data = (L_JPEG_CALLBACK_DATA *)cinfo->client_data;
     (*cinfo->err->output_message) (cinfo);
     jpeg_destroy(cinfo);
-    longjmp(jpeg_jmpbuf, 0);
+    longjmp(pcb_data->jmpbuf, 1);
     return;
 }
 
@@ -1120,7 +1289,7 @@ l_int32    length, i;
 l_uint32   c;
 l_uint8  **comment;
 
-    comment = (l_uint8 **)cinfo->client_data;
+    comment = &((L_JPEG_CALLBACK_DATA *)cinfo->client_data)->comment;
     length = jpeg_getc(cinfo) << 8;
     length += jpeg_getc(cinfo);
     length -= 2;
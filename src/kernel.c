@@ -37,6 +37,9 @@
  *            L_KERNEL   *kernelNormalize()
  *            L_KERNEL   *kernelInvert()
  *
+ *         Separability
+ *            l_int32     kernelGetSeparableParts()
+ *
  *         Helper function
  *            l_float32 **create2dFloatArray()
  *
@@ -445,6 +448,94 @@ L_KERNEL  *keld;
 }
 
 
+/*----------------------------------------------------------------------*
+ *                              Separability                            *
+ *----------------------------------------------------------------------*/
+/*!
+ *  kernelGetSeparableParts()
+ *
+ *      Input:  kel
+ *              &kelx (<return> x part of kernel; null if not separable)
+ *              &kely (<return> y part of kernel; null if not separable)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) A kernel is separable if it is the outer product of a
+ *          column and a row; i.e., it has rank 1.  In that case,
+ *          this returns the two 1D kernels, such that
+ *             kel->data[i][j] == kely->data[i][0] * kelx->data[0][j]
+ *          to within float roundoff.  Otherwise, both returned
+ *          kernels are null.
+ *      (2) kelx has size (1, sx) and origin (0, cx); kely has
+ *          size (sy, 1) and origin (cy, 0).  Convolution with kelx
+ *          followed by kely is then equivalent to convolution with kel.
+ *      (3) The row through the element of largest magnitude is used
+ *          for kelx, and kely is the corresponding column, scaled
+ *          so that its element in that row is 1.0.
+ *      (4) Kernels with a single row or column are trivially separable.
+ */
+l_int32
+kernelGetSeparableParts(L_KERNEL   *kel,
+                        L_KERNEL  **pkelx,
+                        L_KERNEL  **pkely)
+{
+l_int32    i, j, sx, sy, cx, cy, imax, jmax;
+l_float32  val, maxval, pivot, tol;
+L_KERNEL  *kelx, *kely;
+
+    PROCNAME("kernelGetSeparableParts");
+
+    if (!pkelx || !pkely)
+        return ERROR_INT("&kelx and &kely not both defined", procName, 1);
+    *pkelx = *pkely = NULL;
+    if (!kel)
+        return ERROR_INT("kel not defined", procName, 1);
+
+    kernelGetParameters(kel, &sy, &sx, &cy, &cx);
+    maxval = 0.0;
+    imax = jmax = 0;
+    for (i = 0; i < sy; i++) {
+        for (j = 0; j < sx; j++) {
+            val = L_ABS(kel->data[i][j]);
+            if (val > maxval) {
+                maxval = val;
+                imax = i;
+                jmax = j;
+            }
+        }
+    }
+    if (maxval == 0.0)  /* null kernel; not useful */
+        return 0;
+
+    kelx = kernelCreate(1, sx);
+    kely = kernelCreate(sy, 1);
+    kernelSetOrigin(kelx, 0, cx);
+    kernelSetOrigin(kely, cy, 0);
+    pivot = kel->data[imax][jmax];
+    for (j = 0; j < sx; j++)
+        kelx->data[0][j] = kel->data[imax][j];
+    for (i = 0; i < sy; i++)
+        kely->data[i][0] = kel->data[i][jmax] / pivot;
+
+        /* Verify that the outer product reproduces the kernel */
+    tol = 0.00001 * maxval;
+    for (i = 0; i < sy; i++) {
+        for (j = 0; j < sx; j++) {
+            val = kely->data[i][0] * kelx->data[0][j] - kel->data[i][j];
+            if (L_ABS(val) > tol) {
+                kernelDestroy(&kelx);
+                kernelDestroy(&kely);
+                return 0;
+            }
+        }
+    }
+
+    *pkelx = kelx;
+    *pkely = kely;
+    return 0;
+}
+
+
 /*----------------------------------------------------------------------*
  *                            Helper function                           *
  *----------------------------------------------------------------------*/
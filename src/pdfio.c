@@ -47,9 +47,19 @@
  *     1. Convert specified image files to Pdf (one image file per page)
  *          l_int32             convertFilesToPdf()
  *          l_int32             saConvertFilesToPdf()
+ *          l_int32             saConvertFilesToPdfStreaming()
  *          l_int32             saConvertFilesToPdfData()
+ *          l_int32             convertFileToPdfPageData()
  *          l_int32             selectDefaultPdfEncoding()
  *
+ *     Streaming multi-page pdf writer
+ *          L_PDF_WRITER       *pdfWriterCreate()
+ *          l_int32             pdfWriterAddPix()
+ *          l_int32             pdfWriterAddPdfData()
+ *          l_int32             pdfWriterClose()
+ *          static l_int32      pdfWriterWrite()
+ *          static l_int32      pdfWriterAddLoc()
+ *
  *     2. Single page, multi-image converters
  *          l_int32             convertToPdf()
  *          l_int32             convertImageDataToPdf()
@@ -78,6 +88,7 @@
  *          static l_int32      generateColormapStringsPdf()
  *          static void         generateTrailerPdf()
  *          static l_int32      makeTrailerStringPdf()
+ *          static char        *makeTrailerStringFromArrayPdf()
  *          static l_int32      generateOutputDataPdf()
  *
  *     5. Multi-page concatenation
@@ -122,6 +133,17 @@
  *             convertToPdfDataSegmented()
  *                     --> pixConvertToPdfDataSegmented()
  *
+ *     The streaming writer generates the same objects as the
+ *     multi-page concatenation, but each page is written to the output
+ *     stream as soon as it is made, so the memory required does not
+ *     grow with the number of pages:
+ *             lpw = pdfWriterCreate(fileout, title);
+ *             for (each page image)
+ *                 pdfWriterAddPix(lpw, pix, type, quality, res);
+ *             pdfWriterClose(&lpw);
+ *     Because the list of pages is only known at the end, the Pages
+ *     object (3) is written after the last page, not at the beginning.
+ *
  *     For multi-page concatenation, there are three different types of input
  *        (1) directory and optional filename filter
  *        (2) sarray of filenames
@@ -154,9 +176,14 @@ static l_int32   generatePreXStringsPdf(L_PDF_DATA *lpd);
 static l_int32   generateColormapStringsPdf(L_PDF_DATA *lpd);
 static void      generateTrailerPdf(L_PDF_DATA *lpd);
 static char     *makeTrailerStringPdf(NUMA *naloc);
+static char     *makeTrailerStringFromArrayPdf(size_t *locs, l_int32 n);
 static l_int32   generateOutputDataPdf(l_uint8 **pdata, size_t *pnbytes,
                                        L_PDF_DATA *lpd);
 
+static l_int32   pdfWriterWrite(L_PDF_WRITER *lpw, const void *data,
+                                size_t nbytes);
+static l_int32   pdfWriterAddLoc(L_PDF_WRITER *lpw, size_t loc);
+
 static l_int32   parseTrailerPdf(L_BYTEA *bas, NUMA **pna);
 static char     *generatePagesObjStringPdf(NUMA *napage);
 static L_BYTEA  *substituteObjectNumbers(L_BYTEA *bas, NUMA *na_objs);
@@ -249,6 +276,10 @@ SARRAY  *sa;
  *  Notes:
  *      (1) The images are encoded with G4 if 1 bpp; JPEG if 8 bpp without
  *          colormap and many colors, or 32 bpp; FLATE for anything else.
+ *      (2) The output is identical to the data from
+ *          saConvertFilesToPdfData().  The entire document is assembled
+ *          in memory; for a large number of pages, use
+ *          saConvertFilesToPdfStreaming().
  */
 l_int32
 saConvertFilesToPdf(SARRAY      *sa,
@@ -282,6 +313,76 @@ size_t    nbytes;
 }
 
 
+/*!
+ *  saConvertFilesToPdfStreaming()
+ *
+ *      Input:  sarray (of pathnames for images)
+ *              res (input resolution of all images)
+ *              scalefactor (scaling factor applied to each image)
+ *              quality (used for JPEG only; 0 for default (75))
+ *              title (<optional> pdf title; if null, taken from the first
+ *                     image filename)
+ *              fileout (pdf file of all images)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This is like saConvertFilesToPdf(), but each page is written
+ *          to @fileout with the streaming pdf writer as soon as it is
+ *          encoded, so the memory required does not grow with the
+ *          number of pages.
+ *      (2) The pdf has the same objects as that from saConvertFilesToPdf(),
+ *          but the Pages object is written at the end, so the files
+ *          are not byte-identical.
+ *      (3) Files that can't be converted are skipped with a warning.
+ *          If no pages are written, no output file is left.
+ */
+l_int32
+saConvertFilesToPdfStreaming(SARRAY      *sa,
+                             l_int32      res,
+                             l_float32    scalefactor,
+                             l_int32      quality,
+                             const char  *title,
+                             const char  *fileout)
+{
+char          *fname;
+l_uint8       *imdata;
+l_int32        i, n, nfail;
+size_t         imbytes;
+L_PDF_WRITER  *lpw;
+
+    PROCNAME("saConvertFilesToPdfStreaming");
+
+    if (!sa)
+        return ERROR_INT("sa not defined", procName, 1);
+    if (!fileout)
+        return ERROR_INT("fileout not defined", procName, 1);
+
+    if ((lpw = pdfWriterCreate(fileout, title)) == NULL)
+        return ERROR_INT("pdf writer not made", procName, 1);
+
+        /* Encode and write out each page in turn */
+    n = sarrayGetCount(sa);
+    nfail = 0;
+    for (i = 0; i < n; i++) {
+        fname = sarrayGetString(sa, i, L_NOCOPY);
+        if (convertFileToPdfPageData(fname, res, scalefactor, quality,
+                                     title, &imdata, &imbytes)) {
+            nfail++;
+            continue;
+        }
+        if (pdfWriterAddPdfData(lpw, imdata, imbytes)) {
+            L_WARNING_STRING("page not added for %s", procName, fname);
+            nfail++;
+        }
+        FREE(imdata);
+    }
+    if (nfail > 0)
+        L_WARNING_INT2("%d of %d pages not written", procName, nfail, n);
+
+    return pdfWriterClose(&lpw);
+}
+
+
 /*!
  *  saConvertFilesToPdfData()
  *
@@ -298,6 +399,10 @@ size_t    nbytes;
  *  Notes:
  *      (1) The images are encoded with G4 if 1 bpp; JPEG if 8 bpp without
  *          colormap and many colors, or 32 bpp; FLATE for anything else.
+ *      (2) Each page is encoded independently by
+ *          convertFileToPdfPageData(), and the pages are then
+ *          concatenated in order.  See that function for encoding the
+ *          pages concurrently.
  */
 l_int32
 saConvertFilesToPdfData(SARRAY      *sa,
@@ -310,48 +415,26 @@ saConvertFilesToPdfData(SARRAY      *sa,
 {
 char     *fname;
 l_uint8  *imdata;
-l_int32   i, n, ret, type, npages, scaledres;
+l_int32   i, n, ret, npages;
 size_t    imbytes;
 L_BYTEA  *ba;
-PIX      *pixs, *pix;
 L_PTRA   *pa_data;
 
     PROCNAME("saConvertFilesToPdfData");
 
     if (!sa)
         return ERROR_INT("sa not defined", procName, 1);
-    if (scalefactor <= 0.0) scalefactor = 1.0;
 
         /* Generate all the encoded pdf strings */
     n = sarrayGetCount(sa);
     pa_data = ptraCreate(n);
     for (i = 0; i < n; i++) {
         fname = sarrayGetString(sa, i, L_NOCOPY);
-        if ((pixs = pixRead(fname)) == NULL) {
-            L_ERROR_STRING("image not readable from file %s", procName, fname);
+        if (convertFileToPdfPageData(fname, res, scalefactor, quality,
+                                     title, &imdata, &imbytes))
             continue;
-        }
-        if (scalefactor != 1.0)
-            pix = pixScale(pixs, scalefactor, scalefactor);
-        else
-            pix = pixClone(pixs);
-        scaledres = (l_int32)(res * scalefactor);
-        if (selectDefaultPdfEncoding(pix, &type)) {
-            L_ERROR_STRING("encoding type selection failed for file %s",
-                           procName, fname);
-            pixDestroy(&pix);
-            continue;
-        }
-        ret = pixConvertToPdfData(pix, type, quality, &imdata, &imbytes,
-                                  0, 0, scaledres, NULL, 0, title);
-        pixDestroy(&pix);
-        pixDestroy(&pixs);
-        if (ret) {
-            L_ERROR_STRING("pdf encoding failed for %s", procName, fname);
-            continue;
-        }
         ba = l_byteaInitFromMem(imdata, imbytes);
-        if (imdata) FREE(imdata);
+        FREE(imdata);
         ptraAdd(pa_data, ba);
     }
     ptraGetActualCount(pa_data, &npages);
@@ -374,6 +457,84 @@ L_PTRA   *pa_data;
 }
 
 
+/*!
+ *  convertFileToPdfPageData()
+ *
+ *      Input:  fname (input image file -- any format)
+ *              res (input resolution of the image)
+ *              scalefactor (scaling factor applied to the image)
+ *              quality (used for JPEG only; 0 for default (75))
+ *              title (<optional> pdf title; can be null)
+ *              &data (<return> single page pdf data)
+ *              &nbytes (<return> size of pdf data)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This encodes one image file as a single page pdf, in the
+ *          same way as each page of saConvertFilesToPdfData(): the image
+ *          is scaled and the encoding is chosen by
+ *          selectDefaultPdfEncoding().
+ *      (2) The result depends only on the input, so the pages of a
+ *          document can be encoded in any order, or concurrently by
+ *          the caller, and then combined in page order with
+ *          ptraConcatenatePdfToData() or pdfWriterAddPdfData().
+ *          The output is identical to that of saConvertFilesToPdfData()
+ *          or saConvertFilesToPdfStreaming(), respectively.  The
+ *          encoders keep no global state, but the rendering flags set
+ *          by l_pdfSetG4ImageMask() and l_pdfSetDateAndVersion() must
+ *          not be changed while pages are being encoded.
+ */
+l_int32
+convertFileToPdfPageData(const char  *fname,
+                         l_int32      res,
+                         l_float32    scalefactor,
+                         l_int32      quality,
+                         const char  *title,
+                         l_uint8    **pdata,
+                         size_t      *pnbytes)
+{
+l_int32  ret, type, scaledres;
+PIX     *pixs, *pix;
+
+    PROCNAME("convertFileToPdfPageData");
+
+    if (!pdata)
+        return ERROR_INT("&data not defined", procName, 1);
+    *pdata = NULL;
+    if (!pnbytes)
+        return ERROR_INT("&nbytes not defined", procName, 1);
+    *pnbytes = 0;
+    if (!fname)
+        return ERROR_INT("fname not defined", procName, 1);
+    if (scalefactor <= 0.0) scalefactor = 1.0;
+
+    if ((pixs = pixRead(fname)) == NULL) {
+        L_ERROR_STRING("image not readable from file %s", procName, fname);
+        return 1;
+    }
+    if (scalefactor != 1.0)
+        pix = pixScale(pixs, scalefactor, scalefactor);
+    else
+        pix = pixClone(pixs);
+    pixDestroy(&pixs);
+    scaledres = (l_int32)(res * scalefactor);
+    if (selectDefaultPdfEncoding(pix, &type)) {
+        L_ERROR_STRING("encoding type selection failed for file %s",
+                       procName, fname);
+        pixDestroy(&pix);
+        return 1;
+    }
+    ret = pixConvertToPdfData(pix, type, quality, pdata, pnbytes,
+                              0, 0, scaledres, NULL, 0, title);
+    pixDestroy(&pix);
+    if (ret) {
+        L_ERROR_STRING("pdf encoding failed for %s", procName, fname);
+        return 1;
+    }
+    return 0;
+}
+
+
 /*!
  *  selectDefaultPdfEncoding()
  *
@@ -428,6 +589,321 @@ PIXCMAP  *cmap;
 }
 
 
+/*---------------------------------------------------------------------*
+ *                   Streaming multi-page pdf writer                   *
+ *---------------------------------------------------------------------*/
+/*!
+ *  pdfWriterCreate()
+ *
+ *      Input:  fileout (output pdf file)
+ *              title (<optional> pdf title; can be null)
+ *      Return: lpw, or null on error
+ *
+ *  Notes:
+ *      (1) The file is opened here, and is written as each page is added.
+ *          It is completed and closed by pdfWriterClose().  If that
+ *          fails, the incomplete file is removed.
+ */
+L_PDF_WRITER *
+pdfWriterCreate(const char  *fileout,
+                const char  *title)
+{
+FILE          *fp;
+L_PDF_WRITER  *lpw;
+
+    PROCNAME("pdfWriterCreate");
+
+    if (!fileout)
+        return (L_PDF_WRITER *)ERROR_PTR("fileout not defined", procName, NULL);
+
+    if ((fp = fopenWriteStream(fileout, "wb")) == NULL)
+        return (L_PDF_WRITER *)ERROR_PTR("stream not opened", procName, NULL);
+    if ((lpw = (L_PDF_WRITER *)CALLOC(1, sizeof(L_PDF_WRITER))) == NULL) {
+        fclose(fp);
+        return (L_PDF_WRITER *)ERROR_PTR("lpw not made", procName, NULL);
+    }
+    lpw->fp = fp;
+    lpw->fileout = genPathname(fileout, NULL);  /* as opened on windows */
+    if (title) lpw->title = stringNew(title);
+    lpw->nalloc = 100;
+    if ((lpw->objloc = (size_t *)CALLOC(lpw->nalloc, sizeof(size_t)))
+            == NULL || (lpw->napage = numaCreate(100)) == NULL) {
+        fclose(fp);
+        FREE(lpw->fileout);
+        if (lpw->title) FREE(lpw->title);
+        if (lpw->objloc) FREE(lpw->objloc);
+        FREE(lpw);
+        return (L_PDF_WRITER *)ERROR_PTR("arrays not made", procName, NULL);
+    }
+    return lpw;
+}
+
+
+/*!
+ *  pdfWriterAddPix()
+ *
+ *      Input:  lpw
+ *              pix
+ *              type (L_G4_ENCODE, L_JPEG_ENCODE, L_FLATE_ENCODE)
+ *              quality (used for JPEG only; 0 for default (75))
+ *              res (override the resolution of the input image, in ppi;
+ *                   use 0 to respect the resolution embedded in the input)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This encodes @pix as a single page and writes it out.
+ *          Use selectDefaultPdfEncoding() to choose the @type.
+ */
+l_int32
+pdfWriterAddPix(L_PDF_WRITER  *lpw,
+                PIX           *pix,
+                l_int32        type,
+                l_int32        quality,
+                l_int32        res)
+{
+l_uint8  *data;
+l_int32   ret;
+size_t    nbytes;
+
+    PROCNAME("pdfWriterAddPix");
+
+    if (!lpw)
+        return ERROR_INT("lpw not defined", procName, 1);
+    if (!pix)
+        return ERROR_INT("pix not defined", procName, 1);
+
+    if (pixConvertToPdfData(pix, type, quality, &data, &nbytes,
+                            0, 0, res, NULL, 0, lpw->title))
+        return ERROR_INT("pdf data not made", procName, 1);
+    ret = pdfWriterAddPdfData(lpw, data, nbytes);
+    FREE(data);
+    return ret;
+}
+
+
+/*!
+ *  pdfWriterAddPdfData()
+ *
+ *      Input:  lpw
+ *              data (single page pdf, as generated by pixConvertToPdfData())
+ *              nbytes (size of data)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) The objects of the page are renumbered, as in
+ *          ptraConcatenatePdfToData(), and written out immediately.
+ *          For the first page, the header and objects 1 and 2 (the
+ *          catalog and the metadata) are also written.
+ *      (2) The data can be made ahead of time, in any order, but the
+ *          pages must be added in the order they are to appear.
+ */
+l_int32
+pdfWriterAddPdfData(L_PDF_WRITER   *lpw,
+                    const l_uint8  *data,
+                    size_t          nbytes)
+{
+l_uint8  *pdfdata, *objdata;
+l_int32   j, nobj;
+l_int32  *sizes, *locs;
+size_t    size;
+L_BYTEA  *bas, *bat1, *bat2;
+NUMA     *na_locs, *na_objs, *na_sizes;
+
+    PROCNAME("pdfWriterAddPdfData");
+
+    if (!lpw)
+        return ERROR_INT("lpw not defined", procName, 1);
+    if (!data)
+        return ERROR_INT("data not defined", procName, 1);
+    if (lpw->error)
+        return ERROR_INT("previous write failed", procName, 1);
+
+        /* Find the object locations */
+    pdfdata = (l_uint8 *)data;  /* we're really not going to change this */
+    bas = l_byteaInitFromMem(pdfdata, nbytes);
+    if (parseTrailerPdf(bas, &na_locs) != 0) {
+        l_byteaDestroy(&bas);
+        return ERROR_INT("can't parse pdf data", procName, 1);
+    }
+    nobj = numaGetCount(na_locs) - 1;
+    if (nobj < 5) {
+        l_byteaDestroy(&bas);
+        numaDestroy(&na_locs);
+        return ERROR_INT("too few objects in pdf data", procName, 1);
+    }
+    na_sizes = numaMakeDelta(na_locs);
+    sizes = numaGetIArray(na_sizes);
+    locs = numaGetIArray(na_locs);
+
+        /* Find the mapping from initial to final object numbers */
+    if (lpw->npages == 0) {
+        numaAddNumber(lpw->napage, 4);  /* object 4 on first page */
+        na_objs = numaMakeSequence(0.0, 1.0, nobj);
+        lpw->nobj = nobj;
+    }
+    else {  /* skip the first 3 objects */
+        numaAddNumber(lpw->napage, lpw->nobj);  /* Page object is first */
+        na_objs = numaMakeConstant(0.0, nobj);
+        numaReplaceNumber(na_objs, 3, 3);  /* refers to parent of all */
+        for (j = 4; j < nobj; j++)
+            numaSetValue(na_objs, j, lpw->nobj++);
+    }
+
+        /* On the first page, write the header and objects 1 and 2.
+         * The Pages object (3) is written at the end. */
+    if (lpw->npages == 0) {
+        for (j = 0; j < 3; j++)
+            pdfWriterAddLoc(lpw, locs[j]);
+        pdfWriterAddLoc(lpw, 0);  /* placeholder for object 3 */
+        pdfWriterWrite(lpw, data, locs[3]);
+    }
+
+        /* Write the renumbered objects for this page */
+    for (j = 4; j < nobj; j++) {
+        pdfWriterAddLoc(lpw, lpw->offset);
+        bat1 = l_byteaInitFromMem(pdfdata + locs[j], sizes[j]);
+        bat2 = substituteObjectNumbers(bat1, na_objs);
+        objdata = l_byteaGetData(bat2, &size);
+        pdfWriterWrite(lpw, objdata, size);
+        l_byteaDestroy(&bat1);
+        l_byteaDestroy(&bat2);
+    }
+    lpw->npages++;
+
+    FREE(sizes);
+    FREE(locs);
+    l_byteaDestroy(&bas);
+    numaDestroy(&na_locs);
+    numaDestroy(&na_objs);
+    numaDestroy(&na_sizes);
+    if (lpw->error)
+        return ERROR_INT("pdf data not written", procName, 1);
+    return 0;
+}
+
+
+/*!
+ *  pdfWriterClose()
+ *
+ *      Input:  &lpw (<will be set to null before returning>)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This writes the Pages object and the trailer, closes the
+ *          file and destroys the lpw.
+ *      (2) It is an error if no pages have been added.  On error,
+ *          the output file is removed, so that no invalid pdf is left.
+ */
+l_int32
+pdfWriterClose(L_PDF_WRITER  **plpw)
+{
+char          *str_pages, *str_trailer;
+l_int32        ret;
+L_PDF_WRITER  *lpw;
+
+    PROCNAME("pdfWriterClose");
+
+    if (plpw == NULL)
+        return ERROR_INT("ptr address is null", procName, 1);
+    if ((lpw = *plpw) == NULL)
+        return ERROR_INT("lpw not defined", procName, 1);
+
+    ret = 0;
+    if (lpw->npages == 0) {
+        L_ERROR("no pages written", procName);
+        ret = 1;
+    }
+    else if (lpw->error) {
+        L_ERROR("pdf data not written to file", procName);
+        ret = 1;
+    }
+    else {
+            /* Add the Pages object (#3), then the xref and trailer */
+        str_pages = generatePagesObjStringPdf(lpw->napage);
+        lpw->objloc[3] = lpw->offset;
+        pdfWriterWrite(lpw, str_pages, strlen(str_pages));
+        pdfWriterAddLoc(lpw, lpw->offset);  /* xref location */
+        str_trailer = makeTrailerStringFromArrayPdf(lpw->objloc, lpw->nloc);
+        pdfWriterWrite(lpw, str_trailer, strlen(str_trailer));
+        FREE(str_pages);
+        FREE(str_trailer);
+        if (lpw->error) {
+            L_ERROR("pdf data not written to file", procName);
+            ret = 1;
+        }
+    }
+
+    fclose(lpw->fp);
+    if (ret && lpw->fileout)
+        remove(lpw->fileout);
+    FREE(lpw->fileout);
+    if (lpw->title) FREE(lpw->title);
+    FREE(lpw->objloc);
+    numaDestroy(&lpw->napage);
+    FREE(lpw);
+    *plpw = NULL;
+    return ret;
+}
+
+
+/*!
+ *  pdfWriterWrite()
+ *
+ *      Input:  lpw
+ *              data
+ *              nbytes
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This keeps track of the byte offset in the output, which
+ *          is needed for the xref table.  On failure, lpw->error is set.
+ */
+static l_int32
+pdfWriterWrite(L_PDF_WRITER  *lpw,
+               const void    *data,
+               size_t         nbytes)
+{
+    PROCNAME("pdfWriterWrite");
+
+    if (fwrite(data, 1, nbytes, lpw->fp) != nbytes) {
+        lpw->error = 1;
+        return ERROR_INT("write failed", procName, 1);
+    }
+    lpw->offset += nbytes;
+    return 0;
+}
+
+
+/*!
+ *  pdfWriterAddLoc()
+ *
+ *      Input:  lpw
+ *              loc (byte location of the next object, or of the xref)
+ *      Return: 0 if OK, 1 on error
+ */
+static l_int32
+pdfWriterAddLoc(L_PDF_WRITER  *lpw,
+                size_t         loc)
+{
+size_t  *objloc;
+
+    PROCNAME("pdfWriterAddLoc");
+
+    if (lpw->nloc >= lpw->nalloc) {
+        if ((objloc = (size_t *)reallocNew((void **)&lpw->objloc,
+                                   sizeof(size_t) * lpw->nalloc,
+                                   2 * sizeof(size_t) * lpw->nalloc)) == NULL) {
+            lpw->error = 1;
+            return ERROR_INT("new ptr array not returned", procName, 1);
+        }
+        lpw->objloc = objloc;
+        lpw->nalloc *= 2;
+    }
+    lpw->objloc[lpw->nloc++] = loc;
+    return 0;
+}
+
+
 /*---------------------------------------------------------------------*
  *                Single page, multi-image converters                  *
  *---------------------------------------------------------------------*/
@@ -1934,16 +2410,49 @@ NUMA    *naloc, *nasize;
 static char *
 makeTrailerStringPdf(NUMA  *naloc)
 {
-char    *outstr;
-char     buf[L_BIGBUF];
-l_int32  i, n, linestart, xrefloc;
-SARRAY  *sa;
+char     *outstr;
+l_int32   i, n, loc;
+size_t   *locs;
 
     PROCNAME("makeTrailerStringPdf");
 
     if (!naloc)
         return (char *)ERROR_PTR("naloc not defined", procName, NULL);
-    n = numaGetCount(naloc) - 1;  /* numbered objects + 1 (yes, +1) */
+
+    n = numaGetCount(naloc);
+    if ((locs = (size_t *)CALLOC(n, sizeof(size_t))) == NULL)
+        return (char *)ERROR_PTR("locs not made", procName, NULL);
+    for (i = 0; i < n; i++) {
+        numaGetIValue(naloc, i, &loc);
+        locs[i] = loc;
+    }
+    outstr = makeTrailerStringFromArrayPdf(locs, n);
+    FREE(locs);
+    return outstr;
+}
+
+
+/*!
+ *  makeTrailerStringFromArrayPdf()
+ *
+ *      Input:  locs (byte locations of the objects, followed by the xref)
+ *              n (number of locations: the number of objects + 1)
+ *      Return: xref and trailer string, or null on error
+ */
+static char *
+makeTrailerStringFromArrayPdf(size_t   *locs,
+                              l_int32   n)
+{
+char    *outstr;
+char     buf[L_BIGBUF];
+l_int32  i;
+SARRAY  *sa;
+
+    PROCNAME("makeTrailerStringFromArrayPdf");
+
+    if (!locs)
+        return (char *)ERROR_PTR("locs not defined", procName, NULL);
+    n = n - 1;  /* numbered objects + 1 (yes, +1) */
 
     sa = sarrayCreate(0);
     snprintf(buf, sizeof(buf), "xref\n"
@@ -1951,12 +2460,11 @@ SARRAY  *sa;
                                "0000000000 65535 f \n", n);
     sarrayAddString(sa, (char *)buf, L_COPY);
     for (i = 1; i < n; i++) {
-        numaGetIValue(naloc, i, &linestart);
-        snprintf(buf, sizeof(buf), "%010d 00000 n \n", linestart);
+        snprintf(buf, sizeof(buf), "%010lu 00000 n \n",
+                 (unsigned long)locs[i]);
         sarrayAddString(sa, (char *)buf, L_COPY);
     }
 
-    numaGetIValue(naloc, n, &xrefloc);
     snprintf(buf, sizeof(buf), "trailer\n"
                                "<<\n"
                                "/Size %d\n"
@@ -1964,8 +2472,8 @@ SARRAY  *sa;
                                "/Info 2 0 R\n"
                                ">>\n"
                                "startxref\n"
-                               "%d\n"
-                               "%%%%EOF\n", n, xrefloc);
+                               "%lu\n"
+                               "%%%%EOF\n", n, (unsigned long)locs[n]);
     sarrayAddString(sa, (char *)buf, L_COPY);
     outstr = sarrayToString(sa, 0);
     sarrayDestroy(&sa);
@@ -39,6 +39,13 @@ l_int32 saConvertFilesToPdf(SARRAY *sa, l_int32 res,
     return ERROR_INT("function not present", "saConvertFilesToPdf", 1);
 }
 
+l_int32 saConvertFilesToPdfStreaming(SARRAY *sa, l_int32 res,
+                                     l_float32 scalefactor, l_int32 quality,
+                                     const char *title, const char *fileout)
+{
+    return ERROR_INT("function not present", "saConvertFilesToPdfStreaming", 1);
+}
+
 l_int32 saConvertFilesToPdfData(SARRAY *sa, l_int32 res,
                                 l_float32 scalefactor, l_int32 quality,
                                 const char *title, l_uint8 **pdata,
@@ -47,11 +54,42 @@ l_int32 saConvertFilesToPdfData(SARRAY *sa, l_int32 res,
     return ERROR_INT("function not present", "saConvertFilesToPdfData", 1);
 }
 
+l_int32 convertFileToPdfPageData(const char *fname, l_int32 res,
+                                 l_float32 scalefactor, l_int32 quality,
+                                 const char *title, l_uint8 **pdata,
+                                 size_t *pnbytes)
+{
+    return ERROR_INT("function not present", "convertFileToPdfPageData", 1);
+}
+
 l_int32 selectDefaultPdfEncoding(PIX *pix, l_int32 *ptype)
 {
     return ERROR_INT("function not present", "selectDefaultPdfEncoding", 1);
 }
 
+L_PDF_WRITER * pdfWriterCreate(const char *fileout, const char *title)
+{
+    return (L_PDF_WRITER * )ERROR_PTR("function not present",
+                                      "pdfWriterCreate", NULL);
+}
+
+l_int32 pdfWriterAddPix(L_PDF_WRITER *lpw, PIX *pix, l_int32 type,
+                        l_int32 quality, l_int32 res)
+{
+    return ERROR_INT("function not present", "pdfWriterAddPix", 1);
+}
+
+l_int32 pdfWriterAddPdfData(L_PDF_WRITER *lpw, const l_uint8 *data,
+                            size_t nbytes)
+{
+    return ERROR_INT("function not present", "pdfWriterAddPdfData", 1);
+}
+
+l_int32 pdfWriterClose(L_PDF_WRITER **plpw)
+{
+    return ERROR_INT("function not present", "pdfWriterClose", 1);
+}
+
 l_int32 convertToPdf(const char *filein,
                      l_int32 type, l_int32 quality,
                      const char *fileout,
@@ -37,6 +37,7 @@
  *       struct DPix
  *       struct PixComp
  *       struct PixaComp
+ *       struct PixaCompCache
  *
  *   Contains definitions for:
  *       Colors for RGB
@@ -554,10 +555,27 @@ struct PixaComp
     l_int32              nalloc;      /* number of PixComp ptrs allocated  */
     struct PixComp     **pixc;        /* the array of ptrs to PixComp      */
     struct Boxa         *boxa;        /* array of boxes                    */
+    struct PixaCompCache *cache;      /* optional cache of decoded pix     */
 };
 typedef struct PixaComp PIXAC;
 
 
+    /* Decoded pix are kept in least-recently-used order, in a doubly
+     * linked list threaded through the prev and next arrays. */
+struct PixaCompCache
+{
+    size_t               maxbytes;    /* budget for the cached raster data */
+    size_t               nbytes;      /* raster data currently cached      */
+    l_int32              nalloc;      /* size of the arrays                */
+    struct Pix         **pix;         /* decoded pix; same index as pixc   */
+    l_int32             *prev;        /* index of more recently used pix   */
+    l_int32             *next;        /* index of less recently used pix   */
+    l_int32              head;        /* most recently used; -1 if empty   */
+    l_int32              tail;        /* least recently used; -1 if empty  */
+};
+typedef struct PixaCompCache L_PIXAC_CACHE;
+
+
 /*-------------------------------------------------------------------------*
  *                         Access and storage flags                        *
  *-------------------------------------------------------------------------*/
@@ -845,6 +863,16 @@ enum {
 };
 
 
+/*-------------------------------------------------------------------------*
+ *                  Filters for separable resampling                       *
+ *-------------------------------------------------------------------------*/
+enum {
+    L_LINEAR_FILTER = 1,     /* default: linear interp or area mapping     */
+    L_BICUBIC_FILTER = 2,    /* cubic convolution (Keys, a = -0.5)         */
+    L_LANCZOS3_FILTER = 3    /* sinc windowed by sinc, with 3 lobes        */
+};
+
+
 /*-------------------------------------------------------------------------*
  *                             Thinning flags                              *
  *-------------------------------------------------------------------------*/
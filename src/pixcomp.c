@@ -55,6 +55,14 @@
  *           BOX      *pixacompGetBox()
  *           l_int32   pixacompGetBoxGeometry()
  *
+ *      Pixacomp cache of decoded pix
+ *           l_int32   pixacompSetCache()
+ *           l_int32   pixacompClearCache()
+ *           static PIX       *pixacompCacheGet()
+ *           static l_int32    pixacompCacheInsert()
+ *           static void       pixacompCacheRemove()
+ *           static void       pixacompCacheDestroy()
+ *
  *      Pixacomp conversion to Pixa
  *           PIXA     *pixaCreateFromPixacomp()
  *
@@ -91,6 +99,11 @@
  *   initialize a fully populated array using pixacompCreateInitialized().
  *   Then use pixacompReplacePix() or pixacompReplacePixcomp() for
  *   the random insertion.
+ *
+ *   When the same images are fetched repeatedly, decompression can be
+ *   avoided by giving the pixacomp a cache of decoded pix with
+ *   pixacompSetCache().  The cache holds the most recently used pix,
+ *   up to a budget on the total size of their raster data.
  */
 
 #include <string.h>
@@ -102,6 +115,12 @@ static const l_int32  INITIAL_PTR_ARRAYSIZE = 20;   /* n'import quoi */
 extern l_int32 NumImageFileFormatExtensions;
 extern const char *ImageFileFormatExtensions[];
 
+static PIX *pixacompCacheGet(L_PIXAC_CACHE *cache, l_int32 index);
+static l_int32 pixacompCacheInsert(L_PIXAC_CACHE *cache, l_int32 index,
+                                   PIX *pix);
+static void pixacompCacheRemove(L_PIXAC_CACHE *cache, l_int32 index);
+static void pixacompCacheDestroy(L_PIXAC_CACHE **pcache);
+
 
 /*---------------------------------------------------------------------*
  *                  Pixcomp creation and destruction                   *
@@ -689,6 +708,7 @@ PIXAC   *pixac;
         pixcompDestroy(&pixac->pixc[i]);
     FREE(pixac->pixc);
     boxaDestroy(&pixac->boxa);
+    pixacompCacheDestroy(&pixac->cache);
     FREE(pixac);
 
     *ppixac = NULL;
@@ -868,6 +888,8 @@ PIXC    *pixct;
     pixct = pixacompGetPixcomp(pixac, index);
     pixcompDestroy(&pixct);
     pixac->pixc[index] = pixc;  /* replace */
+    if (pixac->cache)  /* the decoded pix is now stale */
+        pixacompCacheRemove(pixac->cache, index);
 
     return 0;
 }
@@ -953,11 +975,18 @@ pixacompGetPixcomp(PIXAC   *pixac,
  *      Input:  pixac
  *              index  (to the index-th pix)
  *      Return: pix, or null on error
+ *
+ *  Notes:
+ *      (1) If the pixac has a cache (see pixacompSetCache()), the
+ *          pix is copied from the cache when it is there, which avoids
+ *          decompression.  In either case the returned pix is owned
+ *          by the caller, and altering it does not change the cache.
  */
 PIX *
 pixacompGetPix(PIXAC   *pixac,
                l_int32  index)
 {
+PIX   *pix;
 PIXC  *pixc;
 
     PROCNAME("pixacompGetPix");
@@ -967,8 +996,15 @@ PIXC  *pixc;
     if (index < 0 || index >= pixac->n)
         return (PIX *)ERROR_PTR("index not valid", procName, NULL);
 
+    if (pixac->cache && (pix = pixacompCacheGet(pixac->cache, index)))
+        return pix;
+
     pixc = pixacompGetPixcomp(pixac, index);
-    return pixCreateFromPixcomp(pixc);
+    if ((pix = pixCreateFromPixcomp(pixc)) == NULL)
+        return (PIX *)ERROR_PTR("pix not made", procName, NULL);
+    if (pixac->cache)
+        pixacompCacheInsert(pixac->cache, index, pix);
+    return pix;
 }
 
 
@@ -1127,6 +1163,237 @@ BOX  *box;
 }
 
 
+/*---------------------------------------------------------------------*
+ *                    Pixacomp cache of decoded pix                    *
+ *---------------------------------------------------------------------*/
+/*!
+ *  pixacompSetCache()
+ *
+ *      Input:  pixac
+ *              maxbytes (budget for the raster data of cached pix;
+ *                        use 0 to remove the cache)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) With a cache, pixacompGetPix() keeps a copy of each pix it
+ *          decodes, and returns another copy if the same pix is
+ *          requested again.  When the raster data of the cached pix
+ *          exceeds @maxbytes, the least recently used pix are dropped.
+ *          A pix larger than @maxbytes is never cached.
+ *      (2) The cached pix are never handed out, so pix returned by
+ *          pixacompGetPix() can be altered freely.
+ *      (3) Calling this on a pixac that has a cache changes the
+ *          budget, dropping pix if necessary.
+ */
+l_int32
+pixacompSetCache(PIXAC   *pixac,
+                 size_t   maxbytes)
+{
+L_PIXAC_CACHE  *cache;
+
+    PROCNAME("pixacompSetCache");
+
+    if (!pixac)
+        return ERROR_INT("pixac not defined", procName, 1);
+
+    if (maxbytes == 0) {
+        pixacompCacheDestroy(&pixac->cache);
+        return 0;
+    }
+
+    if ((cache = pixac->cache) == NULL) {
+        if ((cache = (L_PIXAC_CACHE *)CALLOC(1, sizeof(L_PIXAC_CACHE)))
+                == NULL)
+            return ERROR_INT("cache not made", procName, 1);
+        cache->head = cache->tail = -1;
+        pixac->cache = cache;
+    }
+    cache->maxbytes = maxbytes;
+    while (cache->nbytes > maxbytes)
+        pixacompCacheRemove(cache, cache->tail);
+    return 0;
+}
+
+
+/*!
+ *  pixacompClearCache()
+ *
+ *      Input:  pixac
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This drops all cached pix, but keeps the cache and its budget.
+ *          It is not an error if the pixac has no cache.
+ */
+l_int32
+pixacompClearCache(PIXAC  *pixac)
+{
+L_PIXAC_CACHE  *cache;
+
+    PROCNAME("pixacompClearCache");
+
+    if (!pixac)
+        return ERROR_INT("pixac not defined", procName, 1);
+
+    if ((cache = pixac->cache) == NULL)
+        return 0;
+    while (cache->tail >= 0)
+        pixacompCacheRemove(cache, cache->tail);
+    return 0;
+}
+
+
+/*!
+ *  pixacompCacheGet()
+ *
+ *      Input:  cache
+ *              index
+ *      Return: copy of the cached pix, or null if it is not cached
+ *
+ *  Notes:
+ *      (1) On a hit, the pix becomes the most recently used.
+ */
+static PIX *
+pixacompCacheGet(L_PIXAC_CACHE  *cache,
+                 l_int32         index)
+{
+l_int32  prev, next;
+
+    if (index >= cache->nalloc || !cache->pix[index])
+        return NULL;
+
+    if (cache->head != index) {  /* unlink and move to the head */
+        prev = cache->prev[index];
+        next = cache->next[index];
+        cache->next[prev] = next;
+        if (next >= 0)
+            cache->prev[next] = prev;
+        else
+            cache->tail = prev;
+        cache->prev[index] = -1;
+        cache->next[index] = cache->head;
+        cache->prev[cache->head] = index;
+        cache->head = index;
+    }
+    return pixCopy(NULL, cache->pix[index]);
+}
+
+
+/*!
+ *  pixacompCacheInsert()
+ *
+ *      Input:  cache
+ *              index (not already in the cache)
+ *              pix (a copy is cached)
+ *      Return: 0 if OK, 1 on error
+ */
+static l_int32
+pixacompCacheInsert(L_PIXAC_CACHE  *cache,
+                    l_int32         index,
+                    PIX            *pix)
+{
+l_int32  nalloc;
+size_t   nbytes;
+
+    PROCNAME("pixacompCacheInsert");
+
+    nbytes = 4 * pixGetWpl(pix) * pixGetHeight(pix);
+    if (nbytes > cache->maxbytes)
+        return 0;
+
+    if (index >= cache->nalloc) {
+        nalloc = L_MAX(2 * cache->nalloc, index + 1);
+        if ((cache->pix = (PIX **)reallocNew((void **)&cache->pix,
+                                 sizeof(PIX *) * cache->nalloc,
+                                 sizeof(PIX *) * nalloc)) == NULL ||
+            (cache->prev = (l_int32 *)reallocNew((void **)&cache->prev,
+                                 sizeof(l_int32) * cache->nalloc,
+                                 sizeof(l_int32) * nalloc)) == NULL ||
+            (cache->next = (l_int32 *)reallocNew((void **)&cache->next,
+                                 sizeof(l_int32) * cache->nalloc,
+                                 sizeof(l_int32) * nalloc)) == NULL)
+            return ERROR_INT("cache arrays not extended", procName, 1);
+        cache->nalloc = nalloc;
+    }
+
+        /* Make room, then add at the head */
+    while (cache->nbytes + nbytes > cache->maxbytes)
+        pixacompCacheRemove(cache, cache->tail);
+    if ((cache->pix[index] = pixCopy(NULL, pix)) == NULL)
+        return ERROR_INT("pix not copied", procName, 1);
+    cache->prev[index] = -1;
+    cache->next[index] = cache->head;
+    if (cache->head >= 0)
+        cache->prev[cache->head] = index;
+    else
+        cache->tail = index;
+    cache->head = index;
+    cache->nbytes += nbytes;
+    return 0;
+}
+
+
+/*!
+ *  pixacompCacheRemove()
+ *
+ *      Input:  cache
+ *              index (it is not an error if it is not in the cache)
+ *      Return: void
+ */
+static void
+pixacompCacheRemove(L_PIXAC_CACHE  *cache,
+                    l_int32         index)
+{
+l_int32  prev, next;
+PIX     *pix;
+
+    if (index < 0 || index >= cache->nalloc || !cache->pix[index])
+        return;
+
+    prev = cache->prev[index];
+    next = cache->next[index];
+    if (prev >= 0)
+        cache->next[prev] = next;
+    else
+        cache->head = next;
+    if (next >= 0)
+        cache->prev[next] = prev;
+    else
+        cache->tail = prev;
+
+    pix = cache->pix[index];
+    cache->nbytes -= 4 * pixGetWpl(pix) * pixGetHeight(pix);
+    pixDestroy(&cache->pix[index]);
+    return;
+}
+
+
+/*!
+ *  pixacompCacheDestroy()
+ *
+ *      Input:  &cache (<to be nulled>)
+ *      Return: void
+ */
+static void
+pixacompCacheDestroy(L_PIXAC_CACHE  **pcache)
+{
+l_int32         i;
+L_PIXAC_CACHE  *cache;
+
+    if ((cache = *pcache) == NULL)
+        return;
+
+    for (i = 0; i < cache->nalloc; i++)
+        pixDestroy(&cache->pix[i]);
+    FREE(cache->pix);
+    FREE(cache->prev);
+    FREE(cache->next);
+    FREE(cache);
+    *pcache = NULL;
+    return;
+}
+
+
 /*---------------------------------------------------------------------*
  *                      Pixacomp conversion to Pixa                    *
  *---------------------------------------------------------------------*/
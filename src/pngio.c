@@ -18,6 +18,7 @@
  *                     
  *    Read png from file
  *          PIX        *pixReadStreamPng()
+ *          PIX        *pixReadStreamPngReduced()
  *          l_int32     readHeaderPng()
  *          l_int32     freadHeaderPng()
  *          l_int32     sreadHeaderPng()
@@ -328,6 +329,193 @@ PIXCMAP     *cmap;
 }
 
 
+/*!
+ *  pixReadStreamPngReduced()
+ *
+ *      Input:  stream
+ *              reduction (scaling factor: 1, 2, 4 or 8)
+ *      Return: pix, or null on error
+ *
+ *  Notes:
+ *      (1) This decodes a reduced image, averaging over each
+ *          @reduction x @reduction block as in pixScaleByIntReduction():
+ *          1 bpp is returned as 8 bpp gray, and a colormap is removed.
+ *      (2) The rows are decoded in bands of @reduction rows, and each
+ *          band is reduced as soon as it is complete, so the full
+ *          resolution image is never made.  The result is the same as
+ *          reducing the image read by pixReadStreamPng().
+ *      (3) Interlaced images are decoded in full and then reduced.
+ *      (4) For @reduction == 1, this is pixReadStreamPng().
+ */
+PIX *
+pixReadStreamPngReduced(FILE    *fp,
+                        l_int32  reduction)
+{
+l_uint8      rval, gval, bval;
+l_int32      i, j, k, n, wpl, wd, hd, d, spp, cindex, invert;
+l_uint32    *line, *ppixel;
+int          num_palette, num_text;
+png_byte     bit_depth, color_type, interlace_type;
+png_uint_32  w, h, rowbytes;
+png_uint_32  xres, yres;
+png_bytep    rowbuf;
+png_structp  png_ptr;
+png_infop    info_ptr;
+png_colorp   palette;
+png_textp    text_ptr;  /* ptr to text_chunk */
+PIX         *pixb, *pixt, *pixd;
+PIXCMAP     *cmap;
+
+    PROCNAME("pixReadStreamPngReduced");
+
+    if (!fp)
+        return (PIX *)ERROR_PTR("fp not defined", procName, NULL);
+    if (reduction != 1 && reduction != 2 && reduction != 4 && reduction != 8)
+        return (PIX *)ERROR_PTR("reduction not in {1,2,4,8}", procName, NULL);
+    if (reduction == 1)
+        return pixReadStreamPng(fp);
+
+    if ((png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING,
+                   (png_voidp)NULL, NULL, NULL)) == NULL)
+        return (PIX *)ERROR_PTR("png_ptr not made", procName, NULL);
+    if ((info_ptr = png_create_info_struct(png_ptr)) == NULL) {
+        png_destroy_read_struct(&png_ptr, (png_infopp)NULL, (png_infopp)NULL);
+        return (PIX *)ERROR_PTR("info_ptr not made", procName, NULL);
+    }
+    if (setjmp(png_jmpbuf(png_ptr))) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+        return (PIX *)ERROR_PTR("internal png error", procName, NULL);
+    }
+
+    png_init_io(png_ptr, fp);
+    png_read_info(png_ptr, info_ptr);
+    w = png_get_image_width(png_ptr, info_ptr);
+    h = png_get_image_height(png_ptr, info_ptr);
+    bit_depth = png_get_bit_depth(png_ptr, info_ptr);
+    color_type = png_get_color_type(png_ptr, info_ptr);
+    interlace_type = png_get_interlace_type(png_ptr, info_ptr);
+
+        /* The rows of an interlaced image are not decoded in order */
+    if (interlace_type != PNG_INTERLACE_NONE) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+        rewind(fp);
+        if ((pixt = pixReadStreamPng(fp)) == NULL)
+            return (PIX *)ERROR_PTR("pixt not read", procName, NULL);
+        pixd = pixScaleByIntReduction(pixt, reduction);
+        pixDestroy(&pixt);
+        return pixd;
+    }
+
+        /* Use the same transforms as pixReadStreamPng() */
+    if (bit_depth == 16 && var_PNG_STRIP_16_TO_8 == 1)
+        png_set_strip_16(png_ptr);
+    if ((color_type & PNG_COLOR_MASK_ALPHA) && var_PNG_STRIP_ALPHA == 1)
+        png_set_strip_alpha(png_ptr);
+    png_read_update_info(png_ptr, info_ptr);
+    bit_depth = png_get_bit_depth(png_ptr, info_ptr);
+    rowbytes = png_get_rowbytes(png_ptr, info_ptr);
+    spp = png_get_channels(png_ptr, info_ptr);
+    if (spp == 2 || (spp > 2 && bit_depth != 8)) {
+        png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+        return (PIX *)ERROR_PTR("not implemented for this format",
+                                procName, NULL);
+    }
+    d = (spp == 1) ? bit_depth : 32;
+
+    cmap = NULL;
+    if (color_type == PNG_COLOR_TYPE_PALETTE ||
+        color_type == PNG_COLOR_MASK_PALETTE) {   /* generate a colormap */
+        png_get_PLTE(png_ptr, info_ptr, &palette, &num_palette);
+        cmap = pixcmapCreate(d);  /* spp == 1 */
+        for (cindex = 0; cindex < num_palette; cindex++) {
+            rval = palette[cindex].red;
+            gval = palette[cindex].green;
+            bval = palette[cindex].blue;
+            pixcmapAddColor(cmap, rval, gval, bval);
+        }
+    }
+
+        /* See pixReadStreamPng() for the polarity of binary images */
+    invert = (d == 1 &&
+              (!cmap || ((l_uint8 *)(cmap->array))[0] == 0x0)) ? 1 : 0;
+
+        /* Make the band, and reduce an empty band to find the size
+         * of the result */
+    hd = h / reduction;
+    pixb = pixCreate(w, reduction, d);
+    pixSetColormap(pixb, cmap);
+    if (!pixb || hd == 0 ||
+        (pixt = pixScaleByIntReduction(pixb, reduction)) == NULL) {
+        pixDestroy(&pixb);
+        png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+        return (PIX *)ERROR_PTR("image too small to reduce", procName, NULL);
+    }
+    wd = pixGetWidth(pixt);
+    pixd = pixCreate(wd, hd, pixGetDepth(pixt));
+    pixDestroy(&pixt);
+    rowbuf = (png_bytep)CALLOC(rowbytes, sizeof(png_byte));
+    if (!pixd || !rowbuf) {
+        pixDestroy(&pixb);
+        pixDestroy(&pixd);
+        FREE(rowbuf);
+        png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+        return (PIX *)ERROR_PTR("pixd or rowbuf not made", procName, NULL);
+    }
+
+        /* Reset error handling to also clean up the band and result */
+    if (setjmp(png_jmpbuf(png_ptr))) {
+        pixDestroy(&pixb);
+        pixDestroy(&pixd);
+        FREE(rowbuf);
+        png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+        return (PIX *)ERROR_PTR("internal png error", procName, NULL);
+    }
+
+    wpl = pixGetWpl(pixb);
+    for (n = 0; n < hd; n++) {
+        for (i = 0; i < reduction; i++) {
+            png_read_row(png_ptr, rowbuf, NULL);
+            line = pixGetData(pixb) + i * wpl;
+            if (spp == 1) {   /* copy straight from buffer to pix */
+                for (j = 0; j < rowbytes; j++)
+                    SET_DATA_BYTE(line, j, rowbuf[j]);
+            }
+            else {   /* spp == 3 or spp == 4 */
+                ppixel = line;
+                for (j = k = 0; j < w; j++) {
+                    SET_DATA_BYTE(ppixel, COLOR_RED, rowbuf[k++]);
+                    SET_DATA_BYTE(ppixel, COLOR_GREEN, rowbuf[k++]);
+                    SET_DATA_BYTE(ppixel, COLOR_BLUE, rowbuf[k++]);
+                    if (spp == 4)
+                        SET_DATA_BYTE(ppixel, L_ALPHA_CHANNEL, rowbuf[k++]);
+                    ppixel++;
+                }
+            }
+        }
+        if (invert)
+            pixInvert(pixb, pixb);
+        pixt = pixScaleByIntReduction(pixb, reduction);
+        pixRasterop(pixd, 0, n, wd, 1, PIX_SRC, pixt, 0, 0);
+        pixDestroy(&pixt);
+    }
+
+    xres = png_get_x_pixels_per_meter(png_ptr, info_ptr);
+    yres = png_get_y_pixels_per_meter(png_ptr, info_ptr);
+    pixSetXRes(pixd, (l_int32)((l_float32)xres / 39.37 / reduction + 0.5));
+    pixSetYRes(pixd, (l_int32)((l_float32)yres / 39.37 / reduction + 0.5));
+
+        /* Get the text if there is any before the image data */
+    png_get_text(png_ptr, info_ptr, &text_ptr, &num_text);
+    if (num_text && text_ptr)
+        pixSetText(pixd, text_ptr->text);
+
+    pixDestroy(&pixb);
+    FREE(rowbuf);
+    png_destroy_read_struct(&png_ptr, &info_ptr, (png_infopp)NULL);
+    return pixd;
+}
+
+
 /*!
  *  readHeaderPng()
  *
@@ -34,6 +34,11 @@ PIX * pixReadStreamPng(FILE *fp)
     return (PIX * )ERROR_PTR("function not present", "pixReadStreamPng", NULL);
 }
 
+PIX * pixReadStreamPngReduced(FILE *fp, l_int32 reduction)
+{
+    return (PIX * )ERROR_PTR("function not present", "pixReadStreamPngReduced", NULL);
+}
+
 l_int32 readHeaderPng(const char *filename, l_int32 *pwidth, l_int32 *pheight, l_int32 *pbps, l_int32 *pspp, l_int32 *piscmap)
 {
     return ERROR_INT("function not present", "readHeaderPng", 1);
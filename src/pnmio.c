@@ -95,9 +95,10 @@ static const l_int32  MAX_PNM_HEIGHT = 100000;
 PIX *
 pixReadStreamPnm(FILE  *fp)
 {
-l_uint8    val8, rval8, gval8, bval8;
+l_uint8   *rowbuf, *pel;
 l_uint16   val16;
-l_int32    w, h, d, bpl, wpl, i, j, type;
+l_int32    w, h, d, wpl, i, j, type;
+size_t     fbpl;
 l_int32    val, rval, gval, bval;
 l_uint32   rgbval;
 l_uint32  *line, *data;
@@ -137,62 +138,75 @@ PIX       *pix;
         return pix;
     }
 
+        /* "raw" formats: read a full raster line at a time */
+    if (type == 4)
+        fbpl = (d * w + 7) / 8;
+    else if (type == 5)
+        fbpl = (d == 16) ? 2 * w : w;
+    else  /* type == 6 */
+        fbpl = 3 * w;
+    if ((rowbuf = (l_uint8 *)CALLOC(fbpl, sizeof(l_uint8))) == NULL)
+        return (PIX *)ERROR_PTR("rowbuf not made", procName, pix);
+
         /* "raw" format for 1 bpp */
     if (type == 4) {
-        bpl = (d * w + 7) / 8;
         for (i = 0; i < h; i++) {
             line = data + i * wpl;
-            for (j = 0; j < bpl; j++) {
-                if (fread(&val8, 1, 1, fp) != 1)
-                    return (PIX *)ERROR_PTR( "read error in 4", procName, pix);
-                SET_DATA_BYTE(line, j, val8);
+            if (fread(rowbuf, 1, fbpl, fp) != fbpl) {
+                FREE(rowbuf);
+                return (PIX *)ERROR_PTR( "read error in 4", procName, pix);
             }
+            for (j = 0; j < fbpl; j++)
+                SET_DATA_BYTE(line, j, rowbuf[j]);
         }
+        FREE(rowbuf);
         return pix;
     }
 
         /* "raw" format for grayscale */
     if (type == 5) {
-        bpl = (d * w + 7) / 8;
         for (i = 0; i < h; i++) {
             line = data + i * wpl;
-            if (d != 16) {
-                for (j = 0; j < w; j++) {
-                    if (fread(&val8, 1, 1, fp) != 1)
-                        return (PIX *)ERROR_PTR( "error in 5", procName, pix);
-                    if (d == 2)
-                        SET_DATA_DIBIT(line, j, val8);
-                    else if (d == 4)
-                        SET_DATA_QBIT(line, j, val8);
-                    else  /* d == 8 */
-                        SET_DATA_BYTE(line, j, val8);
-                }
+            if (fread(rowbuf, 1, fbpl, fp) != fbpl) {
+                FREE(rowbuf);
+                return (PIX *)ERROR_PTR( "error in 5", procName, pix);
+            }
+            if (d == 2) {
+                for (j = 0; j < w; j++)
+                    SET_DATA_DIBIT(line, j, rowbuf[j]);
+            }
+            else if (d == 4) {
+                for (j = 0; j < w; j++)
+                    SET_DATA_QBIT(line, j, rowbuf[j]);
+            }
+            else if (d == 8) {
+                for (j = 0; j < w; j++)
+                    SET_DATA_BYTE(line, j, rowbuf[j]);
             }
             else {  /* d == 16 */
                 for (j = 0; j < w; j++) {
-                    if (fread(&val16, 2, 1, fp) != 1)
-                        return (PIX *)ERROR_PTR( "16 bpp error", procName, pix);
+                    memcpy(&val16, rowbuf + 2 * j, 2);
                     SET_DATA_TWO_BYTES(line, j, val16);
                 }
             }
         }
+        FREE(rowbuf);
         return pix;
     }
 
         /* "raw" format, type == 6; rgb */
     for (i = 0; i < h; i++) {
         line = data + i * wpl;
-        for (j = 0; j < wpl; j++) {
-            if (fread(&rval8, 1, 1, fp) != 1)
-                return (PIX *)ERROR_PTR( "read error type 6", procName, pix);
-            if (fread(&gval8, 1, 1, fp) != 1)
-                return (PIX *)ERROR_PTR( "read error type 6", procName, pix);
-            if (fread(&bval8, 1, 1, fp) != 1)
-                return (PIX *)ERROR_PTR( "read error type 6", procName, pix);
-            composeRGBPixel(rval8, gval8, bval8, &rgbval);
+        if (fread(rowbuf, 1, fbpl, fp) != fbpl) {
+            FREE(rowbuf);
+            return (PIX *)ERROR_PTR( "read error type 6", procName, pix);
+        }
+        for (j = 0, pel = rowbuf; j < w; j++, pel += 3) {
+            composeRGBPixel(pel[0], pel[1], pel[2], &rgbval);
             line[j] = rgbval;
         }
     }
+    FREE(rowbuf);
     return pix;
 }
 
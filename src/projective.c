@@ -437,10 +437,11 @@ pixProjectiveColor(PIX        *pixs,
                    l_float32  *vc,
                    l_uint32    colorval)
 {
-l_int32    i, j, w, h, d, wpls, wpld;
+l_int32    i, j, w, h, d, wpls, wpld, jmin, jmax;
 l_uint32   val;
 l_uint32  *datas, *datad, *lined;
 l_float32  x, y;
+l_float64  vr[6];
 PIX       *pixd;
 
     PROCNAME("pixProjectiveColor");
@@ -460,11 +461,23 @@ PIX       *pixd;
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
 
-        /* Iterate over destination pixels */
+        /* Iterate over destination rows.  Where the denominator of
+         * the transform is positive along the row, interpolate over
+         * the span of dest pixels that map inside pixs; otherwise,
+         * transform and test each pixel. */
     for (i = 0; i < h; i++) {
         lined = datad + i * wpld;
+        vr[0] = vc[1] * i + vc[2];
+        vr[1] = vc[0];
+        vr[2] = vc[4] * i + vc[5];
+        vr[3] = vc[3];
+        vr[4] = vc[7] * i + 1.0;
+        vr[5] = vc[6];
+        if (getXformRowSpan(vr, w, w, h, &jmin, &jmax) == 0) {
+            linearInterpolateRowColor(datas, wpls, lined, jmin, jmax, vr);
+            continue;
+        }
         for (j = 0; j < w; j++) {
-                /* Compute float src pixel location corresponding to (i,j) */
             projectiveXformPt(vc, j, i, &x, &y);
             linearInterpolatePixelColor(datas, wpls, w, h, x, y, colorval,
                                         &val);
@@ -532,9 +545,10 @@ pixProjectiveGray(PIX        *pixs,
                   l_float32  *vc,
                   l_uint8     grayval)
 {
-l_int32    i, j, w, h, wpls, wpld, val;
+l_int32    i, j, w, h, wpls, wpld, val, jmin, jmax;
 l_uint32  *datas, *datad, *lined;
 l_float32  x, y;
+l_float64  vr[6];
 PIX       *pixd;
 
     PROCNAME("pixProjectiveGray");
@@ -554,11 +568,23 @@ PIX       *pixd;
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
 
-        /* Iterate over destination pixels */
+        /* Iterate over destination rows.  Where the denominator of
+         * the transform is positive along the row, interpolate over
+         * the span of dest pixels that map inside pixs; otherwise,
+         * transform and test each pixel. */
     for (i = 0; i < h; i++) {
         lined = datad + i * wpld;
+        vr[0] = vc[1] * i + vc[2];
+        vr[1] = vc[0];
+        vr[2] = vc[4] * i + vc[5];
+        vr[3] = vc[3];
+        vr[4] = vc[7] * i + 1.0;
+        vr[5] = vc[6];
+        if (getXformRowSpan(vr, w, w, h, &jmin, &jmax) == 0) {
+            linearInterpolateRowGray(datas, wpls, lined, jmin, jmax, vr);
+            continue;
+        }
         for (j = 0; j < w; j++) {
-                /* Compute float src pixel location corresponding to (i,j) */
             projectiveXformPt(vc, j, i, &x, &y);
             linearInterpolatePixelGray(datas, wpls, w, h, x, y, grayval, &val);
             SET_DATA_BYTE(lined, j, val);
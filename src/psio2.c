@@ -47,6 +47,7 @@
  *          char                *generateJpegPS()
  *          L_COMPRESSED_DATA   *pixGenerateJpegData()
  *          L_COMPRESSED_DATA   *l_generateJpegData()
+ *          static L_COMPRESSED_DATA  *compressed_dataCreate()
  *          void                 compressed_dataDestroy()
  *
  *     For g4 fax compressed images (use ccitt g4 compression)
@@ -117,6 +118,9 @@ static const l_uint32  power85[5] = {1,
                                      85 * 85 * 85,
                                      85 * 85 * 85 * 85};
 
+static L_COMPRESSED_DATA *compressed_dataCreate(l_uint8 *datacomp,
+                                                size_t nbytescomp,
+                                                l_int32 ascii85flag);
 static l_int32  convertChunkToAscii85(l_uint8 *inarray, l_int32 insize,
                                       l_int32 *pindex, char *outbuf,
                                       l_int32 *pnbout);
@@ -1020,8 +1024,9 @@ pixGenerateJpegData(PIX     *pixs,
                     l_int32  ascii85flag,
                     l_int32  quality)
 {
-l_int32             d;
-char               *tname;
+l_uint8            *datacomp;
+l_int32             d, w, h, spp, xres, yres;
+size_t              nbytescomp;
 L_COMPRESSED_DATA  *cid;
 
     PROCNAME("pixGenerateJpegData");
@@ -1037,12 +1042,34 @@ L_COMPRESSED_DATA  *cid;
         return (L_COMPRESSED_DATA *)ERROR_PTR("pixs not 8 or 32 bpp",
                                               procName, NULL);
 
-        /* Compress to a temp jpeg file */
-    tname = genTempFilename("/tmp", "temp.jpg", 1, 1);
-    pixWriteJpeg(tname, pixs, quality, 0);
+        /* Compress to jpeg in memory */
+    if (pixWriteMemJpeg(&datacomp, &nbytescomp, pixs, quality, 0))
+        return (L_COMPRESSED_DATA *)ERROR_PTR("jpeg data not made",
+                                              procName, NULL);
+
+        /* Read the metadata by parsing the header */
+    if (extractJpegDataFromArray(datacomp, nbytescomp, &w, &h, NULL, &spp)) {
+        FREE(datacomp);
+        return (L_COMPRESSED_DATA *)ERROR_PTR("header not parsed",
+                                              procName, NULL);
+    }
+
+        /* The resolution is written to the jpeg header only if
+         * both xres and yres are defined */
+    xres = pixGetXRes(pixs);
+    yres = pixGetYRes(pixs);
+    if (xres == 0 || yres == 0)
+        xres = 0;
 
-    cid = l_generateJpegData(tname, ascii85flag);
-    FREE(tname);
+    if ((cid = compressed_dataCreate(datacomp, nbytescomp,
+                                     ascii85flag)) == NULL)
+        return (L_COMPRESSED_DATA *)ERROR_PTR("cid not made", procName, NULL);
+    cid->type = L_JPEG_ENCODE;
+    cid->w = w;
+    cid->h = h;
+    cid->bps = 8;
+    cid->spp = spp;
+    cid->res = xres;
     return cid;
 }
 
@@ -1064,9 +1091,7 @@ l_generateJpegData(const char  *fname,
                    l_int32      ascii85flag)
 {
 l_uint8            *datacomp = NULL;  /* entire jpeg compressed file */
-char               *data85 = NULL;  /* ascii85 encoded jpeg compressed file */
 l_int32             w, h, xres, yres, bps, spp;
-l_int32             nbytes85;
 size_t              nbytescomp;
 FILE               *fp;
 L_COMPRESSED_DATA  *cid;
@@ -1092,6 +1117,48 @@ L_COMPRESSED_DATA  *cid;
     fgetJpegResolution(fp, &xres, &yres);
     fclose(fp);
 
+    if ((cid = compressed_dataCreate(datacomp, nbytescomp,
+                                     ascii85flag)) == NULL)
+        return (L_COMPRESSED_DATA *)ERROR_PTR("cid not made", procName, NULL);
+    cid->type = L_JPEG_ENCODE;
+    cid->w = w;
+    cid->h = h;
+    cid->bps = bps;
+    cid->spp = spp;
+    cid->res = xres;
+    return cid;
+}
+
+
+/*!
+ *  compressed_dataCreate()
+ *
+ *      Input:  datacomp (compressed data; ownership is transferred)
+ *              nbytescomp (size of compressed data)
+ *              ascii85flag (0 for binary; 1 for ascii85-encoded)
+ *      Return: cid, or null on error
+ *
+ *  Notes:
+ *      (1) This holds the compressed data, optionally ascii85 encoded,
+ *          in a new cid.  The caller fills in the image parameters.
+ *      (2) @datacomp is always consumed: it is either saved in the
+ *          cid or freed.
+ */
+static L_COMPRESSED_DATA *
+compressed_dataCreate(l_uint8  *datacomp,
+                      size_t    nbytescomp,
+                      l_int32   ascii85flag)
+{
+char               *data85 = NULL;
+l_int32             nbytes85;
+L_COMPRESSED_DATA  *cid;
+
+    PROCNAME("compressed_dataCreate");
+
+    if (!datacomp)
+        return (L_COMPRESSED_DATA *)ERROR_PTR("datacomp not defined",
+                                              procName, NULL);
+
         /* Optionally, encode the compressed data */
     if (ascii85flag == 1) {
         data85 = encodeAscii85(datacomp, nbytescomp, &nbytes85);
@@ -1104,21 +1171,20 @@ L_COMPRESSED_DATA  *cid;
     }
 
     cid = (L_COMPRESSED_DATA *)CALLOC(1, sizeof(L_COMPRESSED_DATA));
-    if (!cid)
+    if (!cid) {
+        if (ascii85flag == 0)
+            FREE(datacomp);
+        else
+            FREE(data85);
         return (L_COMPRESSED_DATA *)ERROR_PTR("cid not made", procName, NULL);
+    }
     if (ascii85flag == 0)
         cid->datacomp = datacomp;
     else {  /* ascii85 */
         cid->data85 = data85;
         cid->nbytes85 = nbytes85;
     }
-    cid->type = L_JPEG_ENCODE;
     cid->nbytescomp = nbytescomp;
-    cid->w = w;
-    cid->h = h;
-    cid->bps = bps;
-    cid->spp = spp;
-    cid->res = xres;
     return cid;
 }
 
@@ -1560,7 +1626,9 @@ L_COMPRESSED_DATA *
 pixGenerateG4Data(PIX     *pixs,
                   l_int32  ascii85flag)
 {
-char               *tname;
+l_uint8            *tiffdata, *datacomp;
+l_int32             w, h, bps, spp, res, minisblack;
+size_t              tiffbytes, nbytescomp;
 L_COMPRESSED_DATA  *cid;
 
     PROCNAME("pixGenerateG4Data");
@@ -1572,12 +1640,30 @@ L_COMPRESSED_DATA  *cid;
         return (L_COMPRESSED_DATA *)ERROR_PTR("pixs not 1 bpp",
                                               procName, NULL);
 
-        /* Compress to a temp tiff g4 file */
-    tname = genTempFilename("/tmp", "temp.tif", 1, 1);
-    pixWrite(tname, pixs, IFF_TIFF_G4);
+        /* Compress to tiff g4 in memory */
+    if (pixWriteMemTiff(&tiffdata, &tiffbytes, pixs, IFF_TIFF_G4))
+        return (L_COMPRESSED_DATA *)ERROR_PTR("tiff data not made",
+                                              procName, NULL);
 
-    cid = l_generateG4Data(tname, ascii85flag);
-    FREE(tname);
+        /* Pull out the g4 data and the resolution */
+    if (extractG4DataFromArray(tiffdata, tiffbytes, &datacomp, &nbytescomp,
+                               &w, &h, &minisblack)) {
+        FREE(tiffdata);
+        return (L_COMPRESSED_DATA *)ERROR_PTR("datacomp not extracted",
+                                              procName, NULL);
+    }
+    readHeaderMemTiff(tiffdata, tiffbytes, 0, &w, &h, &bps, &spp,
+                      &res, NULL, NULL);
+    FREE(tiffdata);
+
+    if ((cid = compressed_dataCreate(datacomp, nbytescomp,
+                                     ascii85flag)) == NULL)
+        return (L_COMPRESSED_DATA *)ERROR_PTR("cid not made", procName, NULL);
+    cid->type = L_G4_ENCODE;
+    cid->w = w;
+    cid->h = h;
+    cid->minisblack = minisblack;
+    cid->res = res;
     return cid;
 }
 
@@ -1599,10 +1685,8 @@ l_generateG4Data(const char  *fname,
                  l_int32      ascii85flag)
 {
 l_uint8            *datacomp = NULL;  /* g4 compressed raster data */
-char               *data85 = NULL;  /* ascii85 encoded g4 compressed data */
 l_int32             w, h, xres, yres;
 l_int32             minisblack;  /* TRUE or FALSE */
-l_int32             nbytes85;
 size_t              nbytescomp;
 L_COMPRESSED_DATA  *cid;
 FILE               *fp;
@@ -1629,28 +1713,10 @@ FILE               *fp;
     getTiffResolution(fp, &xres, &yres);
     fclose(fp);
 
-        /* Optionally, encode the compressed data */
-    if (ascii85flag == 1) {
-        data85 = encodeAscii85(datacomp, nbytescomp, &nbytes85);
-        FREE(datacomp);
-        if (!data85)
-            return (L_COMPRESSED_DATA *)ERROR_PTR("data85 not made",
-                                                  procName, NULL);
-        else
-            data85[nbytes85 - 1] = '\0';  /* remove the newline */
-    }
-
-    cid = (L_COMPRESSED_DATA *)CALLOC(1, sizeof(L_COMPRESSED_DATA));
-    if (!cid)
+    if ((cid = compressed_dataCreate(datacomp, nbytescomp,
+                                     ascii85flag)) == NULL)
         return (L_COMPRESSED_DATA *)ERROR_PTR("cid not made", procName, NULL);
-    if (ascii85flag == 0)
-        cid->datacomp = datacomp;
-    else {  /* ascii85 */
-        cid->data85 = data85;
-        cid->nbytes85 = nbytes85;
-    }
     cid->type = L_G4_ENCODE;
-    cid->nbytescomp = nbytescomp;
     cid->w = w;
     cid->h = h;
     cid->minisblack = minisblack;
@@ -20,6 +20,7 @@
  *          PIX      *pixRankFilter()
  *          PIX      *pixRankFilterRGB()
  *          PIX      *pixRankFilterGray()
+ *          static PIX *pixRankFilterColumnHisto()
  *
  *      Median filter
  *          PIX      *pixMedianFilter()
@@ -89,13 +90,36 @@
  *        pixel, the average number of bins summed over, both in the
  *        coarse and fine histograms, is thus 16.
  *
- *  If someone has a better method, please let me know!
+ *    The cost of the incremental histogram update above is still
+ *    proportional to the smaller filter dimension.  For large filters
+ *    we can do better:
+ *
+ *      * Column histograms (Perreault and Hebert, "Median filtering
+ *        in constant time", IEEE Trans. Image Proc. 16(9), 2007).
+ *        Keep a (fine and coarse) histogram for each column of the
+ *        image, covering the hf rows of the filter.  Going down one
+ *        row costs one removal and one addition for each column.
+ *        Going to the right by one pixel, the filter histogram adds
+ *        the column histogram that enters and subtracts the one that
+ *        leaves.  This is done eagerly on the 16 coarse bins, and
+ *        lazily on the fine bins: a 16-bin segment of the fine filter
+ *        histogram is only brought up to date when the rank search
+ *        lands in it.  The work per pixel is then independent of
+ *        the filter size.  For 32 bpp rgb, the three components are
+ *        handled together in the same pass over the packed pixels.
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include "allheaders.h"
 
+static PIX *pixRankFilterColumnHisto(PIX *pixs, l_int32 wf, l_int32 hf,
+                                     l_float32 rank);
+
+    /* Use the constant-time column histogram method when the smaller
+     * of the filter dimensions is at least this large. */
+static const l_int32  MIN_SIZE_COLUMN_HISTO = 16;
+
 
 /*----------------------------------------------------------------------*
  *                           Rank order filter                          *
@@ -166,7 +190,13 @@ l_int32  d;
  *          pixels have a lower or equal value and
  *          (1-rank)*(wf*hf-1) pixels have an equal or greater value.
  *      (2) Apply gray rank filtering to each component independently.
- *      (3) See notes in pixRankFilterGray() for further details.
+ *      (3) For large filters, all three components are filtered in a
+ *          single pass over the packed rgb pixels, using the constant
+ *          time column histogram method.  Otherwise (and for rank
+ *          0.0 and 1.0, which are dispatched to grayscale morphology
+ *          if wf and hf are odd), the components are split out and
+ *          filtered separately.
+ *      (4) See notes in pixRankFilterGray() for further details.
  */
 PIX  *
 pixRankFilterRGB(PIX       *pixs,
@@ -189,6 +219,9 @@ PIX  *pixr, *pixg, *pixb, *pixrf, *pixgf, *pixbf, *pixd;
     if (wf == 1 && hf == 1)   /* no-op */
         return pixCopy(NULL, pixs);
 
+    if (L_MIN(wf, hf) >= MIN_SIZE_COLUMN_HISTO && rank > 0.0 && rank < 1.0)
+        return pixRankFilterColumnHisto(pixs, wf, hf, rank);
+
     pixr = pixGetRGBComponent(pixs, COLOR_RED);
     pixg = pixGetRGBComponent(pixs, COLOR_GREEN);
     pixb = pixGetRGBComponent(pixs, COLOR_BLUE);
@@ -233,6 +266,9 @@ PIX  *pixr, *pixg, *pixb, *pixrf, *pixgf, *pixbf, *pixd;
  *      (5) Returns a copy if both wf and hf are 1.
  *      (6) Uses row-major or column-major incremental updates to the
  *          histograms depending on whether hf > wf or hv <= wf, rsp.
+ *      (7) If both wf and hf are large, uses instead the column
+ *          histogram method, which gives identical results and
+ *          whose cost does not depend on the filter size.
  */
 PIX  *
 pixRankFilterGray(PIX       *pixs,
@@ -276,6 +312,9 @@ PIX       *pixt, *pixd;
     if (rank == 0.0) rank = 0.0001;
     if (rank == 1.0) rank = 0.9999;
 
+    if (L_MIN(wf, hf) >= MIN_SIZE_COLUMN_HISTO)
+        return pixRankFilterColumnHisto(pixs, wf, hf, rank);
+
         /* Add wf/2 to each side, and hf/2 to top and bottom of the
          * image, mirroring for accuracy and to avoid special-casing
          * the boundary. */
@@ -414,6 +453,211 @@ PIX       *pixt, *pixd;
 }
 
 
+/*!
+ *  pixRankFilterColumnHisto()
+ *
+ *      Input:  pixs (8 or 32 bpp; no colormap)
+ *              wf, hf  (width and height of filter; each is >= 1)
+ *              rank (in (0.0 ... 1.0))
+ *      Return: pixd (of rank values), or null on error
+ *
+ *  Notes:
+ *      (1) This is the constant-time rank filter, using a histogram
+ *          for each column; see the notes at the top of this file.
+ *          The results are identical to those of the incremental
+ *          method in pixRankFilterGray().
+ *      (2) For 32 bpp, the r, g and b components are filtered in a
+ *          single pass; the alpha component of pixd is 0, as in
+ *          pixCreateRGBImage().
+ *      (3) The column histograms use 16 bit counters, so hf must
+ *          be less than 65536.
+ */
+static PIX *
+pixRankFilterColumnHisto(PIX       *pixs,
+                         l_int32    wf,
+                         l_int32    hf,
+                         l_float32  rank)
+{
+l_int32    w, h, d, wt, ncomp, c, i, j, k, m, n, x, rankloc, wplt, wpld;
+l_int32    val, sum, first;
+l_int32    shift[3], outval[3];
+l_int32   *khisto, *khisto16, *kcol, *kh, *kh16;
+l_uint16  *chisto, *chisto16, *ch, *ch16, *chadd, *chsub;
+l_uint32  *datat, *linet, *lineadd, *linesub, *datad, *lined;
+PIX       *pixt, *pixd;
+
+    PROCNAME("pixRankFilterColumnHisto");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    pixGetDimensions(pixs, &w, &h, &d);
+    if (d != 8 && d != 32)
+        return (PIX *)ERROR_PTR("pixs not 8 or 32 bpp", procName, NULL);
+    if (hf > 0xffff)
+        return (PIX *)ERROR_PTR("hf too large", procName, NULL);
+
+    if ((pixt = pixAddMirroredBorder(pixs, wf / 2, wf / 2, hf / 2, hf / 2))
+        == NULL)
+        return (PIX *)ERROR_PTR("pixt not made", procName, NULL);
+    wt = pixGetWidth(pixt);
+    ncomp = (d == 8) ? 1 : 3;
+    shift[0] = L_RED_SHIFT;
+    shift[1] = L_GREEN_SHIFT;
+    shift[2] = L_BLUE_SHIFT;
+
+        /* Column histos are stored for each component, one after the
+         * other, with 256 (fine) or 16 (coarse) bins for each column.
+         * For the filter histos, kcol[] gives, for each segment of 16
+         * fine bins, the column at which it was last brought up to
+         * date; any value that is at least wf less than the current
+         * column forces the segment to be recomputed from scratch. */
+    chisto = (l_uint16 *)CALLOC(ncomp * wt * 256, sizeof(l_uint16));
+    chisto16 = (l_uint16 *)CALLOC(ncomp * wt * 16, sizeof(l_uint16));
+    khisto = (l_int32 *)CALLOC(ncomp * 256, sizeof(l_int32));
+    khisto16 = (l_int32 *)CALLOC(ncomp * 16, sizeof(l_int32));
+    kcol = (l_int32 *)CALLOC(ncomp * 16, sizeof(l_int32));
+    if (!chisto || !chisto16 || !khisto || !khisto16 || !kcol) {
+        pixd = (PIX *)ERROR_PTR("histos not made", procName, NULL);
+        goto cleanup;
+    }
+    rankloc = (l_int32)(rank * wf * hf);
+
+    pixd = pixCreateTemplate(pixs);
+    datat = pixGetData(pixt);
+    wplt = pixGetWpl(pixt);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    for (i = 0; i < h; i++) {
+            /* Move the column histos down to cover rows i ... i+hf-1 */
+        if (i == 0) {
+            for (k = 0; k < hf; k++) {
+                linet = datat + k * wplt;
+                for (c = 0; c < ncomp; c++) {
+                    ch = chisto + c * wt * 256;
+                    ch16 = chisto16 + c * wt * 16;
+                    for (x = 0; x < wt; x++) {
+                        if (d == 8)
+                            val = GET_DATA_BYTE(linet, x);
+                        else
+                            val = (linet[x] >> shift[c]) & 0xff;
+                        ch[x * 256 + val]++;
+                        ch16[x * 16 + (val >> 4)]++;
+                    }
+                }
+            }
+        } else {
+            linesub = datat + (i - 1) * wplt;
+            lineadd = datat + (i + hf - 1) * wplt;
+            for (c = 0; c < ncomp; c++) {
+                ch = chisto + c * wt * 256;
+                ch16 = chisto16 + c * wt * 16;
+                for (x = 0; x < wt; x++) {
+                    if (d == 8)
+                        val = GET_DATA_BYTE(linesub, x);
+                    else
+                        val = (linesub[x] >> shift[c]) & 0xff;
+                    ch[x * 256 + val]--;
+                    ch16[x * 16 + (val >> 4)]--;
+                    if (d == 8)
+                        val = GET_DATA_BYTE(lineadd, x);
+                    else
+                        val = (lineadd[x] >> shift[c]) & 0xff;
+                    ch[x * 256 + val]++;
+                    ch16[x * 16 + (val >> 4)]++;
+                }
+            }
+        }
+
+            /* Start the row with the coarse filter histos covering
+             * columns 0 ... wf-1, and all fine segments invalid. */
+        for (c = 0; c < ncomp; c++) {
+            kh16 = khisto16 + c * 16;
+            ch16 = chisto16 + c * wt * 16;
+            for (n = 0; n < 16; n++) {
+                kh16[n] = 0;
+                kcol[c * 16 + n] = -wf - 1;
+            }
+            for (x = 0; x < wf; x++) {
+                for (n = 0; n < 16; n++)
+                    kh16[n] += ch16[x * 16 + n];
+            }
+        }
+
+        lined = datad + i * wpld;
+        for (j = 0; j < w; j++) {
+            for (c = 0; c < ncomp; c++) {
+                kh = khisto + c * 256;
+                kh16 = khisto16 + c * 16;
+                ch = chisto + c * wt * 256;
+                ch16 = chisto16 + c * wt * 16;
+                if (j > 0) {  /* columns j-1 out, j+wf-1 in */
+                    chsub = ch16 + (j - 1) * 16;
+                    chadd = ch16 + (j + wf - 1) * 16;
+                    for (n = 0; n < 16; n++)
+                        kh16[n] += chadd[n] - chsub[n];
+                }
+
+                    /* Find the coarse bin with the rank value */
+                sum = 0;
+                for (n = 0; n < 16; n++) {
+                    sum += kh16[n];
+                    if (sum > rankloc) {
+                        sum -= kh16[n];
+                        break;
+                    }
+                }
+
+                    /* Bring that segment of the fine histo up to date */
+                first = 16 * n;
+                if (j - kcol[c * 16 + n] >= wf) {  /* recompute */
+                    for (m = 0; m < 16; m++)
+                        kh[first + m] = 0;
+                    for (x = j; x < j + wf; x++) {
+                        chadd = ch + x * 256 + first;
+                        for (m = 0; m < 16; m++)
+                            kh[first + m] += chadd[m];
+                    }
+                } else {  /* incremental */
+                    for (x = kcol[c * 16 + n] + 1; x <= j; x++) {
+                        chsub = ch + (x - 1) * 256 + first;
+                        chadd = ch + (x + wf - 1) * 256 + first;
+                        for (m = 0; m < 16; m++)
+                            kh[first + m] += chadd[m] - chsub[m];
+                    }
+                }
+                kcol[c * 16 + n] = j;
+
+                    /* Find the rank value in the fine segment */
+                k = first;
+                for (m = 0; m < 16; m++) {
+                    sum += kh[k];
+                    if (sum > rankloc)
+                        break;
+                    k++;
+                }
+                outval[c] = k;
+            }
+
+            if (d == 8)
+                SET_DATA_BYTE(lined, j, outval[0]);
+            else
+                lined[j] = (outval[0] << L_RED_SHIFT) |
+                           (outval[1] << L_GREEN_SHIFT) |
+                           (outval[2] << L_BLUE_SHIFT);
+        }
+    }
+
+cleanup:
+    pixDestroy(&pixt);
+    FREE(chisto);
+    FREE(chisto16);
+    FREE(khisto);
+    FREE(khisto16);
+    FREE(kcol);
+    return pixd;
+}
+
+
 /*----------------------------------------------------------------------*
  *                             Median filter                            *
  *----------------------------------------------------------------------*/
@@ -22,11 +22,14 @@
  *           PIXA      *pixaReadFilesSA()
  *           PIX       *pixRead()
  *           PIX       *pixReadWithHint()
+ *           PIX       *pixReadMapped()
+ *           PIX       *pixReadReduced()
  *           PIX       *pixReadIndexed()
  *           PIX       *pixReadStream()
  *
  *      Read header information from file
  *           l_int32    pixReadHeader()
+ *           l_int32    pixReadHeadersSA()
  *
  *      Format finders
  *           l_int32    findFileFormat()
@@ -150,12 +153,17 @@ PIXA    *pixa;
  *
  *      Input:  filename (with full pathname or in local directory)
  *      Return: pix if OK; null on error
+ *
+ *  Notes:
+ *      (1) Serialized pix (spix) are read with pixReadMapped(), which
+ *          copies the raster data once, straight from the mapped file.
  */
 PIX *
 pixRead(const char  *filename)
 {
-FILE  *fp;
-PIX   *pix;
+l_int32  format;
+FILE    *fp;
+PIX     *pix;
 
     PROCNAME("pixRead");
 
@@ -164,6 +172,16 @@ PIX   *pix;
 
     if ((fp = fopenReadStream(filename)) == NULL)
         return (PIX *)ERROR_PTR("image file not found", procName, NULL);
+
+        /* Serialized pix are decoded directly from the mapped file */
+    findFileFormatStream(fp, &format);
+    if (format == IFF_SPIX) {
+        fclose(fp);
+        if ((pix = pixReadMapped(filename)) == NULL)
+            return (PIX *)ERROR_PTR("pix not read", procName, NULL);
+        return pix;
+    }
+
     if ((pix = pixReadStream(fp, 0)) == NULL) {
         fclose(fp);
         return (PIX *)ERROR_PTR("pix not read", procName, NULL);
@@ -216,6 +234,126 @@ PIX   *pix;
 }
 
 
+/*!
+ *  pixReadMapped()
+ *
+ *      Input:  filename (with full pathname or in local directory)
+ *      Return: pix if OK; null on error
+ *
+ *  Notes:
+ *      (1) This maps the file into memory with l_binaryMapFile() and
+ *          decodes it with pixReadMem(), so no intermediate buffer is
+ *          allocated and the file is not read through a stream.
+ *      (2) This is most useful for uncompressed spix files, where
+ *          decoding is a single copy of the raster data.  It can be
+ *          used for any format that pixReadMem() can read; see the
+ *          notes there for restrictions.
+ */
+PIX *
+pixReadMapped(const char  *filename)
+{
+l_uint8  *data;
+size_t    size;
+PIX      *pix;
+
+    PROCNAME("pixReadMapped");
+
+    if (!filename)
+        return (PIX *)ERROR_PTR("filename not defined", procName, NULL);
+
+    if ((data = l_binaryMapFile(filename, &size)) == NULL)
+        return (PIX *)ERROR_PTR("image file not mapped", procName, NULL);
+    pix = pixReadMem(data, size);
+    l_binaryUnmapFile(data, size);
+
+    if (!pix)
+        return (PIX *)ERROR_PTR("pix not read", procName, NULL);
+    return pix;
+}
+
+
+/*!
+ *  pixReadReduced()
+ *
+ *      Input:  filename (with full pathname or in local directory)
+ *              reduction (scaling factor: 1, 2, 4 or 8)
+ *      Return: pix if OK; null on error
+ *
+ *  Notes:
+ *      (1) This reads the image at a resolution reduced by @reduction
+ *          in each direction.  It is intended for making thumbnails
+ *          and for analysis at low resolution, where decoding the full
+ *          image only to reduce it wastes time and memory.
+ *      (2) For jpeg, the reduction is done by the decoder in the DCT
+ *          domain.  The output size is rounded up, so it can differ
+ *          from w/reduction and h/reduction by one pixel.
+ *      (3) For png and tiff, bands of @reduction rows are decoded and
+ *          reduced one at a time, and the full resolution image is
+ *          never made; see pixReadStreamPngReduced() and
+ *          pixReadStreamTiffReduced().  The result is the same as
+ *          pixScaleByIntReduction() applied to the image from pixRead().
+ *      (4) Other formats are decoded in full and then reduced with
+ *          pixScaleByIntReduction().
+ *      (5) As with pixScaleByIntReduction(), 1 bpp images are returned
+ *          as 8 bpp gray, and colormaps are removed.
+ */
+PIX *
+pixReadReduced(const char  *filename,
+               l_int32      reduction)
+{
+l_int32  format;
+FILE    *fp;
+PIX     *pixt, *pix;
+
+    PROCNAME("pixReadReduced");
+
+    if (!filename)
+        return (PIX *)ERROR_PTR("filename not defined", procName, NULL);
+    if (reduction != 1 && reduction != 2 && reduction != 4 && reduction != 8)
+        return (PIX *)ERROR_PTR("reduction not in {1,2,4,8}", procName, NULL);
+    if (reduction == 1)
+        return pixRead(filename);
+
+    if ((fp = fopenReadStream(filename)) == NULL)
+        return (PIX *)ERROR_PTR("image file not found", procName, NULL);
+    findFileFormatStream(fp, &format);
+    switch (format)
+    {
+    case IFF_JFIF_JPEG:
+        pix = pixReadStreamJpeg(fp, READ_24_BIT_COLOR, reduction, NULL, 0);
+        break;
+
+    case IFF_PNG:
+        pix = pixReadStreamPngReduced(fp, reduction);
+        break;
+
+    case IFF_TIFF:
+    case IFF_TIFF_PACKBITS:
+    case IFF_TIFF_RLE:
+    case IFF_TIFF_G3:
+    case IFF_TIFF_G4:
+    case IFF_TIFF_LZW:
+    case IFF_TIFF_ZIP:
+        pix = pixReadStreamTiffReduced(fp, 0, reduction);
+        break;
+
+    default:
+        pix = NULL;
+        if ((pixt = pixReadStream(fp, 0)) != NULL) {
+            pix = pixScaleByIntReduction(pixt, reduction);
+            pixDestroy(&pixt);
+        }
+        break;
+    }
+    fclose(fp);
+
+    if (!pix)
+        return (PIX *)ERROR_PTR("pix not read", procName, NULL);
+    pixSetInputFormat(pix, format);
+    return pix;
+}
+
+
 /*!
  *  pixReadIndexed()
  *
@@ -376,9 +514,9 @@ PIX     *pix;
  *      Return: 0 if OK, 1 on error
  *
  *  Notes:
- *      (1) This reads the actual headers for jpeg, png, tiff and pnm.
- *          For bmp and gif, we cheat and read the entire file into a pix,
- *          from which we extract the "header" information.
+ *      (1) This reads the actual headers for all formats.  For bmp and
+ *          gif, the header is parsed from the mapped file, so no image
+ *          data is decoded.
  */
 l_int32
 pixReadHeader(const char  *filename,
@@ -389,10 +527,11 @@ pixReadHeader(const char  *filename,
               l_int32     *pspp,
               l_int32     *piscmap)
 {
-l_int32  format, ret, w, h, d, bps, spp, iscmap;
-l_int32  type;  /* ignored */
-FILE    *fp;
-PIX     *pix;
+l_int32   format, ret, w, h, d, bps, spp, iscmap;
+l_int32   type;  /* ignored */
+l_uint8  *data;
+size_t    size;
+FILE     *fp;
 
     PROCNAME("pixReadHeader");
 
@@ -413,13 +552,13 @@ PIX     *pix;
 
     switch (format)
     {
-    case IFF_BMP:  /* cheating: reading the entire file */
-        if ((pix = pixRead(filename)) == NULL)
-            return ERROR_INT( "bmp: pix not read", procName, 1);
-        pixGetDimensions(pix, &w, &h, &d);
-        pixDestroy(&pix);
-        bps = (d == 32) ? 8 : d;
-        spp = (d == 32) ? 3 : 1;
+    case IFF_BMP:  /* parse the header from the mapped file */
+        if ((data = l_binaryMapFile(filename, &size)) == NULL)
+            return ERROR_INT( "bmp: file not mapped", procName, 1);
+        ret = sreadHeaderBmp(data, size, &w, &h, &bps, &spp, &iscmap);
+        l_binaryUnmapFile(data, size);
+        if (ret)
+            return ERROR_INT( "bmp: no header info returned", procName, 1);
         break;
 
     case IFF_JFIF_JPEG:
@@ -455,14 +594,13 @@ PIX     *pix;
             return ERROR_INT( "pnm: no header info returned", procName, 1);
         break;
 
-    case IFF_GIF:  /* cheating: reading the entire file */
-        if ((pix = pixRead(filename)) == NULL)
-            return ERROR_INT( "gif: pix not read", procName, 1);
-        pixGetDimensions(pix, &w, &h, &d);
-        pixDestroy(&pix);
-        iscmap = 1;  /* always colormapped; max 256 colors */
-        spp = 1;
-        bps = d;
+    case IFF_GIF:  /* parse the header from the mapped file */
+        if ((data = l_binaryMapFile(filename, &size)) == NULL)
+            return ERROR_INT( "gif: file not mapped", procName, 1);
+        ret = sreadHeaderGif(data, size, &w, &h, &bps, &spp, &iscmap);
+        l_binaryUnmapFile(data, size);
+        if (ret)
+            return ERROR_INT( "gif: no header info returned", procName, 1);
         break;
 
     case IFF_JP2:
@@ -499,6 +637,110 @@ PIX     *pix;
 }
 
 
+/*!
+ *  pixReadHeadersSA()
+ *
+ *      Input:  sa (of full pathnames)
+ *              &naformat (<optional return> file formats)
+ *              &naw, &nah (<optional returns> widths and heights)
+ *              &nabps (<optional return> bits/sample)
+ *              &naspp (<optional return> samples/pixel)
+ *              &naiscmap (<optional return> 1 if cmap exists; 0 otherwise)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This reads the header of each file in @sa, for indexing
+ *          large numbers of images.  Each file is mapped and its header
+ *          is parsed with pixReadHeaderMem(), which only touches the
+ *          pages holding the header and does not open a stream or
+ *          decode any image data.
+ *      (2) Each returned numa has one entry for each file.  A file
+ *          whose header cannot be read is reported with format
+ *          IFF_UNKNOWN and 0 for the other values; this is not an error.
+ *      (3) On windows, mapping reads each file into memory, and the
+ *          pnm headers cannot be read; use pixReadHeader() instead.
+ */
+l_int32
+pixReadHeadersSA(SARRAY  *sa,
+                 NUMA   **pnaformat,
+                 NUMA   **pnaw,
+                 NUMA   **pnah,
+                 NUMA   **pnabps,
+                 NUMA   **pnaspp,
+                 NUMA   **pnaiscmap)
+{
+char     *fname;
+l_int32   i, n, format, w, h, bps, spp, iscmap;
+l_uint8  *data;
+size_t    size;
+NUMA     *naformat, *naw, *nah, *nabps, *naspp, *naiscmap;
+
+    PROCNAME("pixReadHeadersSA");
+
+    if (pnaformat) *pnaformat = NULL;
+    if (pnaw) *pnaw = NULL;
+    if (pnah) *pnah = NULL;
+    if (pnabps) *pnabps = NULL;
+    if (pnaspp) *pnaspp = NULL;
+    if (pnaiscmap) *pnaiscmap = NULL;
+    if (!sa)
+        return ERROR_INT("sa not defined", procName, 1);
+
+    n = sarrayGetCount(sa);
+    naformat = numaCreate(n);
+    naw = numaCreate(n);
+    nah = numaCreate(n);
+    nabps = numaCreate(n);
+    naspp = numaCreate(n);
+    naiscmap = numaCreate(n);
+    for (i = 0; i < n; i++) {
+        fname = sarrayGetString(sa, i, L_NOCOPY);
+        format = IFF_UNKNOWN;
+        w = h = bps = spp = iscmap = 0;
+        if ((data = l_binaryMapFile(fname, &size)) != NULL) {
+            if (size < 8 || pixReadHeaderMem(data, size, &format, &w, &h,
+                                             &bps, &spp, &iscmap)) {
+                L_ERROR_STRING("header not read for %s", procName, fname);
+                format = IFF_UNKNOWN;
+            }
+            l_binaryUnmapFile(data, size);
+        }
+        numaAddNumber(naformat, format);
+        numaAddNumber(naw, w);
+        numaAddNumber(nah, h);
+        numaAddNumber(nabps, bps);
+        numaAddNumber(naspp, spp);
+        numaAddNumber(naiscmap, iscmap);
+    }
+
+    if (pnaformat)
+        *pnaformat = naformat;
+    else
+        numaDestroy(&naformat);
+    if (pnaw)
+        *pnaw = naw;
+    else
+        numaDestroy(&naw);
+    if (pnah)
+        *pnah = nah;
+    else
+        numaDestroy(&nah);
+    if (pnabps)
+        *pnabps = nabps;
+    else
+        numaDestroy(&nabps);
+    if (pnaspp)
+        *pnaspp = naspp;
+    else
+        numaDestroy(&naspp);
+    if (pnaiscmap)
+        *pnaiscmap = naiscmap;
+    else
+        numaDestroy(&naiscmap);
+    return 0;
+}
+
+
 /*---------------------------------------------------------------------*
  *                            Format finders                           *
  *---------------------------------------------------------------------*/
@@ -836,9 +1078,8 @@ PIX     *pix;
  *      Return: 0 if OK, 1 on error
  *
  *  Notes:
- *      (1) This reads the actual headers for jpeg, png, tiff and pnm.
- *          For bmp and gif, we cheat and read all the data into a pix,
- *          from which we extract the "header" information.
+ *      (1) This reads the actual headers for all formats, without
+ *          decoding any image data.
  *      (2) On windows, this will only read tiff formatted files from
  *          memory.  For other formats, it requires fmemopen(3).
  *          Attempts to read those formats will fail at runtime.
@@ -857,7 +1098,6 @@ pixReadHeaderMem(const l_uint8  *data,
 {
 l_int32  format, ret, w, h, d, bps, spp, iscmap;
 l_int32  type;  /* not used */
-PIX     *pix;
 
     PROCNAME("pixReadHeaderMem");
 
@@ -877,13 +1117,10 @@ PIX     *pix;
 
     switch (format)
     {
-    case IFF_BMP:  /* cheating: read the pix */
-        if ((pix = pixReadMemBmp(data, size)) == NULL)
-            return ERROR_INT( "bmp: pix not read", procName, 1);
-        pixGetDimensions(pix, &w, &h, &d);
-        pixDestroy(&pix);
-        bps = (d == 32) ? 8 : d;
-        spp = (d == 32) ? 3 : 1;
+    case IFF_BMP:
+        ret = sreadHeaderBmp(data, size, &w, &h, &bps, &spp, &iscmap);
+        if (ret)
+            return ERROR_INT( "bmp: no header info returned", procName, 1);
         break;
 
     case IFF_JFIF_JPEG:
@@ -919,14 +1156,10 @@ PIX     *pix;
             return ERROR_INT( "pnm: no header info returned", procName, 1);
         break;
 
-    case IFF_GIF:  /* cheating: read the pix */
-        if ((pix = pixReadMemGif(data, size)) == NULL)
-            return ERROR_INT( "gif: pix not read", procName, 1);
-        pixGetDimensions(pix, &w, &h, &d);
-        pixDestroy(&pix);
-        iscmap = 1;  /* always colormapped; max 256 colors */
-        spp = 1;
-        bps = d;
+    case IFF_GIF:
+        ret = sreadHeaderGif(data, size, &w, &h, &bps, &spp, &iscmap);
+        if (ret)
+            return ERROR_INT( "gif: no header info returned", procName, 1);
         break;
 
     case IFF_JP2:
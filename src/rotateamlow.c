@@ -45,6 +45,24 @@
 /*------------------------------------------------------------------*
  *             32 bpp grayscale rotation about the center           *
  *------------------------------------------------------------------*/
+/*!
+ *  rotateAMColorLow()
+ *
+ *  Notes:
+ *      (1) The source coordinates, in units of 1/16 pixel, are
+ *              xpm = -xdif * cosa - ydif * sina
+ *              ypm = -ydif * cosa + xdif * sina
+ *          The terms that depend only on the column are computed once
+ *          for the image, and the terms that depend only on the row are
+ *          computed once for each row, so that each pixel requires just
+ *          two additions.  The results are the same as evaluating the
+ *          full expressions for each pixel.
+ *      (2) Both coordinates are monotonic along a row, so the dest
+ *          pixels whose source is within the image form a single
+ *          span.  The pixels outside the span are set to colorval
+ *          while searching in from each end, and the pixels within
+ *          the span are interpolated without further bounds checks.
+ */
 void
 rotateAMColorLow(l_uint32  *datad,
                  l_int32    w,
@@ -55,12 +73,15 @@ rotateAMColorLow(l_uint32  *datad,
                  l_float32  angle,
                  l_uint32   colorval)
 {
-l_int32    i, j, xcen, ycen, wm2, hm2;
-l_int32    xdif, ydif, xpm, ypm, xp, yp, xf, yf;
-l_int32    rval, gval, bval;
-l_uint32   word00, word01, word10, word11;
-l_uint32  *lines, *lined;
-l_float32  sina, cosa;
+l_int32     i, j, jmin, jmax, xcen, ycen, wm2, hm2;
+l_int32     xdif, ydif, xpm, ypm, xp, yp, xf, yf;
+l_int32     rval, gval, bval;
+l_uint32    word00, word01, word10, word11;
+l_uint32   *lines, *lined;
+l_float32   sina, cosa, ysina, ycosa;
+l_float32  *xcosa, *xsina;
+
+    PROCNAME("rotateAMColorLow");
 
     xcen = w / 2;
     wm2 = w - 2;
@@ -69,24 +90,50 @@ l_float32  sina, cosa;
     sina = 16. * sin(angle);
     cosa = 16. * cos(angle);
 
+    xcosa = (l_float32 *)CALLOC(w, sizeof(l_float32));
+    xsina = (l_float32 *)CALLOC(w, sizeof(l_float32));
+    if (!xcosa || !xsina) {
+        L_ERROR("xcosa or xsina not made", procName);
+        FREE(xcosa);
+        FREE(xsina);
+        return;
+    }
+    for (j = 0; j < w; j++) {
+        xdif = xcen - j;
+        xcosa[j] = -xdif * cosa;
+        xsina[j] = xdif * sina;
+    }
+
     for (i = 0; i < h; i++) {
         ydif = ycen - i;
+        ysina = ydif * sina;
+        ycosa = -ydif * cosa;
         lined = datad + i * wpld;
-        for (j = 0; j < w; j++) {
-            xdif = xcen - j;
-            xpm = (l_int32)(-xdif * cosa - ydif * sina);
-            ypm = (l_int32)(-ydif * cosa + xdif * sina);
+
+            /* Find the span of dest pixels with source in the image;
+             * if off the edge, write input colorval */
+        for (jmin = 0; jmin < w; jmin++) {
+            xp = xcen + ((l_int32)(xcosa[jmin] - ysina) >> 4);
+            yp = ycen + ((l_int32)(ycosa + xsina[jmin]) >> 4);
+            if (xp >= 0 && yp >= 0 && xp <= wm2 && yp <= hm2)
+                break;
+            *(lined + jmin) = colorval;
+        }
+        for (jmax = w - 1; jmax > jmin; jmax--) {
+            xp = xcen + ((l_int32)(xcosa[jmax] - ysina) >> 4);
+            yp = ycen + ((l_int32)(ycosa + xsina[jmax]) >> 4);
+            if (xp >= 0 && yp >= 0 && xp <= wm2 && yp <= hm2)
+                break;
+            *(lined + jmax) = colorval;
+        }
+
+        for (j = jmin; j <= jmax; j++) {
+            xpm = (l_int32)(xcosa[j] - ysina);
+            ypm = (l_int32)(ycosa + xsina[j]);
             xp = xcen + (xpm >> 4);
             yp = ycen + (ypm >> 4);
             xf = xpm & 0x0f;
             yf = ypm & 0x0f;
-
-                /* if off the edge, write input colorval */
-            if (xp < 0 || yp < 0 || xp > wm2 || yp > hm2) {
-                *(lined + j) = colorval;
-                continue;
-            }
-
             lines = datas + yp * wpls;
 
                 /* do area weighting.  Without this, we would
@@ -110,10 +157,13 @@ l_float32  sina, cosa;
                     xf * (16 - yf) * ((word10 >> L_BLUE_SHIFT) & 0xff) +
                     (16 - xf) * yf * ((word01 >> L_BLUE_SHIFT) & 0xff) +
                     xf * yf * ((word11 >> L_BLUE_SHIFT) & 0xff) + 128) / 256;
-            composeRGBPixel(rval, gval, bval, lined + j);
+            *(lined + j) = (rval << L_RED_SHIFT) | (gval << L_GREEN_SHIFT) |
+                           (bval << L_BLUE_SHIFT);
         }
     }
 
+    FREE(xcosa);
+    FREE(xsina);
     return;
 }
 
@@ -121,6 +171,13 @@ l_float32  sina, cosa;
 /*------------------------------------------------------------------*
  *             8 bpp grayscale rotation about the center            *
  *------------------------------------------------------------------*/
+/*!
+ *  rotateAMGrayLow()
+ *
+ *  Notes:
+ *      (1) See rotateAMColorLow() for the computation of the source
+ *          coordinates and of the span in each row.
+ */
 void
 rotateAMGrayLow(l_uint32  *datad,
                 l_int32    w,
@@ -131,12 +188,15 @@ rotateAMGrayLow(l_uint32  *datad,
                 l_float32  angle,
                 l_uint8    grayval)
 {
-l_int32    i, j, xcen, ycen, wm2, hm2;
-l_int32    xdif, ydif, xpm, ypm, xp, yp, xf, yf;
-l_int32    v00, v01, v10, v11;
-l_uint8    val;
-l_uint32  *lines, *lined;
-l_float32  sina, cosa;
+l_int32     i, j, jmin, jmax, xcen, ycen, wm2, hm2;
+l_int32     xdif, ydif, xpm, ypm, xp, yp, xf, yf;
+l_int32     v00, v01, v10, v11;
+l_uint8     val;
+l_uint32   *lines, *lined;
+l_float32   sina, cosa, ysina, ycosa;
+l_float32  *xcosa, *xsina;
+
+    PROCNAME("rotateAMGrayLow");
 
     xcen = w / 2;
     wm2 = w - 2;
@@ -145,24 +205,50 @@ l_float32  sina, cosa;
     sina = 16. * sin(angle);
     cosa = 16. * cos(angle);
 
+    xcosa = (l_float32 *)CALLOC(w, sizeof(l_float32));
+    xsina = (l_float32 *)CALLOC(w, sizeof(l_float32));
+    if (!xcosa || !xsina) {
+        L_ERROR("xcosa or xsina not made", procName);
+        FREE(xcosa);
+        FREE(xsina);
+        return;
+    }
+    for (j = 0; j < w; j++) {
+        xdif = xcen - j;
+        xcosa[j] = -xdif * cosa;
+        xsina[j] = xdif * sina;
+    }
+
     for (i = 0; i < h; i++) {
         ydif = ycen - i;
+        ysina = ydif * sina;
+        ycosa = -ydif * cosa;
         lined = datad + i * wpld;
-        for (j = 0; j < w; j++) {
-            xdif = xcen - j;
-            xpm = (l_int32)(-xdif * cosa - ydif * sina);
-            ypm = (l_int32)(-ydif * cosa + xdif * sina);
+
+            /* Find the span of dest pixels with source in the image;
+             * if off the edge, write input grayval */
+        for (jmin = 0; jmin < w; jmin++) {
+            xp = xcen + ((l_int32)(xcosa[jmin] - ysina) >> 4);
+            yp = ycen + ((l_int32)(ycosa + xsina[jmin]) >> 4);
+            if (xp >= 0 && yp >= 0 && xp <= wm2 && yp <= hm2)
+                break;
+            SET_DATA_BYTE(lined, jmin, grayval);
+        }
+        for (jmax = w - 1; jmax > jmin; jmax--) {
+            xp = xcen + ((l_int32)(xcosa[jmax] - ysina) >> 4);
+            yp = ycen + ((l_int32)(ycosa + xsina[jmax]) >> 4);
+            if (xp >= 0 && yp >= 0 && xp <= wm2 && yp <= hm2)
+                break;
+            SET_DATA_BYTE(lined, jmax, grayval);
+        }
+
+        for (j = jmin; j <= jmax; j++) {
+            xpm = (l_int32)(xcosa[j] - ysina);
+            ypm = (l_int32)(ycosa + xsina[j]);
             xp = xcen + (xpm >> 4);
             yp = ycen + (ypm >> 4);
             xf = xpm & 0x0f;
             yf = ypm & 0x0f;
-
-                /* if off the edge, write input grayval */
-            if (xp < 0 || yp < 0 || xp > wm2 || yp > hm2) {
-                SET_DATA_BYTE(lined, j, grayval);
-                continue;
-            }
-
             lines = datas + yp * wpls;
 
                 /* do area weighting.  Without this, we would
@@ -179,6 +265,8 @@ l_float32  sina, cosa;
         }
     }
 
+    FREE(xcosa);
+    FREE(xsina);
     return;
 }
 
@@ -19,6 +19,10 @@
  *
  *      90-degree rotation (cw)
  *            void      rotate90Low()
+ *            static void  rotate90Low1()
+ *            static void  rotate90Low8()
+ *            static void  rotate90Low32()
+ *            static void  transposeBits32()
  *
  *      LR-flip
  *            void      flipLRLow()
@@ -37,6 +41,20 @@
 #include <string.h>
 #include "allheaders.h"
 
+    /* Size of the square blocks of pixels that are rotated together */
+static const l_int32  ROTATE_BLOCK_SIZE = 32;
+
+static void rotate90Low1(l_uint32 *datad, l_int32 wd, l_int32 hd,
+                         l_int32 wpld, l_uint32 *datas, l_int32 wpls,
+                         l_int32 direction);
+static void rotate90Low8(l_uint32 *datad, l_int32 wd, l_int32 hd,
+                         l_int32 wpld, l_uint32 *datas, l_int32 wpls,
+                         l_int32 direction);
+static void rotate90Low32(l_uint32 *datad, l_int32 wd, l_int32 hd,
+                          l_int32 wpld, l_uint32 *datas, l_int32 wpls,
+                          l_int32 direction);
+static void transposeBits32(l_uint32 *a);
+
 
 
 /*------------------------------------------------------------------*
@@ -51,6 +69,10 @@
  *  Notes:
  *      (1) The dest must be cleared in advance because not
  *          all source pixels are written to the destination.
+ *      (2) For 1, 8 and 32 bpp, the rotation is done on square blocks
+ *          of pixels, so that neither the reads from the source nor
+ *          the writes to the dest go down a full column of the image.
+ *          See rotate90Low1(), rotate90Low8() and rotate90Low32().
  */
 void
 rotate90Low(l_uint32  *datad,
@@ -68,6 +90,19 @@ l_uint32  *lines, *lined;
 
     PROCNAME("rotate90Low");
 
+    if (d == 1) {
+        rotate90Low1(datad, wd, hd, wpld, datas, wpls, direction);
+        return;
+    }
+    else if (d == 8) {
+        rotate90Low8(datad, wd, hd, wpld, datas, wpls, direction);
+        return;
+    }
+    else if (d == 32) {
+        rotate90Low32(datad, wd, hd, wpld, datas, wpls, direction);
+        return;
+    }
+
     if (direction == 1) {  /* clockwise */
         switch (d)
         {
@@ -249,6 +284,254 @@ l_uint32  *lines, *lined;
 }
 
 
+/*!
+ *  rotate90Low1()
+ *
+ *      Input:  datad, wd, hd, wpld (1 bpp dest)
+ *              datas, wpls (1 bpp src)
+ *              direction (1 for cw, -1 for ccw)
+ *      Return: void
+ *
+ *  Notes:
+ *      (1) Each 32 x 32 block of bits is made from one word in each
+ *          of 32 consecutive src lines, and is transposed in registers
+ *          with transposeBits32().  The transposed block is then
+ *          written as one word in each of 32 consecutive dest lines.
+ *      (2) For cw rotation, dest pixel (i, j) is src pixel
+ *          (wd - 1 - j, i).  The src lines are loaded in reverse order,
+ *          so that the bits of each transposed word are in dest order.
+ *          For ccw rotation, dest pixel (i, j) is src pixel (j, hd - 1 - i).
+ *      (3) Blocks that are entirely 0 are skipped, because the dest
+ *          is already cleared.
+ */
+static void
+rotate90Low1(l_uint32  *datad,
+             l_int32    wd,
+             l_int32    hd,
+             l_int32    wpld,
+             l_uint32  *datas,
+             l_int32    wpls,
+             l_int32    direction)
+{
+l_int32    i, k, m, q, nwd, nws, row, nonzero;
+l_uint32   a[32];
+l_uint32  *lines[32];
+
+    nwd = (wd + 31) / 32;  /* dest words that are used in each line */
+    nws = (hd + 31) / 32;  /* src words that are used in each line */
+    for (q = 0; q < nwd; q++) {
+            /* Src lines for the bits in dest word q; null if beyond
+             * the image */
+        for (m = 0; m < 32; m++) {
+            if (direction == 1)
+                row = wd - 1 - 32 * q - m;
+            else
+                row = 32 * q + m;
+            lines[m] = (row >= 0 && row < wd) ? datas + row * wpls : NULL;
+        }
+
+        for (k = 0; k < nws; k++) {
+            nonzero = 0;
+            for (m = 0; m < 32; m++) {
+                a[m] = (lines[m]) ? lines[m][k] : 0;
+                nonzero |= (a[m] != 0);
+            }
+            if (!nonzero)
+                continue;
+            transposeBits32(a);
+
+                /* Transposed word m goes to dest line for src column
+                 * 32 * k + m, if that column is in the image */
+            for (m = 0; m < 32; m++) {
+                i = 32 * k + m;
+                if (i >= hd)
+                    break;
+                if (direction == 1)
+                    datad[i * wpld + q] = a[m];
+                else
+                    datad[(hd - 1 - i) * wpld + q] = a[m];
+            }
+        }
+    }
+
+    return;
+}
+
+
+/*!
+ *  transposeBits32()
+ *
+ *      Input:  a (array of 32 words, each a row of a 32 x 32 bit matrix)
+ *      Return: void
+ *
+ *  Notes:
+ *      (1) This transposes the bit matrix in place, where bit j of
+ *          row i is the j-th bit from the MSB of a[i], as with the
+ *          pixel order in a 1 bpp raster line.
+ *      (2) Blocks of size 16, 8, 4, 2 and 1 on the diagonal are swapped
+ *          in turn, using masks.  See "Hacker's Delight", section 7.3.
+ */
+static void
+transposeBits32(l_uint32  *a)
+{
+l_int32   j, k;
+l_uint32  m, t;
+
+    m = 0x0000ffff;
+    for (j = 16; j != 0; j = j >> 1, m = m ^ (m << j)) {
+        for (k = 0; k < 32; k = (k + j + 1) & ~j) {
+            t = (a[k] ^ (a[k + j] >> j)) & m;
+            a[k] = a[k] ^ t;
+            a[k + j] = a[k + j] ^ (t << j);
+        }
+    }
+    return;
+}
+
+
+/*!
+ *  rotate90Low8()
+ *
+ *      Input:  datad, wd, hd, wpld (8 bpp dest)
+ *              datas, wpls (8 bpp src)
+ *              direction (1 for cw, -1 for ccw)
+ *      Return: void
+ *
+ *  Notes:
+ *      (1) The dest is covered by blocks of ROTATE_BLOCK_SIZE lines.
+ *          Within a block, each group of 4 x 4 pixels is rotated by
+ *          reading one word from each of 4 src lines and assembling
+ *          one word for each of 4 dest lines.
+ *      (2) Pixels at the right and bottom edges of the dest that are not
+ *          in a full group of 4 x 4 are rotated one at a time.
+ */
+static void
+rotate90Low8(l_uint32  *datad,
+             l_int32    wd,
+             l_int32    hd,
+             l_int32    wpld,
+             l_uint32  *datas,
+             l_int32    wpls,
+             l_int32    direction)
+{
+l_int32    i, j, ib, iend, q, nqd, nks, c, sh;
+l_uint32   a0, a1, a2, a3, val;
+l_uint32  *lines;
+
+    nqd = wd / 4;  /* full dest words */
+    nks = hd / 4;  /* full src words */
+    for (ib = 0; ib < 4 * nks; ib += ROTATE_BLOCK_SIZE) {
+        iend = L_MIN(ib + ROTATE_BLOCK_SIZE, 4 * nks);
+        for (q = 0; q < nqd; q++) {
+            if (direction == 1) {
+                lines = datas + (wd - 1 - 4 * q) * wpls;
+                for (i = ib; i < iend; i += 4) {
+                    a0 = lines[i / 4];
+                    a1 = lines[i / 4 - wpls];
+                    a2 = lines[i / 4 - 2 * wpls];
+                    a3 = lines[i / 4 - 3 * wpls];
+                    for (c = 0; c < 4; c++) {
+                        sh = 24 - 8 * c;
+                        datad[(i + c) * wpld + q] =
+                            ((a0 >> sh) & 0xff) << 24 |
+                            ((a1 >> sh) & 0xff) << 16 |
+                            ((a2 >> sh) & 0xff) << 8 |
+                            ((a3 >> sh) & 0xff);
+                    }
+                }
+            }
+            else {
+                lines = datas + 4 * q * wpls;
+                for (i = ib; i < iend; i += 4) {
+                    a0 = lines[i / 4];
+                    a1 = lines[i / 4 + wpls];
+                    a2 = lines[i / 4 + 2 * wpls];
+                    a3 = lines[i / 4 + 3 * wpls];
+                    for (c = 0; c < 4; c++) {
+                        sh = 24 - 8 * c;
+                        datad[(hd - 1 - i - c) * wpld + q] =
+                            ((a0 >> sh) & 0xff) << 24 |
+                            ((a1 >> sh) & 0xff) << 16 |
+                            ((a2 >> sh) & 0xff) << 8 |
+                            ((a3 >> sh) & 0xff);
+                    }
+                }
+            }
+        }
+    }
+
+        /* Pixels in the last few columns of the dest, and in the dest
+         * lines that come from the last few columns of the src */
+    for (i = 0; i < hd; i++) {
+        if (direction == 1)
+            j = (i < 4 * nks) ? 4 * nqd : 0;
+        else
+            j = (i >= hd - 4 * nks) ? 4 * nqd : 0;
+        for (; j < wd; j++) {
+            if (direction == 1)
+                val = GET_DATA_BYTE(datas + (wd - 1 - j) * wpls, i);
+            else
+                val = GET_DATA_BYTE(datas + j * wpls, hd - 1 - i);
+            SET_DATA_BYTE(datad + i * wpld, j, val);
+        }
+    }
+
+    return;
+}
+
+
+/*!
+ *  rotate90Low32()
+ *
+ *      Input:  datad, wd, hd, wpld (32 bpp dest)
+ *              datas, wpls (32 bpp src)
+ *              direction (1 for cw, -1 for ccw)
+ *      Return: void
+ *
+ *  Notes:
+ *      (1) The pixels are copied in square blocks of ROTATE_BLOCK_SIZE,
+ *          so that the src and dest lines in use stay in the cache.
+ */
+static void
+rotate90Low32(l_uint32  *datad,
+              l_int32    wd,
+              l_int32    hd,
+              l_int32    wpld,
+              l_uint32  *datas,
+              l_int32    wpls,
+              l_int32    direction)
+{
+l_int32    i, j, ib, jb, iend, jend;
+l_uint32  *lines, *lined;
+
+    for (ib = 0; ib < hd; ib += ROTATE_BLOCK_SIZE) {
+        iend = L_MIN(ib + ROTATE_BLOCK_SIZE, hd);
+        for (jb = 0; jb < wd; jb += ROTATE_BLOCK_SIZE) {
+            jend = L_MIN(jb + ROTATE_BLOCK_SIZE, wd);
+            for (i = ib; i < iend; i++) {
+                lined = datad + i * wpld;
+                if (direction == 1) {
+                    lines = datas + (wd - 1 - jb) * wpls + i;
+                    for (j = jb; j < jend; j++) {
+                        lined[j] = *lines;
+                        lines -= wpls;
+                    }
+                }
+                else {
+                    lines = datas + jb * wpls + hd - 1 - i;
+                    for (j = jb; j < jend; j++) {
+                        lined[j] = *lines;
+                        lines += wpls;
+                    }
+                }
+            }
+        }
+    }
+
+    return;
+}
+
+
 /*------------------------------------------------------------------*
  *                           Left/right flip                        *
  *------------------------------------------------------------------*/
@@ -369,13 +652,18 @@ l_uint32  *line;
             if (shift)
                 rasteropHipLow(data, h, d, wpl, 0, h, shift);
 
-            databpl = (w + 7) / 8;
+                /* The line is now right-justified, so we can reverse
+                 * the order of whole words, reversing the bits in each
+                 * word with the table. */
             for (i = 0; i < h; i++) {
                 line = data + i * wpl;
                 memcpy(buffer, line, bpl);
-                for (j = 0; j < databpl; j++) {
-                    val = GET_DATA_BYTE(buffer, bpl - 1 - j);
-                    SET_DATA_BYTE(line, j, tab[val]);
+                for (j = 0; j < wpl; j++) {
+                    val = buffer[wpl - 1 - j];
+                    line[j] = tab[val & 0xff] << 24 |
+                              tab[(val >> 8) & 0xff] << 16 |
+                              tab[(val >> 16) & 0xff] << 8 |
+                              tab[val >> 24];
                 }
             }
             break;
@@ -21,6 +21,10 @@
  *               PIX    *pixScaleToSize()     ***
  *               PIX    *pixScaleGeneral()     ***
  *
+ *         Separable resampling with a bicubic or lanczos filter
+ *               PIX    *pixScaleWithFilter()     ***
+ *               PIX    *pixScaleFiltered()     ***
+ *
  *         Linearly interpreted (usually up-) scaling
  *               PIX    *pixScaleLI()     ***
  *               PIX    *pixScaleColorLI()
@@ -46,6 +50,7 @@
  *         Downscaling with (antialias) area mapping
  *               PIX    *pixScaleAreaMap()     ***
  *               PIX    *pixScaleAreaMap2()
+ *               PIX    *pixScaleByIntReduction()
  *
  *         Binary scaling by closest pixel sampling
  *               PIX    *pixScaleBinary()
@@ -268,6 +273,9 @@ l_float32  scalex, scaley;
  *      (5) To use arbitrary sharpening in conjunction with scaling,
  *          call this function with @sharpfract = 0.0, and follow this
  *          with a call to pixUnsharpMasking() with your chosen parameters.
+ *      (6) To scale with a bicubic or lanczos filter instead of
+ *          area mapping and linear interpolation, use
+ *          pixScaleWithFilter().
  */
 PIX *
 pixScaleGeneral(PIX       *pixs,
@@ -324,6 +332,164 @@ PIX       *pixt, *pixt2, *pixd;
 }
 
 
+/*------------------------------------------------------------------*
+ *       Separable resampling with a bicubic or lanczos filter      *
+ *------------------------------------------------------------------*/
+/*!
+ *  pixScaleWithFilter()
+ *
+ *      Input:  pixs (1, 2, 4, 8, 16 and 32 bpp)
+ *              scalex, scaley
+ *              type (L_LINEAR_FILTER, L_BICUBIC_FILTER, L_LANCZOS3_FILTER)
+ *              sharpfract (use 0.0 to skip sharpening)
+ *              sharpwidth (halfwidth of low-pass filter; typ. 1 or 2)
+ *      Return: pixd, or null on error
+ *
+ *  Notes:
+ *      (1) This is pixScaleGeneral() with an explicit choice of the
+ *          resampling filter for grayscale and color images.  With
+ *          L_LINEAR_FILTER, it is identical to pixScaleGeneral().
+ *          Binary images are always scaled by sampling.
+ *      (2) With L_BICUBIC_FILTER or L_LANCZOS3_FILTER, pixScaleFiltered()
+ *          is used for all scale factors.  Sharpening is then applied
+ *          over the same range of scale factors as in pixScaleGeneral();
+ *          the alpha component of 32 bpp images is not sharpened.
+ *      (3) Because the bicubic and lanczos filters are themselves
+ *          sharper than area mapping and linear interpolation, you
+ *          will usually want to call this with @sharpfract = 0.0.
+ */
+PIX *
+pixScaleWithFilter(PIX       *pixs,
+                   l_float32  scalex,
+                   l_float32  scaley,
+                   l_int32    type,
+                   l_float32  sharpfract,
+                   l_int32    sharpwidth)
+{
+l_int32    d;
+l_float32  maxscale;
+PIX       *pixt, *pixt2, *pixa, *pixd;
+
+    PROCNAME("pixScaleWithFilter");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    d = pixGetDepth(pixs);
+    if (d != 1 && d != 2 && d != 4 && d != 8 && d != 16 && d != 32)
+        return (PIX *)ERROR_PTR("pixs not {1,2,4,8,16,32} bpp", procName, NULL);
+    if (type != L_LINEAR_FILTER && type != L_BICUBIC_FILTER &&
+        type != L_LANCZOS3_FILTER)
+        return (PIX *)ERROR_PTR("invalid filter type", procName, NULL);
+    if (type == L_LINEAR_FILTER)
+        return pixScaleGeneral(pixs, scalex, scaley, sharpfract, sharpwidth);
+    if (scalex == 1.0 && scaley == 1.0)
+        return pixCopy(NULL, pixs);
+
+    if (d == 1)
+        return pixScaleBinary(pixs, scalex, scaley);
+
+        /* Remove colormap; clone if possible; result is either 8 or 32 bpp */
+    if ((pixt = pixConvertTo8Or32(pixs, 0, 1)) == NULL)
+        return (PIX *)ERROR_PTR("pixt not made", procName, NULL);
+
+    maxscale = L_MAX(scalex, scaley);
+    pixt2 = pixScaleFiltered(pixt, scalex, scaley, type);
+    pixDestroy(&pixt);
+    if (!pixt2)
+        return (PIX *)ERROR_PTR("pixt2 not made", procName, NULL);
+    if (maxscale > 0.2 && maxscale < 1.4 && sharpfract > 0.0 &&
+        sharpwidth > 0) {
+        pixd = pixUnsharpMasking(pixt2, sharpwidth, sharpfract);
+        if (pixd && pixGetDepth(pixd) == 32) {  /* restore alpha */
+            pixa = pixGetRGBComponent(pixt2, L_ALPHA_CHANNEL);
+            pixSetRGBComponent(pixd, pixa, L_ALPHA_CHANNEL);
+            pixDestroy(&pixa);
+        }
+    }
+    else
+        pixd = pixClone(pixt2);
+
+    pixDestroy(&pixt2);
+    return pixd;
+}
+
+
+/*!
+ *  pixScaleFiltered()
+ *
+ *      Input:  pixs (2, 4, 8, 16 or 32 bpp; with or without colormap)
+ *              scalex, scaley
+ *              type (L_BICUBIC_FILTER, L_LANCZOS3_FILTER)
+ *      Return: pixd (8 or 32 bpp), or null on error
+ *
+ *  Notes:
+ *      (1) This is a separable resampler for both upscaling and
+ *          downscaling.  For each dest column (and row) the set of
+ *          src pixels and their filter weights are computed once.
+ *          For downscaling, the filter is stretched by the inverse
+ *          of the scale factor, so that it also acts as an antialias
+ *          lowpass filter.
+ *      (2) L_BICUBIC_FILTER is cubic convolution, with a support
+ *          of 4 src pixels for upscaling.  L_LANCZOS3_FILTER has a
+ *          support of 6, and is sharper, with slightly more ringing.
+ *          Both give better results than linear interpolation for
+ *          upscaling low resolution images, and than area mapping
+ *          for downscaling images with fine detail.
+ *      (3) Images with a colormap or depth other than 8 or 32 bpp
+ *          are converted to 8 or 32 bpp first.  For 32 bpp images,
+ *          the alpha component is resampled along with the rgb
+ *          components.
+ *      (4) Boundary pixels are replicated outward.
+ *
+ *  *** Warning: implicit assumption about RGB component ordering ***
+ */
+PIX *
+pixScaleFiltered(PIX       *pixs,
+                 l_float32  scalex,
+                 l_float32  scaley,
+                 l_int32    type)
+{
+l_int32    ws, hs, d, wd, hd, wpls, wpld;
+l_uint32  *datas, *datad;
+PIX       *pixt, *pixd;
+
+    PROCNAME("pixScaleFiltered");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    d = pixGetDepth(pixs);
+    if (d != 2 && d != 4 && d != 8 && d != 16 && d != 32)
+        return (PIX *)ERROR_PTR("pixs not {2,4,8,16,32} bpp", procName, NULL);
+    if (type != L_BICUBIC_FILTER && type != L_LANCZOS3_FILTER)
+        return (PIX *)ERROR_PTR("invalid filter type", procName, NULL);
+    if (scalex <= 0.0 || scaley <= 0.0)
+        return (PIX *)ERROR_PTR("scale factor <= 0.0", procName, NULL);
+
+    if ((pixt = pixConvertTo8Or32(pixs, 0, 1)) == NULL)
+        return (PIX *)ERROR_PTR("pixt not made", procName, NULL);
+    pixGetDimensions(pixt, &ws, &hs, &d);
+    wd = L_MAX(1, (l_int32)(scalex * (l_float32)ws + 0.5));
+    hd = L_MAX(1, (l_int32)(scaley * (l_float32)hs + 0.5));
+    if ((pixd = pixCreate(wd, hd, d)) == NULL) {
+        pixDestroy(&pixt);
+        return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
+    }
+    pixCopyResolution(pixd, pixt);
+    pixScaleResolution(pixd, scalex, scaley);
+    datas = pixGetData(pixt);
+    wpls = pixGetWpl(pixt);
+    datad = pixGetData(pixd);
+    wpld = pixGetWpl(pixd);
+    if (scaleFilteredLow(datad, wd, hd, wpld, datas, ws, hs, d, wpls, type))
+        pixDestroy(&pixd);
+
+    pixDestroy(&pixt);
+    if (!pixd)
+        return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
+    return pixd;
+}
+
+
 /*------------------------------------------------------------------*
  *                  Scaling by linear interpolation                 *
  *------------------------------------------------------------------*/
@@ -447,7 +613,10 @@ PIX       *pixd;
     pixScaleResolution(pixd, scalex, scaley);
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
-    scaleColorLILow(datad, wd, hd, wpld, datas, ws, hs, wpls);
+    if (scaleColorLILow(datad, wd, hd, wpld, datas, ws, hs, wpls)) {
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("scaling failed", procName, NULL);
+    }
     return pixd;
 }
 
@@ -661,7 +830,10 @@ PIX       *pixd;
     pixScaleResolution(pixd, scalex, scaley);
     datad = pixGetData(pixd);
     wpld = pixGetWpl(pixd);
-    scaleGrayLILow(datad, wd, hd, wpld, datas, ws, hs, wpls);
+    if (scaleGrayLILow(datad, wd, hd, wpld, datas, ws, hs, wpls)) {
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("scaling failed", procName, NULL);
+    }
     return pixd;
 }
 
@@ -1373,6 +1545,71 @@ PIX       *pixs, *pixd;
 }
 
 
+/*!
+ *  pixScaleByIntReduction()
+ *
+ *      Input:  pixs (1, 2, 4, 8, 16 or 32 bpp; colormap OK)
+ *              factor (reduction: 1, 2, 4 or 8)
+ *      Return: pixd, or null on error
+ *
+ *  Notes:
+ *      (1) This makes a reduced image for previews, averaging over each
+ *          factor x factor block of pixels.  1 bpp images are reduced
+ *          to 8 bpp gray with pixScaleToGray*(); all others are area
+ *          mapped with pixScaleAreaMap2(), after removing any colormap
+ *          and converting 16 bpp to 8 bpp.
+ *      (2) Each block of the result depends only on the corresponding
+ *          @factor rows of pixs.  So the image can be reduced in bands
+ *          of @factor rows as it is decoded, without making the full
+ *          image; see pixReadReduced().
+ *      (3) For @factor == 1, this returns a copy.
+ */
+PIX *
+pixScaleByIntReduction(PIX     *pixs,
+                       l_int32  factor)
+{
+l_int32  d;
+PIX     *pixt, *pixd;
+
+    PROCNAME("pixScaleByIntReduction");
+
+    if (!pixs)
+        return (PIX *)ERROR_PTR("pixs not defined", procName, NULL);
+    if (factor != 1 && factor != 2 && factor != 4 && factor != 8)
+        return (PIX *)ERROR_PTR("factor not in {1,2,4,8}", procName, NULL);
+
+    if (factor == 1)
+        return pixCopy(NULL, pixs);
+
+    d = pixGetDepth(pixs);
+    if (d == 1) {
+        if (factor == 2)
+            return pixScaleToGray2(pixs);
+        else if (factor == 4)
+            return pixScaleToGray4(pixs);
+        else  /* factor == 8 */
+            return pixScaleToGray8(pixs);
+    }
+
+    if (pixGetColormap(pixs))
+        pixd = pixRemoveColormap(pixs, REMOVE_CMAP_BASED_ON_SRC);
+    else if (d == 16)
+        pixd = pixConvert16To8(pixs, 1);
+    else
+        pixd = pixClone(pixs);
+    if (!pixd)
+        return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
+
+    for (; factor > 1; factor /= 2) {
+        pixt = pixScaleAreaMap2(pixd);
+        pixDestroy(&pixd);
+        if ((pixd = pixt) == NULL)
+            return (PIX *)ERROR_PTR("pixd not made", procName, NULL);
+    }
+    return pixd;
+}
+
+
 /*------------------------------------------------------------------*
  *               Binary scaling by closest pixel sampling           *
  *------------------------------------------------------------------*/
@@ -18,10 +18,11 @@
  *  scalelow.c
  *
  *         Color (interpolated) scaling: general case
- *                  void       scaleColorLILow()
+ *                  l_int32    scaleColorLILow()
  *
  *         Grayscale (interpolated) scaling: general case
- *                  void       scaleGrayLILow()
+ *                  l_int32    scaleGrayLILow()
+ *                  static l_int32  makeLIColumnTabs()
  *
  *         Color (interpolated) scaling: 2x upscaling
  *                  void       scaleColor2xLILow()
@@ -79,13 +80,25 @@
  *         Grayscale mipmap
  *                  l_int32    scaleMipmapLow()
  *
+ *         Separable resampling with bicubic or lanczos filter
+ *                  l_int32    scaleFilteredLow()
+ *                  static l_int32    makeResampleTabs()
+ *                  static l_float32  resampleKernel()
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include "allheaders.h"
 
+static l_int32 makeResampleTabs(l_int32 ns, l_int32 nd, l_int32 type,
+                                l_int32 *pntaps, l_int32 **pindex,
+                                l_float32 **pweight);
+static l_float32 resampleKernel(l_float32 x, l_int32 type);
+static l_int32 makeLIColumnTabs(l_int32 ws, l_int32 wd, l_int32 **pxp,
+                                l_int32 **pxn, l_int32 **pxf);
+
 #ifndef  NO_CONSOLE_IO
 #define  DEBUG_OVERFLOW   0
 #define  DEBUG_UNROLLING  0
@@ -104,9 +117,17 @@
  *  by 256) associated with each of the four nearest src pixels,
  *  and weighting each pixel value by this fractional area.
  *
- *  P3 speed is about 7 x 10^6 dst pixels/sec/GHz
+ *  Notes:
+ *      (1) The src column and subpixel fraction for each dest column
+ *          are computed once, in makeLIColumnTabs(), and the src row
+ *          and fraction once for each dest row.  The inner loop is
+ *          then integer-only, and has no tests for the image boundary.
+ *      (2) The red and blue components are interpolated together
+ *          in one 32 bit word, each in a 16 bit field.  The weighted
+ *          sum of each is at most 255 * 256 + 128, so there is no
+ *          carry between the fields.
  */
-void
+l_int32
 scaleColorLILow(l_uint32  *datad,
                l_int32    wd,
                l_int32    hd,
@@ -116,23 +137,22 @@ scaleColorLILow(l_uint32  *datad,
                l_int32    hs,
                l_int32    wpls)
 {
-l_int32    i, j, wm2, hm2;
-l_int32    xpm, ypm;  /* location in src image, to 1/16 of a pixel */
-l_int32    xp, yp, xf, yf;  /* src pixel and pixel fraction coordinates */
-l_int32    v00r, v01r, v10r, v11r, v00g, v01g, v10g, v11g;
-l_int32    v00b, v01b, v10b, v11b, area00, area01, area10, area11;
-l_uint32   pixels1, pixels2, pixels3, pixels4, pixel;
-l_uint32  *lines, *lined;
-l_float32  scx, scy;
+l_int32    i, j, hm2;
+l_int32    ypm;  /* location in src image, to 1/16 of a pixel */
+l_int32    yp, xf, yf, xp, xn;
+l_int32   *xptab, *xntab, *xftab;
+l_uint32   p00, p01, p10, p11, rb0, rb1, g0, g1, rbsum, gsum;
+l_uint32  *lines, *lines1, *lined;
+l_float32  scy;
 
-        /* (scx, scy) are scaling factors that are applied to the
-         * dest coords to get the corresponding src coords.
-         * We need them because we iterate over dest pixels
-         * and must find the corresponding set of src pixels. */
-    scx = 16. * (l_float32)ws / (l_float32)wd;
-    scy = 16. * (l_float32)hs / (l_float32)hd;
+    PROCNAME("scaleColorLILow");
 
-    wm2 = ws - 2;
+    if (makeLIColumnTabs(ws, wd, &xptab, &xntab, &xftab))
+        return ERROR_INT("column tabs not made", procName, 1);
+
+        /* scy is the scaling factor applied to the dest row
+         * to get the corresponding src row, in 1/16 pixels */
+    scy = 16. * (l_float32)hs / (l_float32)hd;
     hm2 = hs - 2;
 
         /* Iterate over the destination pixels */
@@ -142,63 +162,36 @@ l_float32  scx, scy;
         yf = ypm & 0x0f;
         lined = datad + i * wpld;
         lines = datas + yp * wpls;
+        lines1 = (yp > hm2) ? lines : lines + wpls;  /* next src row */
         for (j = 0; j < wd; j++) {
-            xpm = (l_int32)(scx * (l_float32)j);
-            xp = xpm >> 4;
-            xf = xpm & 0x0f;
-
-                /* Do bilinear interpolation.  This is a simple
-                 * generalization of the calculation in scaleGrayLILow().
-                 * Without this, we could simply subsample:
-                 *     *(lined + j) = *(lines + xp);
-                 * which is faster but gives lousy results!  */
-            pixels1 = *(lines + xp);
-
-            if (xp > wm2 || yp > hm2) {
-                if (yp > hm2 && xp <= wm2) {  /* pixels near bottom */
-                    pixels2 = *(lines + xp + 1);
-                    pixels3 = pixels1;
-                    pixels4 = pixels2;
-                }
-                else if (xp > wm2 && yp <= hm2) {  /* pixels near right side */
-                    pixels2 = pixels1;
-                    pixels3 = *(lines + wpls + xp);
-                    pixels4 = pixels3;
-                }
-                else {  /* pixels at LR corner */
-                    pixels4 = pixels3 = pixels2 = pixels1;
-                }
-            }
-            else {
-                pixels2 = *(lines + xp + 1);
-                pixels3 = *(lines + wpls + xp);
-                pixels4 = *(lines + wpls + xp + 1);
-            }
-
-            area00 = (16 - xf) * (16 - yf);
-            area10 = xf * (16 - yf);
-            area01 = (16 - xf) * yf;
-            area11 = xf * yf;
-            v00r = area00 * ((pixels1 >> L_RED_SHIFT) & 0xff);
-            v00g = area00 * ((pixels1 >> L_GREEN_SHIFT) & 0xff);
-            v00b = area00 * ((pixels1 >> L_BLUE_SHIFT) & 0xff);
-            v10r = area10 * ((pixels2 >> L_RED_SHIFT) & 0xff);
-            v10g = area10 * ((pixels2 >> L_GREEN_SHIFT) & 0xff);
-            v10b = area10 * ((pixels2 >> L_BLUE_SHIFT) & 0xff);
-            v01r = area01 * ((pixels3 >> L_RED_SHIFT) & 0xff);
-            v01g = area01 * ((pixels3 >> L_GREEN_SHIFT) & 0xff);
-            v01b = area01 * ((pixels3 >> L_BLUE_SHIFT) & 0xff);
-            v11r = area11 * ((pixels4 >> L_RED_SHIFT) & 0xff);
-            v11g = area11 * ((pixels4 >> L_GREEN_SHIFT) & 0xff);
-            v11b = area11 * ((pixels4 >> L_BLUE_SHIFT) & 0xff);
-            pixel = (((v00r + v10r + v01r + v11r + 128) << 16) & 0xff000000) |
-                    (((v00g + v10g + v01g + v11g + 128) << 8) & 0x00ff0000) |
-                    ((v00b + v10b + v01b + v11b + 128) & 0x0000ff00);
-            *(lined + j) = pixel;
+            xp = xptab[j];
+            xn = xntab[j];
+            xf = xftab[j];
+
+                /* Do bilinear interpolation: first vertically, in each
+                 * of the two src columns, and then horizontally. */
+            p00 = lines[xp];
+            p10 = lines[xn];
+            p01 = lines1[xp];
+            p11 = lines1[xn];
+            rb0 = (16 - yf) * ((p00 >> 8) & 0x00ff00ff) +
+                  yf * ((p01 >> 8) & 0x00ff00ff);
+            rb1 = (16 - yf) * ((p10 >> 8) & 0x00ff00ff) +
+                  yf * ((p11 >> 8) & 0x00ff00ff);
+            g0 = (16 - yf) * ((p00 >> L_GREEN_SHIFT) & 0xff) +
+                 yf * ((p01 >> L_GREEN_SHIFT) & 0xff);
+            g1 = (16 - yf) * ((p10 >> L_GREEN_SHIFT) & 0xff) +
+                 yf * ((p11 >> L_GREEN_SHIFT) & 0xff);
+            rbsum = (16 - xf) * rb0 + xf * rb1 + 0x00800080;
+            gsum = (16 - xf) * g0 + xf * g1 + 128;
+            lined[j] = (rbsum & 0xff00ff00) | ((gsum << 8) & 0x00ff0000);
         }
     }
 
-    return;
+    FREE(xptab);
+    FREE(xntab);
+    FREE(xftab);
+    return 0;
 }
 
 
@@ -213,8 +206,12 @@ l_float32  scx, scy;
  *  fractional area (i.e., number of sub-pixels divided
  *  by 256) associated with each of the four nearest src pixels,
  *  and weighting each pixel value by this fractional area.
+ *
+ *  Notes:
+ *      (1) As in scaleColorLILow(), the src coordinates and fractions
+ *          are computed once for each dest column and row.
  */
-void
+l_int32
 scaleGrayLILow(l_uint32  *datad,
                l_int32    wd,
                l_int32    hd,
@@ -224,22 +221,19 @@ scaleGrayLILow(l_uint32  *datad,
                l_int32    hs,
                l_int32    wpls)
 {
-l_int32    i, j, wm2, hm2;
-l_int32    xpm, ypm;  /* location in src image, to 1/16 of a pixel */
-l_int32    xp, yp, xf, yf;  /* src pixel and pixel fraction coordinates */
-l_int32    v00, v01, v10, v11, v00_val, v01_val, v10_val, v11_val;
-l_uint8    val;
-l_uint32  *lines, *lined;
-l_float32  scx, scy;
+l_int32    i, j, hm2;
+l_int32    ypm;  /* location in src image, to 1/16 of a pixel */
+l_int32    yp, xf, yf, xp, xn, v0, v1;
+l_int32   *xptab, *xntab, *xftab;
+l_uint32  *lines, *lines1, *lined;
+l_float32  scy;
 
-        /* (scx, scy) are scaling factors that are applied to the
-         * dest coords to get the corresponding src coords.
-         * We need them because we iterate over dest pixels
-         * and must find the corresponding set of src pixels. */
-    scx = 16. * (l_float32)ws / (l_float32)wd;
-    scy = 16. * (l_float32)hs / (l_float32)hd;
+    PROCNAME("scaleGrayLILow");
 
-    wm2 = ws - 2;
+    if (makeLIColumnTabs(ws, wd, &xptab, &xntab, &xftab))
+        return ERROR_INT("column tabs not made", procName, 1);
+
+    scy = 16. * (l_float32)hs / (l_float32)hd;
     hm2 = hs - 2;
 
         /* Iterate over the destination pixels */
@@ -249,48 +243,77 @@ l_float32  scx, scy;
         yf = ypm & 0x0f;
         lined = datad + i * wpld;
         lines = datas + yp * wpls;
+        lines1 = (yp > hm2) ? lines : lines + wpls;  /* next src row */
         for (j = 0; j < wd; j++) {
-            xpm = (l_int32)(scx * (l_float32)j);
-            xp = xpm >> 4;
-            xf = xpm & 0x0f;
+            xp = xptab[j];
+            xn = xntab[j];
+            xf = xftab[j];
 
                 /* Do bilinear interpolation.  Without this, we could
                  * simply subsample:
                  *   SET_DATA_BYTE(lined, j, GET_DATA_BYTE(lines, xp));
                  * which is faster but gives lousy results!  */
-            v00_val = GET_DATA_BYTE(lines, xp);
-            if (xp > wm2 || yp > hm2) {
-                if (yp > hm2 && xp <= wm2) {  /* pixels near bottom */
-                    v01_val = v00_val;
-                    v10_val = GET_DATA_BYTE(lines, xp + 1);
-                    v11_val = v10_val;
-                }
-                else if (xp > wm2 && yp <= hm2) {  /* pixels near right side */
-                    v01_val = GET_DATA_BYTE(lines + wpls, xp);
-                    v10_val = v00_val;
-                    v11_val = v01_val;
-                }
-                else {  /* pixels at LR corner */
-                    v10_val = v01_val = v11_val = v00_val;
-                }
-            }
-            else {
-                v10_val = GET_DATA_BYTE(lines, xp + 1);
-                v01_val = GET_DATA_BYTE(lines + wpls, xp);
-                v11_val = GET_DATA_BYTE(lines + wpls, xp + 1);
-            }
+            v0 = (16 - yf) * GET_DATA_BYTE(lines, xp) +
+                 yf * GET_DATA_BYTE(lines1, xp);
+            v1 = (16 - yf) * GET_DATA_BYTE(lines, xn) +
+                 yf * GET_DATA_BYTE(lines1, xn);
+            SET_DATA_BYTE(lined, j, ((16 - xf) * v0 + xf * v1 + 128) >> 8);
+        }
+    }
 
-            v00 = (16 - xf) * (16 - yf) * v00_val;
-            v10 = xf * (16 - yf) * v10_val;
-            v01 = (16 - xf) * yf * v01_val;
-            v11 = xf * yf * v11_val;
+    FREE(xptab);
+    FREE(xntab);
+    FREE(xftab);
+    return 0;
+}
 
-            val = (l_uint8)((v00 + v01 + v10 + v11 + 128) / 256);
-            SET_DATA_BYTE(lined, j, val);
-        }
+
+/*!
+ *  makeLIColumnTabs()
+ *
+ *      Input:  ws, wd (src and dest widths)
+ *              &xp (<return> src column for each dest column)
+ *              &xn (<return> next src column, clipped to the image)
+ *              &xf (<return> subpixel fraction, in [0 ... 15])
+ *      Return: 0 if OK, 1 on error
+ */
+static l_int32
+makeLIColumnTabs(l_int32    ws,
+                 l_int32    wd,
+                 l_int32  **pxp,
+                 l_int32  **pxn,
+                 l_int32  **pxf)
+{
+l_int32    j, xpm, wm2;
+l_int32   *xp, *xn, *xf;
+l_float32  scx;
+
+    PROCNAME("makeLIColumnTabs");
+
+    *pxp = *pxn = *pxf = NULL;
+    xp = (l_int32 *)CALLOC(wd, sizeof(l_int32));
+    xn = (l_int32 *)CALLOC(wd, sizeof(l_int32));
+    xf = (l_int32 *)CALLOC(wd, sizeof(l_int32));
+    if (!xp || !xn || !xf) {
+        FREE(xp);
+        FREE(xn);
+        FREE(xf);
+        return ERROR_INT("tabs not made", procName, 1);
     }
 
-    return;
+    scx = 16. * (l_float32)ws / (l_float32)wd;
+    wm2 = ws - 2;
+    for (j = 0; j < wd; j++) {
+        xpm = (l_int32)(scx * (l_float32)j);
+        xp[j] = xpm >> 4;
+        xn[j] = (xp[j] > wm2) ? xp[j] : xp[j] + 1;
+        xf[j] = xpm & 0x0f;
+    }
+
+    *pxp = xp;
+    *pxn = xn;
+    *pxf = xf;
+    return 0;
 }
 
 
@@ -2467,3 +2490,261 @@ l_float32  ratio, w1, w2;
     FREE(scol);
     return 0;
 }
+
+
+/*------------------------------------------------------------------*
+ *        Separable resampling with bicubic or lanczos filter       *
+ *------------------------------------------------------------------*/
+/*!
+ *  scaleFilteredLow()
+ *
+ *      Input:  datad, wd, hd, wpld (dest)
+ *              datas, ws, hs, d, wpls (src; d is 8 or 32)
+ *              type (L_BICUBIC_FILTER, L_LANCZOS3_FILTER)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) Each src row is converted to float components and filtered
+ *          horizontally, once, into a ring buffer holding as many rows
+ *          as there are vertical filter taps.  Each dest row is then
+ *          a weighted sum of rows in the ring buffer.  So the src is
+ *          traversed once, and the intermediate image is never made.
+ *      (2) The vertical sum is accumulated over entire rows, which
+ *          the compiler can vectorize.
+ *      (3) For 32 bpp, all four components, including alpha, are
+ *          resampled.
+ */
+l_int32
+scaleFilteredLow(l_uint32  *datad,
+                 l_int32    wd,
+                 l_int32    hd,
+                 l_int32    wpld,
+                 l_uint32  *datas,
+                 l_int32    ws,
+                 l_int32    hs,
+                 l_int32    d,
+                 l_int32    wpls,
+                 l_int32    type)
+{
+l_int32     i, j, k, m, c, ncomp, ntapsx, ntapsy, srow, slot, val;
+l_int32     ret, shift[4];
+l_int32    *indexx, *indexy, *slotrow;
+l_uint32   *lines, *lined;
+l_float32   sum, wt;
+l_float32  *weightx, *weighty, *rowf, *acc, *ring, *ringrow, *p;
+
+    PROCNAME("scaleFilteredLow");
+
+    if (d != 8 && d != 32)
+        return ERROR_INT("pixs not 8 or 32 bpp", procName, 1);
+    indexx = indexy = slotrow = NULL;
+    weightx = weighty = rowf = acc = ring = NULL;
+    if (makeResampleTabs(ws, wd, type, &ntapsx, &indexx, &weightx) ||
+        makeResampleTabs(hs, hd, type, &ntapsy, &indexy, &weighty)) {
+        FREE(indexx);
+        FREE(weightx);
+        return ERROR_INT("resampling tabs not made", procName, 1);
+    }
+
+    ret = 1;
+    ncomp = (d == 8) ? 1 : 4;
+    shift[0] = L_RED_SHIFT;
+    shift[1] = L_GREEN_SHIFT;
+    shift[2] = L_BLUE_SHIFT;
+    shift[3] = L_ALPHA_SHIFT;
+    rowf = (l_float32 *)CALLOC(ncomp * ws, sizeof(l_float32));
+    acc = (l_float32 *)CALLOC(ncomp * wd, sizeof(l_float32));
+    ring = (l_float32 *)CALLOC(ntapsy * ncomp * wd, sizeof(l_float32));
+    slotrow = (l_int32 *)CALLOC(ntapsy, sizeof(l_int32));
+    if (!rowf || !acc || !ring || !slotrow) {
+        L_ERROR("buffers not made", procName);
+        goto cleanup;
+    }
+    for (k = 0; k < ntapsy; k++)
+        slotrow[k] = -1;
+
+    for (i = 0; i < hd; i++) {
+            /* Make sure each src row needed for dest row i has been
+             * filtered horizontally and is in the ring buffer.  The
+             * src rows for a dest row are consecutive, so they all
+             * go to different slots. */
+        for (k = 0; k < ntapsy; k++) {
+            srow = indexy[i * ntapsy + k];
+            slot = srow % ntapsy;
+            if (slotrow[slot] == srow)
+                continue;
+            slotrow[slot] = srow;
+            lines = datas + srow * wpls;
+            if (d == 8) {
+                for (j = 0; j < ws; j++)
+                    rowf[j] = GET_DATA_BYTE(lines, j);
+            }
+            else {
+                for (c = 0; c < 4; c++) {
+                    p = rowf + c * ws;
+                    for (j = 0; j < ws; j++)
+                        p[j] = (lines[j] >> shift[c]) & 0xff;
+                }
+            }
+            ringrow = ring + slot * ncomp * wd;
+            for (c = 0; c < ncomp; c++) {
+                p = rowf + c * ws;
+                for (j = 0; j < wd; j++) {
+                    sum = 0.0;
+                    for (m = 0; m < ntapsx; m++)
+                        sum += weightx[j * ntapsx + m] *
+                               p[indexx[j * ntapsx + m]];
+                    ringrow[c * wd + j] = sum;
+                }
+            }
+        }
+
+            /* Vertical filter */
+        for (j = 0; j < ncomp * wd; j++)
+            acc[j] = 0.0;
+        for (k = 0; k < ntapsy; k++) {
+            if ((wt = weighty[i * ntapsy + k]) == 0.0)
+                continue;
+            slot = indexy[i * ntapsy + k] % ntapsy;
+            ringrow = ring + slot * ncomp * wd;
+            for (j = 0; j < ncomp * wd; j++)
+                acc[j] += wt * ringrow[j];
+        }
+
+        lined = datad + i * wpld;
+        if (d == 8) {
+            for (j = 0; j < wd; j++) {
+                val = (l_int32)(acc[j] + 0.5);
+                val = L_MAX(0, L_MIN(255, val));
+                SET_DATA_BYTE(lined, j, val);
+            }
+        }
+        else {
+            for (j = 0; j < wd; j++) {
+                lined[j] = 0;
+                for (c = 0; c < 4; c++) {
+                    val = (l_int32)(acc[c * wd + j] + 0.5);
+                    val = L_MAX(0, L_MIN(255, val));
+                    lined[j] |= (l_uint32)val << shift[c];
+                }
+            }
+        }
+    }
+    ret = 0;
+
+cleanup:
+    FREE(indexx);
+    FREE(indexy);
+    FREE(weightx);
+    FREE(weighty);
+    FREE(rowf);
+    FREE(acc);
+    FREE(ring);
+    FREE(slotrow);
+    return ret;
+}
+
+
+/*!
+ *  makeResampleTabs()
+ *
+ *      Input:  ns, nd (number of src and dest pixels in one dimension)
+ *              type (L_BICUBIC_FILTER, L_LANCZOS3_FILTER)
+ *              &ntaps (<return> number of taps for each dest pixel)
+ *              &index (<return> src pixel for each tap; ntaps * nd)
+ *              &weight (<return> weight for each tap; ntaps * nd)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) The center of dest pixel j maps to src coordinate
+ *          (j + 0.5) * ns / nd - 0.5.
+ *      (2) For downscaling, the filter is stretched by nd / ns.
+ *      (3) The src index is clipped to [0, ns - 1], which replicates
+ *          the boundary pixels.  The weights for each dest pixel are
+ *          normalized to unit sum.  Unused taps have zero weight.
+ */
+static l_int32
+makeResampleTabs(l_int32      ns,
+                 l_int32      nd,
+                 l_int32      type,
+                 l_int32     *pntaps,
+                 l_int32    **pindex,
+                 l_float32  **pweight)
+{
+l_int32     j, k, ntaps, first;
+l_int32    *index;
+l_float32   scale, fscale, radius, support, center, sum;
+l_float32  *weight;
+
+    PROCNAME("makeResampleTabs");
+
+    *pntaps = 0;
+    *pindex = NULL;
+    *pweight = NULL;
+    scale = (l_float32)nd / (l_float32)ns;
+    fscale = L_MIN(1.0, scale);
+    radius = (type == L_LANCZOS3_FILTER) ? 3.0 : 2.0;
+    support = radius / fscale;
+    ntaps = (l_int32)ceil(2.0 * support) + 1;
+    index = (l_int32 *)CALLOC(ntaps * nd, sizeof(l_int32));
+    weight = (l_float32 *)CALLOC(ntaps * nd, sizeof(l_float32));
+    if (!index || !weight) {
+        FREE(index);
+        FREE(weight);
+        return ERROR_INT("tabs not made", procName, 1);
+    }
+
+    for (j = 0; j < nd; j++) {
+        center = (j + 0.5) / scale - 0.5;
+        first = (l_int32)floor(center - support) + 1;
+        sum = 0.0;
+        for (k = 0; k < ntaps; k++) {
+            weight[j * ntaps + k] =
+                resampleKernel((first + k - center) * fscale, type);
+            index[j * ntaps + k] = L_MAX(0, L_MIN(ns - 1, first + k));
+            sum += weight[j * ntaps + k];
+        }
+        if (sum != 0.0) {
+            for (k = 0; k < ntaps; k++)
+                weight[j * ntaps + k] /= sum;
+        }
+    }
+
+    *pntaps = ntaps;
+    *pindex = index;
+    *pweight = weight;
+    return 0;
+}
+
+
+/*!
+ *  resampleKernel()
+ *
+ *      Input:  x (distance from the center, in filter units)
+ *              type (L_BICUBIC_FILTER, L_LANCZOS3_FILTER)
+ *      Return: filter value
+ */
+static l_float32
+resampleKernel(l_float32  x,
+               l_int32    type)
+{
+l_float32  ax, px, px3;
+
+    ax = L_ABS(x);
+    if (type == L_BICUBIC_FILTER) {  /* Keys, with a = -0.5 */
+        if (ax < 1.0)
+            return (1.5 * ax - 2.5) * ax * ax + 1.0;
+        else if (ax < 2.0)
+            return ((-0.5 * ax + 2.5) * ax - 4.0) * ax + 2.0;
+        return 0.0;
+    }
+
+        /* L_LANCZOS3_FILTER */
+    if (ax < 0.000001)
+        return 1.0;
+    if (ax >= 3.0)
+        return 0.0;
+    px = 3.14159265 * ax;
+    px3 = px / 3.0;
+    return (sin(px) / px) * (sin(px3) / px3);
+}
@@ -36,11 +36,48 @@
  *           l_int32     pixSerializeToMemory()
  *           PIX        *pixDeserializeFromMemory()
  *
+ *      Indexed files of serialized or compressed images
+ *           l_int32     pixaWriteIndexedFile()
+ *           l_int32     pixacompWriteIndexedFile()
+ *           l_int32     readHeaderIndexedFile()
+ *           PIX        *pixReadFromIndexedFile()
+ *           PIXA       *pixaReadIndexedFile()
+ *           PIXAC      *pixacompReadIndexedFile()
+ *           static l_int32     indexedFileWrite()
+ *           static l_uint8    *indexedFileMap()
+ *           static l_uint32   *indexedFileGetEntry()
+ *
+ *    An indexed file holds an array of images, with a table of
+ *    offsets at the front so that any one image can be read without
+ *    parsing the others.  The file is mapped into memory for reading,
+ *    so the cost of reading an image does not depend on its position
+ *    in the file.  The layout, in 32-bit words, is:
+ *            "spxi"    (4 bytes) -- ID for file type
+ *            version   (4 bytes)
+ *            n         (4 bytes) -- number of images
+ *            boxflag   (4 bytes) -- 1 if there is a box for each image
+ *            index     (32 * n bytes) -- for each image:
+ *                          offset, nbytes, x, y, w, h, xres, yres
+ *            images    -- each starting on a 4-byte boundary
+ *    A pixa is stored with each image serialized as spix, so that
+ *    reading an image is a single copy of the raster data.  A pixacomp
+ *    is stored with the compressed data of each image.
  */
 
 #include <string.h>
 #include "allheaders.h"
 
+static const l_int32  INDEXED_FILE_VERSION = 1;
+static const l_int32  INDEXED_ENTRY_WORDS = 8;  /* 32-bit words per image */
+
+static l_int32 indexedFileWrite(const char *filename, l_int32 n,
+                                l_uint8 **adata, size_t *asize,
+                                l_int32 *axres, l_int32 *ayres, BOXA *boxa);
+static l_uint8 *indexedFileMap(const char *filename, size_t *psize,
+                               l_int32 *pn, l_int32 *pboxflag);
+static l_uint32 *indexedFileGetEntry(const l_uint8 *data, size_t size,
+                                     l_int32 index);
+
 
 /*-----------------------------------------------------------------------*
  *                          Reading spix from file                       *
@@ -386,6 +423,8 @@ PIXCMAP   *cmap;
  *
  *  Notes:
  *      (1) See pixSerializeToMemory() for the binary format.
+ *      (2) The data is only read, so it can be a mapped file;
+ *          see pixReadMapped().
  */
 PIX *
 pixDeserializeFromMemory(const l_uint32  *data,
@@ -410,21 +449,33 @@ PIXCMAP   *cmap;
     w = data[1];
     h = data[2];
     d = data[3];
-    if ((pixd = pixCreate(w, h, d)) == NULL)
-        return (PIX *)ERROR_PTR("pix not made", procName, NULL);
-
     wpl = data[4];
     ncolors = data[5];
-    if ((cdatasize = data[6]) > 0) {
+    cdatasize = data[6];
+    if (cdatasize < 0 || (size_t)cdatasize > nbytes - 32)
+        return (PIX *)ERROR_PTR("invalid colormap size", procName, NULL);
+    imdatasize = nbytes - 32 - cdatasize;
+
+        /* The raster data is copied directly into the new pix, so the
+         * stored layout must match it exactly */
+    if ((pixd = pixCreateNoInit(w, h, d)) == NULL)
+        return (PIX *)ERROR_PTR("pix not made", procName, NULL);
+    if (wpl != pixGetWpl(pixd) || imdatasize != 4 * wpl * h) {
+        pixDestroy(&pixd);
+        return (PIX *)ERROR_PTR("invalid raster size", procName, NULL);
+    }
+
+    if (cdatasize > 0) {
         cmap = pixcmapDeserializeFromMemory((l_uint8 *)(&data[7]), ncolors,
                                             cdatasize);
-        if (!cmap)
+        if (!cmap) {
+            pixDestroy(&pixd);
             return (PIX *)ERROR_PTR("cmap not made", procName, NULL);
+        }
         pixSetColormap(pixd, cmap);
     }
 
     imdata = pixGetData(pixd);
-    imdatasize = nbytes - 32 - cdatasize;
     memcpy((char *)imdata, (char *)(data + 8 + cdatasize / 4), imdatasize);
 
 #if  DEBUG_SERIALIZE
@@ -437,3 +488,492 @@ PIXCMAP   *cmap;
 }
 
 
+/*-----------------------------------------------------------------------*
+ *            Indexed files of serialized or compressed images           *
+ *-----------------------------------------------------------------------*/
+/*!
+ *  pixaWriteIndexedFile()
+ *
+ *      Input:  filename
+ *              pixa (all depths, colormap OK)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) Each pix is serialized as spix; see pixSerializeToMemory().
+ *          The boxa is stored if it has a box for each pix.
+ */
+l_int32
+pixaWriteIndexedFile(const char  *filename,
+                     PIXA        *pixa)
+{
+l_int32    i, n, ret;
+l_int32   *axres, *ayres;
+l_uint8  **adata;
+size_t    *asize;
+BOXA      *boxa;
+PIX       *pix;
+
+    PROCNAME("pixaWriteIndexedFile");
+
+    if (!filename)
+        return ERROR_INT("filename not defined", procName, 1);
+    if (!pixa)
+        return ERROR_INT("pixa not defined", procName, 1);
+
+    n = pixaGetCount(pixa);
+    adata = (l_uint8 **)CALLOC(n + 1, sizeof(l_uint8 *));
+    asize = (size_t *)CALLOC(n + 1, sizeof(size_t));
+    axres = (l_int32 *)CALLOC(n + 1, sizeof(l_int32));
+    ayres = (l_int32 *)CALLOC(n + 1, sizeof(l_int32));
+    if (!adata || !asize || !axres || !ayres) {
+        if (adata) FREE(adata);
+        if (asize) FREE(asize);
+        if (axres) FREE(axres);
+        if (ayres) FREE(ayres);
+        return ERROR_INT("arrays not made", procName, 1);
+    }
+
+    ret = 0;
+    for (i = 0; i < n; i++) {
+        pix = pixaGetPix(pixa, i, L_CLONE);
+        ret = pixSerializeToMemory(pix, (l_uint32 **)&adata[i], &asize[i]);
+        pixGetResolution(pix, &axres[i], &ayres[i]);
+        pixDestroy(&pix);
+        if (ret) {
+            L_ERROR_INT("pix %d not serialized", procName, i);
+            break;
+        }
+    }
+
+    if (!ret) {
+        boxa = (pixaGetBoxaCount(pixa) == n) ? pixa->boxa : NULL;
+        ret = indexedFileWrite(filename, n, adata, asize, axres, ayres, boxa);
+    }
+
+    for (i = 0; i < n; i++)
+        FREE(adata[i]);
+    FREE(adata);
+    FREE(asize);
+    FREE(axres);
+    FREE(ayres);
+    return ret;
+}
+
+
+/*!
+ *  pixacompWriteIndexedFile()
+ *
+ *      Input:  filename
+ *              pixac
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) The compressed data of each pixcomp is written as is.
+ *          The boxa is stored if it has a box for each pixcomp.
+ */
+l_int32
+pixacompWriteIndexedFile(const char  *filename,
+                         PIXAC       *pixac)
+{
+l_int32    i, n, ret;
+l_int32   *axres, *ayres;
+l_uint8  **adata;
+size_t    *asize;
+BOXA      *boxa;
+PIXC      *pixc;
+
+    PROCNAME("pixacompWriteIndexedFile");
+
+    if (!filename)
+        return ERROR_INT("filename not defined", procName, 1);
+    if (!pixac)
+        return ERROR_INT("pixac not defined", procName, 1);
+
+    n = pixacompGetCount(pixac);
+    adata = (l_uint8 **)CALLOC(n + 1, sizeof(l_uint8 *));
+    asize = (size_t *)CALLOC(n + 1, sizeof(size_t));
+    axres = (l_int32 *)CALLOC(n + 1, sizeof(l_int32));
+    ayres = (l_int32 *)CALLOC(n + 1, sizeof(l_int32));
+    if (!adata || !asize || !axres || !ayres) {
+        if (adata) FREE(adata);
+        if (asize) FREE(asize);
+        if (axres) FREE(axres);
+        if (ayres) FREE(ayres);
+        return ERROR_INT("arrays not made", procName, 1);
+    }
+
+    for (i = 0; i < n; i++) {  /* no copies are made */
+        pixc = pixacompGetPixcomp(pixac, i);
+        adata[i] = pixc->data;
+        asize[i] = pixc->size;
+        axres[i] = pixc->xres;
+        ayres[i] = pixc->yres;
+    }
+    boxa = (pixacompGetBoxaCount(pixac) == n) ? pixac->boxa : NULL;
+    ret = indexedFileWrite(filename, n, adata, asize, axres, ayres, boxa);
+
+    FREE(adata);
+    FREE(asize);
+    FREE(axres);
+    FREE(ayres);
+    return ret;
+}
+
+
+/*!
+ *  readHeaderIndexedFile()
+ *
+ *      Input:  filename
+ *              &n (<return> number of images)
+ *              &boxflag (<optional return> 1 if boxes are stored; else 0)
+ *      Return: 0 if OK, 1 on error
+ */
+l_int32
+readHeaderIndexedFile(const char  *filename,
+                      l_int32     *pn,
+                      l_int32     *pboxflag)
+{
+l_uint8  *data;
+size_t    size;
+
+    PROCNAME("readHeaderIndexedFile");
+
+    if (!pn)
+        return ERROR_INT("&n not defined", procName, 1);
+    *pn = 0;
+    if (pboxflag) *pboxflag = 0;
+    if (!filename)
+        return ERROR_INT("filename not defined", procName, 1);
+
+    if ((data = indexedFileMap(filename, &size, pn, pboxflag)) == NULL)
+        return ERROR_INT("invalid indexed file", procName, 1);
+    l_binaryUnmapFile(data, size);
+    return 0;
+}
+
+
+/*!
+ *  pixReadFromIndexedFile()
+ *
+ *      Input:  filename
+ *              index (of the image in the file)
+ *      Return: pix, or null on error
+ *
+ *  Notes:
+ *      (1) Only the index and the requested image are touched, so this
+ *          takes the same time for any image in the file.
+ *      (2) Images stored from a pixacomp are decompressed.
+ */
+PIX *
+pixReadFromIndexedFile(const char  *filename,
+                       l_int32      index)
+{
+l_int32    n;
+l_uint8   *data;
+l_uint32  *entry;
+size_t     size;
+PIX       *pix;
+
+    PROCNAME("pixReadFromIndexedFile");
+
+    if (!filename)
+        return (PIX *)ERROR_PTR("filename not defined", procName, NULL);
+
+    if ((data = indexedFileMap(filename, &size, &n, NULL)) == NULL)
+        return (PIX *)ERROR_PTR("invalid indexed file", procName, NULL);
+    pix = NULL;
+    if (index < 0 || index >= n)
+        L_ERROR_INT("invalid index %d", procName, index);
+    else if ((entry = indexedFileGetEntry(data, size, index)) != NULL) {
+        if ((pix = pixReadMem(data + entry[0], entry[1])) != NULL)
+            pixSetResolution(pix, entry[6], entry[7]);
+    }
+    l_binaryUnmapFile(data, size);
+
+    if (!pix)
+        return (PIX *)ERROR_PTR("pix not read", procName, NULL);
+    return pix;
+}
+
+
+/*!
+ *  pixaReadIndexedFile()
+ *
+ *      Input:  filename
+ *      Return: pixa, or null on error
+ *
+ *  Notes:
+ *      (1) Images stored from a pixacomp are decompressed.
+ */
+PIXA *
+pixaReadIndexedFile(const char  *filename)
+{
+l_int32    i, n, boxflag;
+l_uint8   *data;
+l_uint32  *entry;
+size_t     size;
+BOX       *box;
+PIX       *pix;
+PIXA      *pixa;
+
+    PROCNAME("pixaReadIndexedFile");
+
+    if (!filename)
+        return (PIXA *)ERROR_PTR("filename not defined", procName, NULL);
+
+    if ((data = indexedFileMap(filename, &size, &n, &boxflag)) == NULL)
+        return (PIXA *)ERROR_PTR("invalid indexed file", procName, NULL);
+    if ((pixa = pixaCreate(n)) == NULL) {
+        l_binaryUnmapFile(data, size);
+        return (PIXA *)ERROR_PTR("pixa not made", procName, NULL);
+    }
+
+    for (i = 0; i < n; i++) {
+        pix = NULL;
+        if ((entry = indexedFileGetEntry(data, size, i)) != NULL)
+            pix = pixReadMem(data + entry[0], entry[1]);
+        if (!pix) {
+            pixaDestroy(&pixa);
+            l_binaryUnmapFile(data, size);
+            return (PIXA *)ERROR_PTR("pix not read", procName, NULL);
+        }
+        pixSetResolution(pix, entry[6], entry[7]);
+        pixaAddPix(pixa, pix, L_INSERT);
+        if (boxflag) {
+            box = boxCreate(entry[2], entry[3], entry[4], entry[5]);
+            pixaAddBox(pixa, box, L_INSERT);
+        }
+    }
+
+    l_binaryUnmapFile(data, size);
+    return pixa;
+}
+
+
+/*!
+ *  pixacompReadIndexedFile()
+ *
+ *      Input:  filename
+ *      Return: pixac, or null on error
+ *
+ *  Notes:
+ *      (1) The compressed data is copied without decompression.
+ *          Images stored from a pixa are kept as spix.
+ */
+PIXAC *
+pixacompReadIndexedFile(const char  *filename)
+{
+l_int32    i, n, boxflag;
+l_uint8   *data;
+l_uint32  *entry;
+size_t     size;
+BOX       *box;
+PIXC      *pixc;
+PIXAC     *pixac;
+
+    PROCNAME("pixacompReadIndexedFile");
+
+    if (!filename)
+        return (PIXAC *)ERROR_PTR("filename not defined", procName, NULL);
+
+    if ((data = indexedFileMap(filename, &size, &n, &boxflag)) == NULL)
+        return (PIXAC *)ERROR_PTR("invalid indexed file", procName, NULL);
+    if ((pixac = pixacompCreate(n)) == NULL) {
+        l_binaryUnmapFile(data, size);
+        return (PIXAC *)ERROR_PTR("pixac not made", procName, NULL);
+    }
+
+    for (i = 0; i < n; i++) {
+        pixc = NULL;
+        if ((entry = indexedFileGetEntry(data, size, i)) != NULL)
+            pixc = pixcompCreateFromString(data + entry[0], entry[1], L_COPY);
+        if (!pixc) {
+            pixacompDestroy(&pixac);
+            l_binaryUnmapFile(data, size);
+            return (PIXAC *)ERROR_PTR("pixc not made", procName, NULL);
+        }
+        pixc->xres = entry[6];
+        pixc->yres = entry[7];
+        pixacompAddPixcomp(pixac, pixc);
+        if (boxflag) {
+            box = boxCreate(entry[2], entry[3], entry[4], entry[5]);
+            pixacompAddBox(pixac, box, L_INSERT);
+        }
+    }
+
+    l_binaryUnmapFile(data, size);
+    return pixac;
+}
+
+
+/*!
+ *  indexedFileWrite()
+ *
+ *      Input:  filename
+ *              n (number of images)
+ *              adata (array of encoded images)
+ *              asize (array of sizes of the encoded images)
+ *              axres, ayres (arrays of resolutions)
+ *              boxa (<optional> with n boxes; can be null)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) A short write, e.g. to a full disk, is an error.  The
+ *          truncated file that is left is rejected by the readers.
+ */
+static l_int32
+indexedFileWrite(const char  *filename,
+                 l_int32      n,
+                 l_uint8    **adata,
+                 size_t      *asize,
+                 l_int32     *axres,
+                 l_int32     *ayres,
+                 BOXA        *boxa)
+{
+char      *id;
+l_int32    i, nhead, npad, x, y, w, h, error;
+l_uint8    zeros[4] = {0, 0, 0, 0};
+l_uint32  *index, *entry;
+size_t     offset;
+FILE      *fp;
+
+    PROCNAME("indexedFileWrite");
+
+    nhead = 4 + INDEXED_ENTRY_WORDS * n;
+    if ((index = (l_uint32 *)CALLOC(nhead, sizeof(l_uint32))) == NULL)
+        return ERROR_INT("index not made", procName, 1);
+    id = (char *)index;
+    id[0] = 's';
+    id[1] = 'p';
+    id[2] = 'x';
+    id[3] = 'i';
+    index[1] = INDEXED_FILE_VERSION;
+    index[2] = n;
+    index[3] = (boxa) ? 1 : 0;
+
+        /* Each image starts on a word boundary, so that spix can be
+         * read from the mapped file as 32-bit words */
+    offset = 4 * nhead;
+    for (i = 0; i < n; i++) {
+        if (offset + asize[i] > 0xffffffff) {
+            FREE(index);
+            return ERROR_INT("file too large for 32-bit offsets", procName, 1);
+        }
+        entry = index + 4 + INDEXED_ENTRY_WORDS * i;
+        entry[0] = offset;
+        entry[1] = asize[i];
+        if (boxa) {
+            boxaGetBoxGeometry(boxa, i, &x, &y, &w, &h);
+            entry[2] = x;
+            entry[3] = y;
+            entry[4] = w;
+            entry[5] = h;
+        }
+        entry[6] = axres[i];
+        entry[7] = ayres[i];
+        offset += 4 * ((asize[i] + 3) / 4);
+    }
+
+    if ((fp = fopenWriteStream(filename, "wb")) == NULL) {
+        FREE(index);
+        return ERROR_INT("stream not opened", procName, 1);
+    }
+    error = (fwrite(index, sizeof(l_uint32), nhead, fp) != nhead);
+    for (i = 0; i < n && !error; i++) {
+        if (fwrite(adata[i], 1, asize[i], fp) != asize[i])
+            error = 1;
+        if ((npad = 4 * ((asize[i] + 3) / 4) - asize[i]) > 0 &&
+            fwrite(zeros, 1, npad, fp) != npad)
+            error = 1;
+    }
+    if (fclose(fp))
+        error = 1;
+    FREE(index);
+    if (error)
+        return ERROR_INT("data not written", procName, 1);
+    return 0;
+}
+
+
+/*!
+ *  indexedFileMap()
+ *
+ *      Input:  filename
+ *              &size (<return> size of mapped data)
+ *              &n (<return> number of images)
+ *              &boxflag (<optional return> 1 if boxes are stored)
+ *      Return: mapped data, or null on error
+ *
+ *  Notes:
+ *      (1) The header is validated.  Unmap the returned data with
+ *          l_binaryUnmapFile().
+ */
+static l_uint8 *
+indexedFileMap(const char  *filename,
+               size_t      *psize,
+               l_int32     *pn,
+               l_int32     *pboxflag)
+{
+char      *id;
+l_int32    n;
+l_uint8   *data;
+l_uint32  *header;
+size_t     size;
+
+    PROCNAME("indexedFileMap");
+
+    *psize = 0;
+    *pn = 0;
+    if (pboxflag) *pboxflag = 0;
+    if ((data = l_binaryMapFile(filename, &size)) == NULL)
+        return (l_uint8 *)ERROR_PTR("file not mapped", procName, NULL);
+
+    header = (l_uint32 *)data;
+    id = (char *)data;
+    if (size < 16 || id[0] != 's' || id[1] != 'p' || id[2] != 'x' ||
+        id[3] != 'i') {
+        l_binaryUnmapFile(data, size);
+        return (l_uint8 *)ERROR_PTR("not an indexed file", procName, NULL);
+    }
+    if (header[1] != INDEXED_FILE_VERSION) {
+        l_binaryUnmapFile(data, size);
+        return (l_uint8 *)ERROR_PTR("invalid version", procName, NULL);
+    }
+    n = header[2];
+    if (n < 0 || (size - 16) / (4 * INDEXED_ENTRY_WORDS) < n) {
+        l_binaryUnmapFile(data, size);
+        return (l_uint8 *)ERROR_PTR("index is truncated", procName, NULL);
+    }
+
+    *psize = size;
+    *pn = n;
+    if (pboxflag) *pboxflag = header[3];
+    return data;
+}
+
+
+/*!
+ *  indexedFileGetEntry()
+ *
+ *      Input:  data (mapped indexed file, with validated header)
+ *              size (of data)
+ *              index (of image)
+ *      Return: index entry for the image, or null on error
+ *
+ *  Notes:
+ *      (1) The entry is returned only if its image lies within the data.
+ */
+static l_uint32 *
+indexedFileGetEntry(const l_uint8  *data,
+                    size_t          size,
+                    l_int32         index)
+{
+l_uint32  *entry;
+
+    PROCNAME("indexedFileGetEntry");
+
+    entry = (l_uint32 *)data + 4 + INDEXED_ENTRY_WORDS * index;
+    if (entry[0] % 4 != 0 || entry[0] > size || entry[1] > size - entry[0])
+        return (l_uint32 *)ERROR_PTR("invalid entry", procName, NULL);
+    return entry;
+}
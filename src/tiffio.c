@@ -19,7 +19,9 @@
  *     Reading tiff:
  *             PIX       *pixReadTiff()    [ special top level ]
  *             PIX       *pixReadStreamTiff()
+ *             PIX       *pixReadStreamTiffReduced()
  *      static PIX       *pixReadFromTiffStream()
+ *      static PIX       *pixReadFromTiffStreamReduced()
  *
  *     Writing tiff:
  *             l_int32    pixWriteTiff()   [ special top level ]
@@ -29,6 +31,7 @@
  *      static l_int32    writeCustomTiffTags()
  *
  *     Reading and writing multipage tiff
+ *             PIX       *pixReadFromMultipageTiff()
  *             PIXA       pixaReadMultipageTiff()
  *             l_int32    writeMultipageTiff()  [ special top level ]
  *             l_int32    writeMultipageTiffSA()
@@ -47,6 +50,7 @@
  *
  *     Extraction of tiff g4 data:
  *             l_int32    extractG4DataFromFile()
+ *             l_int32    extractG4DataFromArray()
  *
  *     Open tiff stream from file stream
  *      static TIFF      *fopenTiff()
@@ -92,6 +96,7 @@ static const l_int32  MAX_PAGES_IN_TIFF_FILE = 3000;  /* should be enough */
 
     /* All functions with TIFF interfaces are static. */
 static PIX      *pixReadFromTiffStream(TIFF *tif);
+static PIX      *pixReadFromTiffStreamReduced(TIFF *tif, l_int32 reduction);
 static l_int32   getTiffStreamResolution(TIFF *tif, l_int32 *pxres,
                                          l_int32 *pyres);
 static l_int32   tiffReadHeaderTiff(TIFF *tif, l_int32 *pwidth,
@@ -232,6 +237,68 @@ TIFF    *tif;
 }
 
 
+/*!
+ *  pixReadStreamTiffReduced()
+ *
+ *      Input:  stream
+ *              n (page number: 0 based)
+ *              reduction (scaling factor: 1, 2, 4 or 8)
+ *      Return: pix, or null on error (e.g., if the page number is invalid)
+ *
+ *  Notes:
+ *      (1) This returns the same image as pixScaleByIntReduction()
+ *          applied to the page read by pixReadStreamTiff().
+ *      (2) Single sample images that do not need to be reoriented are
+ *          decoded in bands of @reduction scanlines, and each band is
+ *          reduced as soon as it is read, so the full resolution image
+ *          is never made.  Other images are decoded in full and then
+ *          reduced.
+ */
+PIX *
+pixReadStreamTiffReduced(FILE    *fp,
+                         l_int32  n,
+                         l_int32  reduction)
+{
+l_int32  i, pagefound;
+PIX     *pix;
+TIFF    *tif;
+
+    PROCNAME("pixReadStreamTiffReduced");
+
+    if (!fp)
+        return (PIX *)ERROR_PTR("stream not defined", procName, NULL);
+    if (reduction != 1 && reduction != 2 && reduction != 4 && reduction != 8)
+        return (PIX *)ERROR_PTR("reduction not in {1,2,4,8}", procName, NULL);
+
+    if ((tif = fopenTiff(fp, "rb")) == NULL)
+        return (PIX *)ERROR_PTR("tif not opened", procName, NULL);
+
+    pagefound = FALSE;
+    pix = NULL;
+    for (i = 0; i < MAX_PAGES_IN_TIFF_FILE; i++) {
+        if (i == n) {
+            pagefound = TRUE;
+            if ((pix = pixReadFromTiffStreamReduced(tif, reduction)) == NULL) {
+                TIFFCleanup(tif);
+                return (PIX *)ERROR_PTR("pix not read", procName, NULL);
+            }
+            break;
+        }
+        if (TIFFReadDirectory(tif) == 0)
+            break;
+    }
+
+    if (pagefound == FALSE) {
+        L_WARNING_INT("tiff page %d not found", procName, n);
+        TIFFCleanup(tif);
+        return NULL;
+    }
+
+    TIFFCleanup(tif);
+    return pix;
+}
+
+
 /*!
  *  pixReadFromTiffStream()
  *
@@ -403,6 +470,145 @@ PIXCMAP   *cmap;
 }
 
 
+/*!
+ *  pixReadFromTiffStreamReduced()
+ *
+ *      Input:  tif
+ *              reduction (scaling factor: 1, 2, 4 or 8)
+ *      Return: pix, or null on error
+ *
+ *  Notes:
+ *      (1) The colormap and photometric inversion are found before
+ *          reading the image data, and applied to each band of
+ *          @reduction scanlines, exactly as pixReadFromTiffStream()
+ *          applies them to the full image.
+ */
+static PIX *
+pixReadFromTiffStreamReduced(TIFF    *tif,
+                             l_int32  reduction)
+{
+l_uint8   *linebuf, *data;
+l_uint16   spp, bps, tiffbpl, photometry, tiffcomp, orientation;
+l_uint16  *redmap, *greenmap, *bluemap;
+l_int32    d, wd, hd, bpl, comptype, invert, i, k, ncolors;
+l_int32    xres, yres;
+l_uint32   w, h;
+PIX       *pixb, *pixt, *pixd;
+PIXCMAP   *cmap;
+
+    PROCNAME("pixReadFromTiffStreamReduced");
+
+    if (!tif)
+        return (PIX *)ERROR_PTR("tif not defined", procName, NULL);
+
+        /* Images that aren't read by scanline, or that are rotated
+         * or flipped after reading, are read in full */
+    TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE, &bps);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &spp);
+    if (!TIFFGetField(tif, TIFFTAG_ORIENTATION, &orientation))
+        orientation = ORIENTATION_TOPLEFT;
+    if (reduction == 1 || spp != 1 || bps > 16 ||
+        (orientation >= 2 && orientation <= 8)) {
+        if ((pixt = pixReadFromTiffStream(tif)) == NULL)
+            return (PIX *)ERROR_PTR("pixt not read", procName, NULL);
+        pixd = pixScaleByIntReduction(pixt, reduction);
+        pixDestroy(&pixt);
+        return pixd;
+    }
+
+    d = bps;
+    TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
+    TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
+    tiffbpl = TIFFScanlineSize(tif);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &tiffcomp);
+    comptype = getTiffCompressedFormat(tiffcomp);
+
+        /* Find the colormap, or the photometry if there is none */
+    cmap = NULL;
+    invert = FALSE;
+    if (TIFFGetField(tif, TIFFTAG_COLORMAP, &redmap, &greenmap, &bluemap)) {
+        if ((cmap = pixcmapCreate(bps)) == NULL)
+            return (PIX *)ERROR_PTR("cmap not made", procName, NULL);
+        ncolors = 1 << bps;
+        for (i = 0; i < ncolors; i++)
+            pixcmapAddColor(cmap, redmap[i] >> 8, greenmap[i] >> 8,
+                            bluemap[i] >> 8);
+    }
+    else {
+        if (!TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometry)) {
+            if (tiffcomp == COMPRESSION_CCITTFAX3 ||
+                tiffcomp == COMPRESSION_CCITTFAX4 ||
+                tiffcomp == COMPRESSION_CCITTRLE ||
+                tiffcomp == COMPRESSION_CCITTRLEW) {
+                photometry = PHOTOMETRIC_MINISWHITE;
+            }
+            else
+                photometry = PHOTOMETRIC_MINISBLACK;
+        }
+        if ((d == 1 && photometry == PHOTOMETRIC_MINISBLACK) ||
+            (d == 8 && photometry == PHOTOMETRIC_MINISWHITE))
+            invert = TRUE;
+    }
+
+        /* Make the band, and reduce an empty band to find the size
+         * of the result */
+    hd = h / reduction;
+    if ((pixb = pixCreate(w, reduction, d)) == NULL) {
+        pixcmapDestroy(&cmap);
+        return (PIX *)ERROR_PTR("pixb not made", procName, NULL);
+    }
+    pixSetColormap(pixb, cmap);
+    if (hd == 0 || (pixt = pixScaleByIntReduction(pixb, reduction)) == NULL) {
+        pixDestroy(&pixb);
+        return (PIX *)ERROR_PTR("image too small to reduce", procName, NULL);
+    }
+    wd = pixGetWidth(pixt);
+    pixd = pixCreate(wd, hd, pixGetDepth(pixt));
+    pixDestroy(&pixt);
+    linebuf = (l_uint8 *)CALLOC(tiffbpl + 1, sizeof(l_uint8));
+    if (!pixd || !linebuf) {
+        pixDestroy(&pixb);
+        pixDestroy(&pixd);
+        FREE(linebuf);
+        return (PIX *)ERROR_PTR("pixd or linebuf not made", procName, NULL);
+    }
+
+    bpl = 4 * pixGetWpl(pixb);
+    for (k = 0; k < hd; k++) {
+        data = (l_uint8 *)pixGetData(pixb);
+        for (i = k * reduction; i < (k + 1) * reduction; i++) {
+            if (TIFFReadScanline(tif, linebuf, i, 0) < 0) {
+                FREE(linebuf);
+                pixDestroy(&pixb);
+                pixDestroy(&pixd);
+                return (PIX *)ERROR_PTR("line read fail", procName, NULL);
+            }
+            memcpy((char *)data, (char *)linebuf, tiffbpl);
+            data += bpl;
+        }
+        if (bps <= 8)
+            pixEndianByteSwap(pixb);
+        else   /* bps == 16 */
+            pixEndianTwoByteSwap(pixb);
+        if (invert)
+            pixInvert(pixb, pixb);
+        pixt = pixScaleByIntReduction(pixb, reduction);
+        pixRasterop(pixd, 0, k, wd, 1, PIX_SRC, pixt, 0, 0);
+        pixDestroy(&pixt);
+    }
+    FREE(linebuf);
+    pixDestroy(&pixb);
+
+    if (getTiffStreamResolution(tif, &xres, &yres) == 0) {
+        pixSetXRes(pixd, xres);
+        pixSetYRes(pixd, yres);
+        pixScaleResolution(pixd, 1.0 / reduction, 1.0 / reduction);
+    }
+    pixSetInputFormat(pixd, comptype);
+    return pixd;
+}
+
+
 /*--------------------------------------------------------------*
  *                       Writing to file                        *
  *--------------------------------------------------------------*/
@@ -893,11 +1099,90 @@ l_uint32   uval, uval2;
 /*--------------------------------------------------------------*
  *               Reading and writing multipage tiff             *
  *--------------------------------------------------------------*/
+/*
+ *  pixReadFromMultipageTiff()
+ *
+ *      Input:  filename (input tiff file)
+ *              &offset (<return> set offset to 0 for first image)
+ *      Return: pix, or null on error or if previous call returned the
+ *              last image
+ *
+ *  Notes:
+ *      (1) This allows overhead for traversal of a multipage tiff file
+ *          to be linear in the number of images.  This will also work
+ *          with a singlepage tiff file.
+ *      (2) No TIFF internal data structures are exposed to the caller.
+ *      (3) Use: offset = 0;
+ *               do {
+ *                   pix = pixReadFromMultipageTiff(filename, &offset);
+ *                   ... [process pix]
+ *                   pixDestroy(&pix);
+ *               } while (offset != 0);
+ *      (4) The offset is the location of the next directory (IFD) in
+ *          the file.  When the last image has been read, the returned
+ *          offset is 0.
+ *      (5) Each call opens and closes the file.  Opening reads the
+ *          header and the first directory; the requested directory is
+ *          then read directly at @offset, so the directories of the
+ *          pages in between are not parsed.  The cost of each call
+ *          therefore does not depend on the page number, but it
+ *          includes this fixed open overhead.  To read all the pages
+ *          of a file, pixaReadMultipageTiff() is faster, because it
+ *          keeps a single handle open.
+ */
+PIX *
+pixReadFromMultipageTiff(const char  *filename,
+                         size_t      *poffset)
+{
+l_int32  retval;
+PIX     *pix;
+TIFF    *tif;
+
+    PROCNAME("pixReadFromMultipageTiff");
+
+    if (!filename)
+        return (PIX *)ERROR_PTR("filename not defined", procName, NULL);
+    if (!poffset)
+        return (PIX *)ERROR_PTR("&offset not defined", procName, NULL);
+
+    if ((tif = openTiff(filename, "r")) == NULL) {
+        L_ERROR_STRING("tif open failed for %s", procName, filename);
+        return NULL;
+    }
+
+        /* Set ptrs in the TIFF to the beginning of the image */
+    retval = (*poffset == 0) ? TIFFSetDirectory(tif, 0)
+                             : TIFFSetSubDirectory(tif, *poffset);
+    if (retval == 0) {
+        TIFFClose(tif);
+        return NULL;
+    }
+
+    if ((pix = pixReadFromTiffStream(tif)) == NULL) {
+        TIFFClose(tif);
+        return NULL;
+    }
+
+        /* Advance to the next image and return the new offset */
+    if (TIFFReadDirectory(tif))
+        *poffset = TIFFCurrentDirOffset(tif);
+    else
+        *poffset = 0;
+    TIFFClose(tif);
+    return pix;
+}
+
+
 /*
  *  pixaReadMultipageTiff()
  *
  *      Input:  filename (input tiff file)
  *      Return: pixa (of page images), or null on error
+ *
+ *  Notes:
+ *      (1) The file is opened once, and the pages are read in order,
+ *          advancing from each directory to the next.  The time is
+ *          linear in the number of pages.
  */
 PIXA *
 pixaReadMultipageTiff(const char  *filename)
@@ -906,6 +1191,7 @@ l_int32  i, npages;
 FILE    *fp;
 PIX     *pix;
 PIXA    *pixa;
+TIFF    *tif;
 
     PROCNAME("pixaReadMultipageTiff");
 
@@ -914,24 +1200,32 @@ PIXA    *pixa;
 
     if ((fp = fopenReadStream(filename)) == NULL)
         return (PIXA *)ERROR_PTR("stream not opened", procName, NULL);
-    if (fileFormatIsTiff(fp)) {
-        tiffGetCount(fp, &npages);
-        L_INFO_INT(" Tiff: %d pages\n", procName, npages);
-    }
-    else
+    if (!fileFormatIsTiff(fp)) {
+        fclose(fp);
         return (PIXA *)ERROR_PTR("file not tiff", procName, NULL);
-    fclose(fp);
+    }
+    if ((tif = fopenTiff(fp, "rb")) == NULL) {
+        fclose(fp);
+        return (PIXA *)ERROR_PTR("tif not opened", procName, NULL);
+    }
 
-    pixa = pixaCreate(npages);
-    for (i = 0; i < npages; i++) {
-        pix = pixReadTiff(filename, i);
-        if (!pix) {
+    pixa = pixaCreate(0);
+    for (i = 0; i < MAX_PAGES_IN_TIFF_FILE; i++) {
+        if ((pix = pixReadFromTiffStream(tif)) != NULL)
+            pixaAddPix(pixa, pix, L_INSERT);
+        else
             L_WARNING_INT("pix not read for page %d", procName, i);
-            continue;
-        }
-        pixaAddPix(pixa, pix, L_INSERT);
+        if (TIFFReadDirectory(tif) == 0)
+            break;
     }
+    if (i == MAX_PAGES_IN_TIFF_FILE)
+        L_WARNING_INT("only the first %d pages were read", procName,
+                      MAX_PAGES_IN_TIFF_FILE);
+    npages = L_MIN(i + 1, MAX_PAGES_IN_TIFF_FILE);
+    L_INFO_INT(" Tiff: %d pages\n", procName, npages);
 
+    TIFFCleanup(tif);
+    fclose(fp);
     return pixa;
 }
 
@@ -1552,14 +1846,10 @@ extractG4DataFromFile(const char  *filein,
                       l_int32     *ph,
                       l_int32     *pminisblack)
 {
-l_uint8  *inarray, *data;
-l_uint16  minisblack, comptype;  /* accessors require l_uint16 */
-l_int32   istiff;
-l_uint32  w, h, rowsperstrip;  /* accessors require l_uint32 */
-l_uint32  diroff;
-size_t    fbytes, nbytes;
+l_uint8  *inarray;
+l_int32   istiff, ret;
+size_t    fbytes;
 FILE     *fpin;
-TIFF     *tif;
 
     PROCNAME("extractG4DataFromFile");
 
@@ -1581,15 +1871,69 @@ TIFF     *tif;
 
     if ((inarray = l_binaryRead(filein, &fbytes)) == NULL)
         return ERROR_INT("inarray not made", procName, 1);
+    ret = extractG4DataFromArray(inarray, fbytes, pdata, pnbytes,
+                                 pw, ph, pminisblack);
+    FREE(inarray);
+    return ret;
+}
+
+
+/*!
+ *  extractG4DataFromArray()
+ *
+ *      Input:  cdata (const; entire tiff g4 file in memory)
+ *              size (of cdata)
+ *              &data (<return> binary data of ccitt g4 encoded stream)
+ *              &nbytes (<return> size of binary data)
+ *              &w (<return optional> image width)
+ *              &h (<return optional> image height)
+ *              &minisblack (<return optional> boolean)
+ *      Return: 0 if OK, 1 on error
+ *
+ *  Notes:
+ *      (1) This is the in-memory version of extractG4DataFromFile().
+ *          It can be used directly on the output of pixWriteMemTiff().
+ *      (2) Use TIFFClose(); TIFFCleanup() doesn't free internal memstream.
+ */
+l_int32
+extractG4DataFromArray(const l_uint8  *cdata,
+                       size_t          size,
+                       l_uint8       **pdata,
+                       size_t         *pnbytes,
+                       l_int32        *pw,
+                       l_int32        *ph,
+                       l_int32        *pminisblack)
+{
+l_uint8  *inarray, *data;
+l_uint16  minisblack, comptype;  /* accessors require l_uint16 */
+l_uint32  w, h, rowsperstrip;  /* accessors require l_uint32 */
+l_uint32  diroff;
+size_t    nbytes;
+TIFF     *tif;
+
+    PROCNAME("extractG4DataFromArray");
+
+    if (!pdata)
+        return ERROR_INT("&data not defined", procName, 1);
+    if (!pnbytes)
+        return ERROR_INT("&nbytes not defined", procName, 1);
+    if (!pw && !ph && !pminisblack)
+        return ERROR_INT("no output data requested", procName, 1);
+    *pdata = NULL;
+    *pnbytes = 0;
+    if (!cdata)
+        return ERROR_INT("cdata not defined", procName, 1);
+    if (size < 8)
+        return ERROR_INT("size too small for tiff", procName, 1);
 
         /* Get metadata about the image */
-    if ((tif = openTiff(filein, "rb")) == NULL)
+    inarray = (l_uint8 *)cdata;  /* we're really not going to change this */
+    if ((tif = fopenTiffMemstream("tifferror", "r", &inarray, &size)) == NULL)
         return ERROR_INT("tif not open for read", procName, 1);
     TIFFGetField(tif, TIFFTAG_COMPRESSION, &comptype);
     if (comptype != COMPRESSION_CCITTFAX4) {
-        FREE(inarray);
         TIFFClose(tif);
-        return ERROR_INT("filein is not g4 compressed", procName, 1);
+        return ERROR_INT("data is not g4 compressed", procName, 1);
     }
 
     TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
@@ -1617,20 +1961,18 @@ TIFF     *tif;
                  (inarray[5] << 8) | inarray[4];
     }
 /*    fprintf(stderr, " diroff = %d, %x\n", diroff, diroff); */
+    if (diroff < 8 || diroff > size)
+        return ERROR_INT("invalid directory offset", procName, 1);
 
         /* Extract the ccittg4 encoded data from the tiff file.
          * We skip the 8 byte header and take nbytes of data,
          * up to the beginning of the directory (at diroff)  */
     nbytes = diroff - 8;
-    *pnbytes = nbytes;
-    if ((data = (l_uint8 *)CALLOC(nbytes, sizeof(l_uint8))) == NULL) {
-        FREE(inarray);
+    if ((data = (l_uint8 *)CALLOC(nbytes, sizeof(l_uint8))) == NULL)
         return ERROR_INT("data not allocated", procName, 1);
-    }
-    *pdata = data;
     memcpy(data, inarray + 8, nbytes);
-    FREE(inarray);
-
+    *pdata = data;
+    *pnbytes = nbytes;
     return 0;
 }
 
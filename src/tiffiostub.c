@@ -39,6 +39,11 @@ PIX * pixReadStreamTiff(FILE *fp, l_int32 n)
     return (PIX * )ERROR_PTR("function not present", "pixReadStreamTiff", NULL);
 }
 
+PIX * pixReadStreamTiffReduced(FILE *fp, l_int32 n, l_int32 reduction)
+{
+    return (PIX * )ERROR_PTR("function not present", "pixReadStreamTiffReduced", NULL);
+}
+
 l_int32 pixWriteTiff(const char *filename, PIX *pix, l_int32 comptype,
                      const char *modestring)
 {
@@ -57,6 +62,12 @@ l_int32 pixWriteStreamTiff(FILE *fp, PIX *pix, l_int32 comptype)
     return ERROR_INT("function not present", "pixWriteStreamTiff", 1);
 }
 
+PIX * pixReadFromMultipageTiff(const char *filename, size_t *poffset)
+{
+    return (PIX * )ERROR_PTR("function not present",
+                             "pixReadFromMultipageTiff", NULL);
+}
+
 PIXA * pixaReadMultipageTiff(const char *filename)
 {
     return (PIXA * )ERROR_PTR("function not present",
@@ -123,6 +134,14 @@ l_int32 extractG4DataFromFile(const char *filein, l_uint8 **pdata,
     return ERROR_INT("function not present", "extractG4DataFromFile", 1);
 }
 
+l_int32 extractG4DataFromArray(const l_uint8 *cdata, size_t size,
+                               l_uint8 **pdata, size_t *pnbytes,
+                               l_int32 *pw, l_int32 *ph,
+                               l_int32 *pminisblack)
+{
+    return ERROR_INT("function not present", "extractG4DataFromArray", 1);
+}
+
 PIX * pixReadMemTiff(const l_uint8 *cdata, size_t size, l_int32 n)
 {
     return (PIX *)ERROR_PTR("function not present", "pixReadMemTiff", NULL);
@@ -63,6 +63,8 @@
  *       Read and write between file and memory
  *           l_uint8   *l_binaryRead()
  *           l_uint8   *l_binaryReadStream()
+ *           l_uint8   *l_binaryMapFile()
+ *           l_int32    l_binaryUnmapFile()
  *           l_int32    l_binaryWrite()
  *           l_int32    nbytesInFile()
  *           l_int32    fnbytesInFile()
@@ -158,6 +160,7 @@ static const char sepchar = '\\';
 #else
 #include <sys/stat.h>  /* for mkdir(2) */
 #include <sys/types.h>
+#include <sys/mman.h>  /* for mmap(2) */
 static const char sepchar = '/';
 #endif
 
@@ -1588,6 +1591,87 @@ l_uint8  *data;
 }
 
 
+/*!
+ *  l_binaryMapFile()
+ *
+ *      Input:  filename
+ *              &nbytes (<return> number of bytes in the file)
+ *      Return: read-only data, or null on error
+ *
+ *  Notes:
+ *      (1) This maps the file into memory, so that the data can be
+ *          decoded in place without first being copied into a buffer.
+ *          The data must be treated as read-only, and must be released
+ *          with l_binaryUnmapFile(), not FREE().
+ *      (2) On windows, the file is read into memory with l_binaryRead().
+ *      (3) An empty file cannot be mapped; it is returned as an error.
+ */
+l_uint8 *
+l_binaryMapFile(const char  *filename,
+                size_t      *pnbytes)
+{
+l_uint8  *data;
+size_t    nbytes;
+FILE     *fp;
+
+    PROCNAME("l_binaryMapFile");
+
+    if (!pnbytes)
+        return (l_uint8 *)ERROR_PTR("&nbytes not defined", procName, NULL);
+    *pnbytes = 0;
+    if (!filename)
+        return (l_uint8 *)ERROR_PTR("filename not defined", procName, NULL);
+
+    if ((fp = fopenReadStream(filename)) == NULL)
+        return (l_uint8 *)ERROR_PTR("file stream not opened", procName, NULL);
+    if ((nbytes = fnbytesInFile(fp)) == 0) {
+        fclose(fp);
+        return (l_uint8 *)ERROR_PTR("file is empty", procName, NULL);
+    }
+
+#ifdef _WIN32
+    data = l_binaryReadStream(fp, &nbytes);
+#else
+    data = (l_uint8 *)mmap(NULL, nbytes, PROT_READ, MAP_PRIVATE,
+                           fileno(fp), 0);
+    if (data == (l_uint8 *)MAP_FAILED)
+        data = NULL;
+#endif  /* _WIN32 */
+    fclose(fp);  /* the mapping is retained */
+
+    if (!data)
+        return (l_uint8 *)ERROR_PTR("data not mapped", procName, NULL);
+    *pnbytes = nbytes;
+    return data;
+}
+
+
+/*!
+ *  l_binaryUnmapFile()
+ *
+ *      Input:  data (returned by l_binaryMapFile())
+ *              nbytes (size of data)
+ *      Return: 0 if OK; 1 on error
+ */
+l_int32
+l_binaryUnmapFile(l_uint8  *data,
+                  size_t    nbytes)
+{
+    PROCNAME("l_binaryUnmapFile");
+
+    if (!data)
+        return ERROR_INT("data not defined", procName, 1);
+
+#ifdef _WIN32
+    FREE(data);
+#else
+    if (munmap(data, nbytes))
+        return ERROR_INT("data not unmapped", procName, 1);
+#endif  /* _WIN32 */
+    return 0;
+}
+
+
 /*!
  *  l_binaryWrite()
  *